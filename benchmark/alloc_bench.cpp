@@ -0,0 +1,244 @@
+#include "allocation_counter.hpp"
+
+#include "logency/core/exception.hpp"
+#include "logency/detail/message_pack.hpp"
+#include "logency/manager.hpp"
+#include "logency/message/log_level.hpp"
+#include "logency/sink_module/null_module.hpp"
+
+#include <cstddef>
+
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Message which does not allocate by itself. The content fits in the small
+ * string buffer.
+ */
+struct bench_message
+{
+    using value_type = char;
+    using string_type = std::string;
+    using string_view_type = std::string_view;
+
+    explicit bench_message(logency::log_level level, string_view_type content)
+        : content{content}, level{level}
+    {
+    }
+
+    string_type content;
+    logency::log_level level;
+};
+
+using bench_manager = logency::manager<bench_message>;
+using bench_pack = logency::message_pack<bench_message>;
+
+namespace constant
+{
+
+constexpr const size_t default_thread_in_manager{1};
+constexpr const int default_push_thread_number{4};
+constexpr const int default_message_per_thread{62500};
+
+} // namespace constant
+
+struct input_argument;
+
+static void benchmark_pack(input_argument input);
+static void benchmark_pipeline(input_argument input);
+
+template <typename Factory>
+static auto count_pack_allocations(input_argument input, Factory factory)
+    -> std::size_t;
+
+static void help(char *name);
+
+static void info(input_argument input);
+
+struct input_argument
+{
+    int thread_count{constant::default_push_thread_number};
+    int message_per_thread{constant::default_message_per_thread};
+    size_t thread_in_manager{constant::default_thread_in_manager};
+};
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        input_argument input;
+
+        if (argc == 4)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            input.thread_count = std::stoi(argv[1]);
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            input.message_per_thread = std::stoi(argv[2]);
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            input.thread_in_manager = static_cast<size_t>(std::stoull(argv[3]));
+        }
+        else if (argc != 1)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            help(argv[0]);
+            return 1;
+        }
+
+        info(input);
+
+        benchmark_pack(input);
+        benchmark_pipeline(input);
+    }
+    catch (const logency::runtime_error &e)
+    {
+        std::cerr << "Error occur: " << e.what();
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Allocate the packs on this thread and free them on another one, the same
+ * way the logger and the sink do.
+ */
+template <typename Factory>
+static auto count_pack_allocations(input_argument input, Factory factory)
+    -> std::size_t
+{
+    const auto count{static_cast<std::size_t>(input.message_per_thread)};
+
+    std::vector<bench_pack> tray;
+    tray.reserve(count);
+
+    auto round{[&]()
+               {
+                   for (std::size_t number{0U}; number < count; ++number)
+                   {
+                       tray.push_back(factory());
+                   }
+
+                   std::async(std::launch::async, [&]() { tray.clear(); })
+                       .get();
+               }};
+
+    round(); // Warm up.
+
+    const auto before{allocation_counter.load(std::memory_order_relaxed)};
+
+    round();
+
+    return allocation_counter.load(std::memory_order_relaxed) - before;
+}
+
+static void benchmark_pack(input_argument input)
+{
+    const std::string_view name{"pack"};
+
+    const auto shared{count_pack_allocations(
+        input,
+        [&]()
+        {
+            return std::make_shared<logency::message_pack_base<bench_message>>(
+                0U, name, bench_message{logency::log_level::info, "message"});
+        })};
+
+    const auto pooled{count_pack_allocations(
+        input,
+        [&]()
+        {
+            return logency::make_message_pack<bench_message>(
+                0U, name, bench_message{logency::log_level::info, "message"});
+        })};
+
+    std::cout << "[Message pack] \tPacks: " << input.message_per_thread << "\n"
+              << "std::make_shared \tAllocations: " << shared << "\n"
+              << "make_message_pack \tAllocations: " << pooled << "\n"
+              << std::endl;
+}
+
+static void benchmark_pipeline(input_argument input)
+{
+    bench_manager manager{input.thread_in_manager};
+
+    auto sink{manager.new_sink(
+        "null_sink",
+        std::make_unique<logency::sink_module::null_module<bench_message>>())};
+
+    auto logger{manager.new_logger("null_sink")};
+    logger->add_sink(sink);
+
+    auto round{[&]()
+               {
+                   std::vector<std::future<void>> futures;
+                   futures.reserve(
+                       static_cast<std::size_t>(input.thread_count));
+
+                   for (int id{0}; id < input.thread_count; ++id)
+                   {
+                       futures.push_back(std::async(
+                           std::launch::async,
+                           [&]()
+                           {
+                               for (int number{0};
+                                    number < input.message_per_thread; ++number)
+                               {
+                                   logger->log(logency::log_level::info,
+                                               "message");
+                               }
+                           }));
+                   }
+
+                   for (auto &future : futures)
+                   {
+                       future.wait();
+                   }
+
+                   manager.wait_until_idle();
+               }};
+
+    round(); // Warm up.
+
+    const auto before{allocation_counter.load(std::memory_order_relaxed)};
+
+    round();
+
+    const auto allocations{allocation_counter.load(std::memory_order_relaxed) -
+                           before};
+    const auto total_count{input.thread_count * input.message_per_thread};
+
+    std::cout << "[Logging pipeline] \tMessages: " << total_count << "\n"
+              << "Allocations: " << allocations
+              << " \tAllocations per message: "
+              << (static_cast<double>(allocations) / total_count) << "\n"
+              << std::endl;
+}
+
+static void help(char *name)
+{
+    std::cout
+        << "Error: incorrect argument\n"
+        << "usage: " << name
+        << " [thread_count] [message_per_thread] [thread_in_manager]\n"
+        << "\tthread_count (int): how many thread should this benchmark run.\n"
+        << "\tmessage_per_thread (int): how many message should this benchmark "
+           "send for each thread.\n"
+        << "\tthread_in_manager (size_t): how many thread is operating "
+           "inside the manager.";
+}
+
+static void info(input_argument input)
+{
+    const auto total_count{input.thread_count * input.message_per_thread};
+    std::cout << "[Benchmark Info]\n"
+              << "Input Thread: " << input.thread_count << "\n"
+              << "MessageType per thread: " << input.message_per_thread << "\n"
+              << "Total messages: " << total_count << "\n"
+              << "Threads in manager: " << input.thread_in_manager << std::endl;
+}
@@ -0,0 +1,196 @@
+#ifndef LOGENCY_BENCHMARK_ALLOCATION_COUNTER_HPP_
+#define LOGENCY_BENCHMARK_ALLOCATION_COUNTER_HPP_
+
+/**
+ * Replace the global allocation functions to count every allocation.
+ * Allocations of the standard library go through them as well.
+ *
+ * \note It defines the replacement functions, so include it in one translation
+ * unit of the benchmark only.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+
+#if defined(_WIN32)
+    #include <malloc.h>
+#endif
+
+/**
+ * Number of calls to any operator new.
+ */
+inline std::atomic<std::size_t> allocation_counter{0U};
+
+namespace logency::benchmark
+{
+
+inline auto counted_allocate(std::size_t size) noexcept -> void *
+{
+    allocation_counter.fetch_add(1U, std::memory_order_relaxed);
+
+    return std::malloc(size == 0U ? 1U : size);
+}
+
+inline auto counted_allocate(std::size_t size,
+                             std::align_val_t alignment) noexcept -> void *
+{
+    allocation_counter.fetch_add(1U, std::memory_order_relaxed);
+
+    const auto align{static_cast<std::size_t>(alignment)};
+
+#if defined(_WIN32)
+    return _aligned_malloc(size == 0U ? 1U : size, align);
+#else
+    // std::aligned_alloc needs the size to be a multiple of the alignment.
+    const auto rounded{((size == 0U ? 1U : size) + align - 1U) / align * align};
+
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+inline void counted_deallocate(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+inline void counted_deallocate(void *pointer,
+                               std::align_val_t /*alignment*/) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+inline auto checked(void *pointer) -> void *
+{
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return pointer;
+}
+
+} // namespace logency::benchmark
+
+// GCC cannot tell that the replaced operator new allocates with malloc.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size)
+{
+    return logency::benchmark::checked(
+        logency::benchmark::counted_allocate(size));
+}
+
+void *operator new[](std::size_t size)
+{
+    return logency::benchmark::checked(
+        logency::benchmark::counted_allocate(size));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+{
+    return logency::benchmark::counted_allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+{
+    return logency::benchmark::counted_allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return logency::benchmark::checked(
+        logency::benchmark::counted_allocate(size, alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return logency::benchmark::checked(
+        logency::benchmark::counted_allocate(size, alignment));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t & /*tag*/) noexcept
+{
+    return logency::benchmark::counted_allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t & /*tag*/) noexcept
+{
+    return logency::benchmark::counted_allocate(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::size_t /*size*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t /*size*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t & /*tag*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t & /*tag*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+void operator delete(void *pointer, std::size_t /*size*/,
+                     std::align_val_t alignment) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+void operator delete[](void *pointer, std::size_t /*size*/,
+                       std::align_val_t alignment) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment,
+                     const std::nothrow_t & /*tag*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment,
+                       const std::nothrow_t & /*tag*/) noexcept
+{
+    logency::benchmark::counted_deallocate(pointer, alignment);
+}
+
+#endif // LOGENCY_BENCHMARK_ALLOCATION_COUNTER_HPP_
@@ -1,9 +1,11 @@
 #include "logency/core/exception.hpp"
 #include "logency/manager.hpp"
+#include "logency/message/deferred_fmt_message.hpp"
 #include "logency/message/fmt_message.hpp"
 #include "logency/sink_module/basic_file_module.hpp"
 #include "logency/sink_module/null_module.hpp"
 #include "logency/sink_module/rotation_file_module.hpp"
+#include "logency/sink_module/uring_file_module.hpp"
 
 #include <cstdint>
 #include <cstdio>
@@ -19,7 +21,10 @@
 using bench_message = logency::message::fmt_message;
 using bench_formatter = logency::message::fmt_message_formatter;
 
-using bench_manager = logency::manager<bench_message>;
+using deferred_bench_message = logency::message::deferred_fmt_message;
+using deferred_bench_formatter =
+    logency::message::deferred_fmt_message_formatter;
+
 using bench_clock = std::chrono::high_resolution_clock;
 
 namespace constant
@@ -36,9 +41,12 @@ struct input_argument;
 template <typename MessageType, typename FormatterType>
 static void benchmark(input_argument input);
 
+template <typename MessageType, typename FormatterType>
+static void benchmark_formatter(input_argument input);
+
 template <typename MessageType>
 static void
-benchmark_sink(input_argument input, bench_manager &manager,
+benchmark_sink(input_argument input, logency::manager<MessageType> &manager,
                const std::shared_ptr<logency::sink<MessageType>> &sink);
 
 static void help(char *name);
@@ -79,6 +87,7 @@ int main(int argc, char *argv[])
         info(input);
 
         benchmark<bench_message, bench_formatter>(input);
+        benchmark<deferred_bench_message, deferred_bench_formatter>(input);
     }
     catch (const logency::runtime_error &e)
     {
@@ -100,6 +109,8 @@ static void benchmark(input_argument input)
               << "MessageType formatter: " << typeid(formatter).name() << "\n"
               << "--------------------" << std::endl;
 
+    benchmark_formatter<message, formatter>(input);
+
     logency::manager<message> manager{input.thread_in_manager};
 
     {
@@ -115,6 +126,21 @@ static void benchmark(input_argument input)
 
         manager.delete_sink("basic_file_sink");
     }
+#if defined(__linux__)
+    {
+        // io_uring file sink
+        auto uring_file_sink{manager.new_sink(
+            "uring_file_sink",
+            std::make_unique<
+                logency::sink_module::uring_file_module<message, formatter>>(
+                "log/uring_file_sink.txt", logency::file_open_mode::truncate,
+                std::make_unique<formatter>()))};
+
+        benchmark_sink(input, manager, std::move(uring_file_sink));
+
+        manager.delete_sink("uring_file_sink");
+    }
+#endif
     {
         // rotate file sink
         const logency::sink_module::rotation_file::rotate_info rotate_info{
@@ -146,9 +172,47 @@ static void benchmark(input_argument input)
     }
 }
 
+/**
+ * Format the messages on one thread, the same way the sink module does.
+ */
+template <typename MessageType, typename FormatterType>
+static void benchmark_formatter(input_argument input)
+{
+    const auto total_count{input.thread_count * input.message_per_thread};
+    const FormatterType formatter{};
+
+    std::vector<MessageType> messages;
+    messages.reserve(static_cast<std::size_t>(total_count));
+
+    for (int number{0}; number < total_count; ++number)
+    {
+        messages.emplace_back(logency::log_level::info,
+                              "MessageType (id - number): {} - {}", 0, number);
+    }
+
+    std::size_t output_size{0U};
+
+    auto start{bench_clock::now()};
+
+    for (const auto &message : messages)
+    {
+        output_size += formatter("formatter", message).size();
+    }
+
+    auto finish_time{std::chrono::duration_cast<std::chrono::duration<double>>(
+                         bench_clock::now() - start)
+                         .count()};
+
+    std::cout << "Name: formatter\n"
+              << "[Format finish] \tElapsed: " << finish_time
+              << "sec \tMessage per sec: " << (total_count / finish_time)
+              << " \tBytes: " << output_size << "\n"
+              << std::endl;
+}
+
 template <typename MessageType>
 static void
-benchmark_sink(input_argument input, bench_manager &manager,
+benchmark_sink(input_argument input, logency::manager<MessageType> &manager,
                const std::shared_ptr<logency::sink<MessageType>> &sink)
 {
     const std::string &name{sink->name()};
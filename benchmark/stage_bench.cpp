@@ -0,0 +1,606 @@
+#include "allocation_counter.hpp"
+
+#include "logency/core/exception.hpp"
+#include "logency/detail/message_pack.hpp"
+#include "logency/detail/thread/blocking_queue.hpp"
+#include "logency/detail/thread/thread_pool.hpp"
+#include "logency/dispatcher.hpp"
+#include "logency/logger.hpp"
+#include "logency/message/log_level.hpp"
+#include "logency/message/stream_message.hpp"
+#include "logency/sink.hpp"
+#include "logency/sink_module/basic_file_module.hpp"
+#include "logency/sink_module/module_interface.hpp"
+#include "logency/sink_module/null_module.hpp"
+#include "logency/sink_module/ostream_module.hpp"
+
+#include <cstddef>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using bench_message = logency::message::stream_message<char>;
+using bench_stringifier = logency::message::stream_stringifier<char>;
+using bench_formatter = logency::message::stream_message_formatter<char>;
+using bench_color_formatter =
+    logency::message::stream_color_message_formatter<char>;
+
+using bench_pack = logency::message_pack<bench_message>;
+using bench_queue = logency::detail::thread::blocking_queue<bench_pack>;
+using bench_clock = std::chrono::high_resolution_clock;
+
+namespace constant
+{
+
+constexpr const std::size_t default_operation_count{100000U};
+
+/**
+ * Loggers the dispatcher stage interleaves, and the messages each of them
+ * logs in a row, so the dispatcher has groups to split.
+ */
+constexpr const std::size_t dispatcher_logger_count{4U};
+constexpr const std::size_t dispatcher_run_length{16U};
+
+/**
+ * Messages enqueued before each swap of the try_swap_bulk stage.
+ */
+constexpr const std::size_t swap_batch_size{64U};
+
+constexpr const char *file_name{"stage_bench.log"};
+
+} // namespace constant
+
+struct input_argument;
+struct stage_result;
+
+template <typename Prepare, typename Operate>
+static auto measure(std::string_view name, std::size_t operations,
+                    Prepare prepare, Operate operate) -> stage_result;
+
+static void benchmark_message(input_argument input,
+                              std::vector<stage_result> &results);
+static void benchmark_queue(input_argument input,
+                            std::vector<stage_result> &results);
+static void benchmark_dispatcher(input_argument input,
+                                 std::vector<stage_result> &results);
+static void benchmark_stringifier(input_argument input,
+                                  std::vector<stage_result> &results);
+static void benchmark_sink_module(input_argument input,
+                                  std::vector<stage_result> &results);
+
+static void print(const stage_result &result);
+static void write_json(const std::string &name, input_argument input,
+                       const std::vector<stage_result> &results);
+static void write_csv(const std::string &name,
+                      const std::vector<stage_result> &results);
+
+static void help(char *name);
+
+static void info(input_argument input);
+
+struct input_argument
+{
+    std::size_t operation_count{constant::default_operation_count};
+    std::string json_file{};
+    std::string csv_file{};
+};
+
+/**
+ * \brief The timed round of one stage.
+ */
+struct stage_result
+{
+    std::string_view name;
+    std::size_t operations;
+    double nanoseconds;
+    std::size_t allocations;
+
+    [[nodiscard]] auto nanoseconds_per_operation() const -> double
+    {
+        return nanoseconds / static_cast<double>(operations);
+    }
+
+    [[nodiscard]] auto operations_per_second() const -> double
+    {
+        return (nanoseconds > 0.0)
+                   ? (static_cast<double>(operations) * 1e9 / nanoseconds)
+                   : 0.0;
+    }
+
+    [[nodiscard]] auto allocations_per_operation() const -> double
+    {
+        return static_cast<double>(allocations) /
+               static_cast<double>(operations);
+    }
+};
+
+/**
+ * \brief The stream buffer which drops everything, so the ostream module
+ * stage measures the module instead of the device.
+ */
+class discard_buffer : public std::streambuf
+{
+protected:
+    auto overflow(int_type value) -> int_type override
+    {
+        return traits_type::not_eof(value);
+    }
+
+    auto xsputn(const char_type * /*data*/, std::streamsize count)
+        -> std::streamsize override
+    {
+        return count;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        input_argument input;
+
+        if (argc > 4)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            help(argv[0]);
+            return 1;
+        }
+
+        if (argc >= 2)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const std::string count_text{argv[1]};
+
+            try
+            {
+                input.operation_count =
+                    static_cast<size_t>(std::stoull(count_text));
+            }
+            catch (const std::logic_error &)
+            {
+                // "--help" and other non-numbers; zero prints the help below.
+                input.operation_count = 0U;
+            }
+        }
+
+        if (argc >= 3)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            input.json_file = argv[2];
+        }
+
+        if (argc == 4)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            input.csv_file = argv[3];
+        }
+
+        if (input.operation_count == 0U)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            help(argv[0]);
+            return 1;
+        }
+
+        info(input);
+
+        std::vector<stage_result> results;
+
+        benchmark_message(input, results);
+        benchmark_queue(input, results);
+        benchmark_dispatcher(input, results);
+        benchmark_stringifier(input, results);
+        benchmark_sink_module(input, results);
+
+        if (!input.json_file.empty())
+        {
+            write_json(input.json_file, input, results);
+        }
+
+        if (!input.csv_file.empty())
+        {
+            write_csv(input.csv_file, results);
+        }
+    }
+    catch (const logency::runtime_error &e)
+    {
+        std::cerr << "Error occur: " << e.what();
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Run \a prepare and \a operate once to warm up, then run them again and time
+ * \a operate only. \a prepare resets the state left by the previous round.
+ */
+template <typename Prepare, typename Operate>
+static auto measure(std::string_view name, std::size_t operations,
+                    Prepare prepare, Operate operate) -> stage_result
+{
+    prepare();
+    operate(); // Warm up.
+
+    prepare();
+
+    const auto allocations{allocation_counter.load(std::memory_order_relaxed)};
+    const auto start{bench_clock::now()};
+
+    operate();
+
+    const auto end{bench_clock::now()};
+
+    stage_result result{
+        name, operations,
+        std::chrono::duration<double, std::nano>(end - start).count(),
+        allocation_counter.load(std::memory_order_relaxed) - allocations};
+
+    print(result);
+
+    return result;
+}
+
+static void benchmark_message(input_argument input,
+                              std::vector<stage_result> &results)
+{
+    const std::string_view name{"stage"};
+    const auto count{input.operation_count};
+
+    std::vector<bench_message> messages;
+    messages.reserve(count);
+
+    results.push_back(measure(
+        "stream_message construction", count, [&]() { messages.clear(); },
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                messages.emplace_back(logency::log_level::info, "message ",
+                                      number);
+            }
+        }));
+
+    const bench_message message{logency::log_level::info, "message"};
+
+    std::vector<bench_pack> packs;
+    packs.reserve(count);
+
+    results.push_back(measure(
+        "make_message_pack", count, [&]() { packs.clear(); },
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                packs.push_back(logency::make_message_pack<bench_message>(
+                    0U, name, bench_message{message}));
+            }
+        }));
+}
+
+static void benchmark_queue(input_argument input,
+                            std::vector<stage_result> &results)
+{
+    const auto count{input.operation_count};
+
+    const auto pack{logency::make_message_pack<bench_message>(
+        0U, "stage", bench_message{logency::log_level::info, "message"})};
+
+    bench_queue queue{count};
+    bench_queue::container_type<bench_pack> tray;
+    tray.reserve(count);
+
+    auto drain{[&]()
+               {
+                   tray.clear();
+
+                   if (!queue.is_empty() && !queue.try_swap_bulk(tray))
+                   {
+                       throw logency::runtime_error("Fail to drain the queue.");
+                   }
+
+                   tray.clear();
+               }};
+
+    auto fill{[&]()
+              {
+                  for (std::size_t number{0U}; number < count; ++number)
+                  {
+                      // It tells whether to notify the consumer. None here.
+                      static_cast<void>(queue.enqueue(pack));
+                  }
+              }};
+
+    results.push_back(measure("blocking_queue::enqueue", count, drain, fill));
+
+    // One swap is O(1) and too short to time alone, so time the cycles which
+    // enqueue a batch and swap it out, the way a sink drains its queue.
+    const auto cycles{std::max<std::size_t>(count / constant::swap_batch_size,
+                                            1U)};
+
+    results.push_back(measure(
+        "blocking_queue::enqueue batch + try_swap_bulk", cycles, drain,
+        [&]()
+        {
+            for (std::size_t cycle{0U}; cycle < cycles; ++cycle)
+            {
+                for (std::size_t number{0U}; number < constant::swap_batch_size;
+                     ++number)
+                {
+                    static_cast<void>(queue.enqueue(pack));
+                }
+
+                if (!queue.try_swap_bulk(tray))
+                {
+                    throw logency::runtime_error("Fail to swap the queue.");
+                }
+
+                tray.clear();
+            }
+        }));
+}
+
+static void benchmark_dispatcher(input_argument input,
+                                 std::vector<stage_result> &results)
+{
+    using logger_type = logency::logger<bench_message>;
+    using sink_type = logency::sink<bench_message>;
+    using dispatcher_type = logency::dispatcher<bench_message>;
+    using thread_pool_type = logency::detail::thread::thread_pool;
+
+    const auto count{input.operation_count};
+
+    auto thread_pool{std::make_shared<thread_pool_type>(1U)};
+    auto dispatcher{std::make_shared<dispatcher_type>(thread_pool)};
+    auto sink{std::make_shared<sink_type>(
+        "null_sink",
+        std::make_unique<logency::sink_module::null_module<bench_message>>(),
+        thread_pool)};
+
+    std::vector<std::shared_ptr<logger_type>> loggers;
+    std::vector<bench_pack> packs;
+
+    for (std::size_t index{0U}; index < constant::dispatcher_logger_count;
+         ++index)
+    {
+        auto logger{std::make_shared<logger_type>(
+            "logger_" + std::to_string(index), dispatcher)};
+        logger->add_sink(sink);
+
+        packs.push_back(logency::make_message_pack<bench_message>(
+            logger->id(), "stage",
+            bench_message{logency::log_level::info, "message"}));
+        loggers.push_back(std::move(logger));
+    }
+
+    results.push_back(measure(
+        "dispatcher", count, [&]() { thread_pool->wait_until_queue_empty(); },
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                const auto index{(number / constant::dispatcher_run_length) %
+                                 loggers.size()};
+
+                auto logger{loggers[index]};
+                auto pack{packs[index]};
+                dispatcher->enqueue(std::move(logger), std::move(pack));
+            }
+
+            thread_pool->wait_until_queue_empty();
+        }));
+}
+
+static void benchmark_stringifier(input_argument input,
+                                  std::vector<stage_result> &results)
+{
+    const std::string_view name{"stage"};
+    const auto count{input.operation_count};
+
+    const bench_message message{logency::log_level::info, "message"};
+
+    // Keep the output observable, so the formatting is not optimized away.
+    std::size_t output_size{0U};
+
+    results.push_back(measure(
+        "stream_stringifier::format", count, []() {},
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                output_size += bench_stringifier::format(name, message).size();
+            }
+        }));
+
+    bench_stringifier::buffer_type buffer;
+
+    results.push_back(measure(
+        "stream_stringifier::format_to", count, [&]() { buffer.clear(); },
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                buffer.clear();
+                bench_stringifier::format_to(buffer, name, message);
+                output_size += buffer.size();
+            }
+        }));
+
+    const bench_color_formatter color_formatter{};
+
+    results.push_back(measure(
+        "stream_color_message_formatter", count, []() {},
+        [&]()
+        {
+            for (std::size_t number{0U}; number < count; ++number)
+            {
+                output_size += color_formatter(name, message).size();
+            }
+        }));
+
+    if (output_size == 0U)
+    {
+        throw logency::runtime_error("Stringifier output is empty.");
+    }
+}
+
+static void benchmark_sink_module(input_argument input,
+                                  std::vector<stage_result> &results)
+{
+    using module_type = logency::sink_module::module_interface<bench_message>;
+    using null_module_type = logency::sink_module::null_module<bench_message>;
+    using ostream_module_type =
+        logency::sink_module::ostream_module<bench_message, bench_formatter>;
+    using file_module_type =
+        logency::sink_module::basic_file_module<bench_message,
+                                                bench_formatter>;
+
+    const std::string_view name{"stage"};
+    const auto count{input.operation_count};
+
+    const bench_message message{logency::log_level::info, "message"};
+
+    auto log_each{[&](module_type &module)
+                  {
+                      return [&, count]()
+                      {
+                          for (std::size_t number{0U}; number < count;
+                               ++number)
+                          {
+                              module.log_message(name, message);
+                          }
+                      };
+                  }};
+
+    null_module_type null_module{};
+
+    results.push_back(measure("null_module::log_message", count, []() {},
+                              log_each(null_module)));
+
+    discard_buffer discard{};
+    std::ostream stream{&discard};
+
+    ostream_module_type ostream_module{&stream,
+                                       std::make_unique<bench_formatter>()};
+
+    results.push_back(measure("ostream_module::log_message", count, []() {},
+                              log_each(ostream_module)));
+
+    const std::vector<bench_pack> packs(
+        count, logency::make_message_pack<bench_message>(
+                   0U, name, bench_message{message}));
+
+    results.push_back(measure(
+        "ostream_module::log_messages", count, []() {},
+        [&]()
+        { ostream_module.log_messages(packs.data(), packs.data() + count); }));
+
+    {
+        file_module_type file_module{constant::file_name,
+                                     file_module_type::file_open_mode::truncate,
+                                     std::make_unique<bench_formatter>()};
+
+        results.push_back(measure("basic_file_module::log_message", count,
+                                  [&]() { file_module.flush(); },
+                                  log_each(file_module)));
+    }
+
+    std::remove(constant::file_name);
+}
+
+static void print(const stage_result &result)
+{
+    std::cout << std::fixed << std::setprecision(2) << "[" << result.name
+              << "] \tns/op: " << result.nanoseconds_per_operation()
+              << " \tops/s: " << result.operations_per_second()
+              << " \tAllocations/op: " << result.allocations_per_operation()
+              << std::endl;
+}
+
+static void write_json(const std::string &name, input_argument input,
+                       const std::vector<stage_result> &results)
+{
+    std::ofstream file{name, std::ios_base::out | std::ios_base::trunc};
+
+    if (!file)
+    {
+        throw logency::runtime_error("Fail to open the JSON output file.");
+    }
+
+    file << std::fixed << std::setprecision(3) << "{\n"
+         << "  \"benchmark\": \"stage_bench\",\n"
+         << "  \"operation_count\": " << input.operation_count << ",\n"
+         << "  \"stages\": [\n";
+
+    for (std::size_t index{0U}; index < results.size(); ++index)
+    {
+        const auto &result{results[index]};
+
+        // Stage names are fixed literals without characters to escape.
+        file << "    {\"stage\": \"" << result.name << "\", "
+             << "\"operations\": " << result.operations << ", "
+             << "\"ns_per_op\": " << result.nanoseconds_per_operation() << ", "
+             << "\"ops_per_s\": " << result.operations_per_second() << ", "
+             << "\"allocations_per_op\": "
+             << result.allocations_per_operation() << "}"
+             << ((index + 1U < results.size()) ? ",\n" : "\n");
+    }
+
+    file << "  ]\n"
+         << "}\n";
+}
+
+static void write_csv(const std::string &name,
+                      const std::vector<stage_result> &results)
+{
+    std::ofstream file{name, std::ios_base::out | std::ios_base::trunc};
+
+    if (!file)
+    {
+        throw logency::runtime_error("Fail to open the CSV output file.");
+    }
+
+    file << std::fixed << std::setprecision(3)
+         << "stage,operations,ns_per_op,ops_per_s,allocations_per_op\n";
+
+    for (const auto &result : results)
+    {
+        file << result.name << "," << result.operations << ","
+             << result.nanoseconds_per_operation() << ","
+             << result.operations_per_second() << ","
+             << result.allocations_per_operation() << "\n";
+    }
+}
+
+static void help(char *name)
+{
+    std::cout
+        << "Error: incorrect argument\n"
+        << "usage: " << name << " [operation_count] [json_file] [csv_file]\n"
+        << "\toperation_count (size_t): how many operation should each stage "
+           "run. It should not be 0.\n"
+        << "\tjson_file (string): where to write the results as JSON.\n"
+        << "\tcsv_file (string): where to write the results as CSV.";
+}
+
+static void info(input_argument input)
+{
+    std::cout << "[Benchmark Info]\n"
+              << "Operations per stage: " << input.operation_count << "\n"
+              << "JSON output: "
+              << (input.json_file.empty() ? "none" : input.json_file) << "\n"
+              << "CSV output: "
+              << (input.csv_file.empty() ? "none" : input.csv_file) << "\n"
+              << std::endl;
+}
@@ -0,0 +1,20 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_CORE_OVERFLOW_POLICY_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_CORE_OVERFLOW_POLICY_HPP_
+
+namespace logency
+{
+
+/**
+ * \brief Represent what a bounded queue does when it is full.
+ */
+enum class overflow_policy
+{
+    block,        //!< Wait until the consumer frees the space.
+    drop_newest,  //!< Drop the incoming message.
+    drop_oldest,  //!< Drop the oldest message in the queue.
+    drop_by_level //!< Drop the incoming message below the kept level.
+};
+
+} // namespace logency
+
+#endif // LOGENCY_INCLUDE_LOGENCY_CORE_OVERFLOW_POLICY_HPP_
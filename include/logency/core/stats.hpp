@@ -0,0 +1,154 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_CORE_STATS_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_CORE_STATS_HPP_
+
+#include "logency/message/log_level.hpp"
+
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace logency
+{
+
+/**
+ * \brief Counters of a logger since it is created.
+ */
+struct logger_stats
+{
+    /**
+     * \brief Messages passed to the dispatcher, or to the sinks in
+     * synchronous mode.
+     */
+    std::uint64_t logged{0U};
+
+    /**
+     * \brief logged, indexed by log_level. All zero if the message type has
+     * no level.
+     */
+    std::array<std::uint64_t, log_string.size()> logged_by_level{};
+
+    /**
+     * \brief Messages rejected by the filter of the logger.
+     *
+     * Messages below the level of the logger are not counted, so that check
+     * stays free.
+     */
+    std::uint64_t filtered{0U};
+};
+
+/**
+ * \brief Counters of a sink since it is created.
+ */
+struct sink_stats
+{
+    std::uint64_t enqueued{0U}; //!< Messages passed the filter, dropped or not.
+    std::uint64_t written{0U};  //!< Messages written by the sink module.
+    std::uint64_t dropped{0U};  //!< Messages dropped by the overflow policy.
+
+    /**
+     * \brief Bytes written by the sink module. Zero if the module does not
+     * count it.
+     */
+    std::uint64_t bytes_written{0U};
+
+    std::uint64_t flush_count{0U}; //!< Flushes asked by the flusher.
+    std::uint64_t error_count{0U}; //!< Exceptions thrown by the sink module.
+
+    /**
+     * \brief Maximum message count the queue ever held.
+     */
+    std::uint64_t queue_high_water{0U};
+};
+
+/**
+ * \brief Counters of a dispatcher since it is created.
+ */
+struct dispatcher_stats
+{
+    std::uint64_t batch_count{0U};    //!< Batches taken from the queue.
+    std::uint64_t message_count{0U};  //!< Messages in those batches.
+    std::uint64_t max_batch_size{0U}; //!< Largest batch.
+    std::uint64_t dropped{0U}; //!< Messages dropped by the overflow policy.
+};
+
+/**
+ * \brief Counters of a thread pool since it is created.
+ */
+struct thread_pool_stats
+{
+    std::uint64_t executed{0U}; //!< Tasks run by the threads.
+    std::uint64_t stolen{0U};   //!< Tasks taken from another thread.
+    std::uint64_t queued{0U};   //!< Tasks waiting at the moment.
+};
+
+/**
+ * \brief Percentiles of the latencies recorded by a histogram.
+ *
+ * The percentiles are rounded up to the bucket, within about 3%.
+ */
+struct latency_stats
+{
+    std::uint64_t count{0U};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+    std::chrono::nanoseconds max{0};
+};
+
+/**
+ * \brief Latencies of the messages written by a sink, by pipeline stage.
+ *
+ * Only recorded if \c LOGENCY_LATENCY is defined.
+ */
+struct sink_latency_stats
+{
+    /**
+     * \brief From logger::log() to the dispatcher taking the message.
+     */
+    latency_stats dispatcher_queue{};
+
+    /**
+     * \brief From the dispatcher to the sink taking the message.
+     */
+    latency_stats sink_queue{};
+
+    /**
+     * \brief From the sink taking the message to the module writing its
+     * batch.
+     */
+    latency_stats write{};
+
+    /**
+     * \brief From logger::log() to the module writing the message.
+     */
+    latency_stats end_to_end{};
+};
+
+/**
+ * \brief Snapshot of the counters of a manager and everything it owns.
+ *
+ * Each counter is read on its own, so the counters are not consistent with
+ * each other while the messages are being logged.
+ *
+ * \tparam StringType String type of the names.
+ */
+template <typename StringType>
+struct manager_stats
+{
+    std::vector<std::pair<StringType, logger_stats>> loggers{};
+    std::vector<std::pair<StringType, sink_stats>> sinks{};
+    std::vector<dispatcher_stats> dispatchers{}; //!< One for each shard.
+
+    /**
+     * \brief The shared thread pool. The dedicated threads of the sinks are
+     * not included.
+     */
+    thread_pool_stats thread_pool{};
+};
+
+} // namespace logency
+
+#endif // LOGENCY_INCLUDE_LOGENCY_CORE_STATS_HPP_
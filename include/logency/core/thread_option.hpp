@@ -0,0 +1,52 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_CORE_THREAD_OPTION_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_CORE_THREAD_OPTION_HPP_
+
+#include <optional>
+#include <vector>
+
+namespace logency
+{
+
+/**
+ * \brief Represent the scheduling policy of a thread.
+ */
+enum class thread_scheduling
+{
+    inherit,    //!< Keep the policy of the creating thread.
+    normal,     //!< \c SCHED_OTHER.
+    batch,      //!< \c SCHED_BATCH.
+    idle,       //!< \c SCHED_IDLE.
+    fifo,       //!< \c SCHED_FIFO with thread_option::priority.
+    round_robin //!< \c SCHED_RR with thread_option::priority.
+};
+
+/**
+ * \brief Option of the threads created by the library.
+ *
+ * Only Linux supports them. Elsewhere, asking for anything but the default
+ * fails with \c std::errc::not_supported.
+ */
+struct thread_option
+{
+    /**
+     * \brief CPUs the thread is allowed to run on. Empty means any CPU.
+     */
+    std::vector<int> cpu_affinity{};
+
+    /**
+     * \brief Nice value of the thread. Empty means inherited.
+     */
+    std::optional<int> nice{};
+
+    thread_scheduling scheduling{thread_scheduling::inherit};
+
+    /**
+     * \brief Static priority for thread_scheduling::fifo and
+     * thread_scheduling::round_robin.
+     */
+    int priority{0};
+};
+
+} // namespace logency
+
+#endif // LOGENCY_INCLUDE_LOGENCY_CORE_THREAD_OPTION_HPP_
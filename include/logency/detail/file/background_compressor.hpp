@@ -0,0 +1,371 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_BACKGROUND_COMPRESSOR_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_BACKGROUND_COMPRESSOR_HPP_
+
+#include "logency/core/exception.hpp"
+
+#if defined(LOGENCY_ZSTD)
+    #include <zstd.h>
+#elif defined(LOGENCY_ZLIB)
+    #include <zlib.h>
+#endif
+
+#if defined(__linux__)
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <cstddef>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace logency::detail::file
+{
+
+/**
+ * \brief This class represent the compressor which compresses closed files on
+ * background threads.
+ *
+ * compress() only queues the file, so it never waits for the compression.
+ * At most \a job_count files are compressed at the same time. The threads run
+ * with the lowest CPU and I/O priority where it is supported (Linux).
+ *
+ * \par Library
+ * The file is compressed by zstd into `<name>.zst` if \c LOGENCY_ZSTD is
+ * defined, or by zlib into `<name>.gz` if \c LOGENCY_ZLIB is defined. The
+ * original file is removed after it is compressed. Without them, is_available
+ * is \c false and the files are kept as they are.
+ *
+ * \par Error
+ * If the compression fails, the original file is kept.
+ *
+ * \par Deletion
+ * A queued file can be deleted at any time, e.g. by the retention of the
+ * rotation. Then no compressed file is left for it.
+ */
+class background_compressor
+{
+public:
+    using path_type = std::filesystem::path;
+
+    static constexpr const std::size_t default_job_count{1U};
+
+#if defined(LOGENCY_ZSTD)
+    static constexpr const bool is_available{true};
+    static constexpr const char *extension{".zst"};
+#elif defined(LOGENCY_ZLIB)
+    static constexpr const bool is_available{true};
+    static constexpr const char *extension{".gz"};
+#else
+    static constexpr const bool is_available{false};
+    static constexpr const char *extension{""};
+#endif
+
+    /**
+     * \brief Initializes a new instance of the background_compressor class.
+     *
+     * \param job_count Maximum number of files compressed at the same time.
+     */
+    explicit background_compressor(std::size_t job_count = default_job_count);
+
+    /**
+     * \brief Finish the queued files and stop the threads.
+     */
+    ~background_compressor();
+
+    background_compressor(const background_compressor &other) = delete;
+    background_compressor(background_compressor &&other) noexcept = delete;
+    auto operator=(const background_compressor &other)
+        -> background_compressor & = delete;
+    auto operator=(background_compressor &&other) noexcept
+        -> background_compressor & = delete;
+
+    /**
+     * \brief Queue the file \a name to be compressed.
+     *
+     * The file should not be written anymore.
+     */
+    void compress(path_type name);
+
+    /**
+     * \brief Wait until all the queued files are done.
+     */
+    void wait_until_idle();
+
+    /**
+     * \brief Compress the file \a name on the current thread.
+     *
+     * \throw logency::system_error if it failed to read or write the file.
+     * \throw logency::runtime_error if it failed to compress.
+     */
+    static void compress_file(const path_type &name);
+
+private:
+    void work();
+
+    static void lower_priority() noexcept;
+
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+    std::condition_variable idle_condition_{};
+    std::deque<path_type> queue_{};
+    std::size_t working_count_{0U};
+    bool stopped_{false};
+
+    std::vector<std::thread> threads_{};
+};
+
+inline background_compressor::background_compressor(std::size_t job_count)
+{
+    if constexpr (!is_available)
+    {
+        return;
+    }
+
+    threads_.reserve(job_count);
+
+    for (std::size_t count{0U}; count < job_count; ++count)
+    {
+        threads_.emplace_back([this]() { work(); });
+    }
+}
+
+inline background_compressor::~background_compressor()
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        stopped_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto &thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+inline void background_compressor::compress(path_type name)
+{
+    if constexpr (!is_available)
+    {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        queue_.push_back(std::move(name));
+    }
+    condition_.notify_one();
+}
+
+inline void background_compressor::wait_until_idle()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    idle_condition_.wait(
+        lock, [this]() { return queue_.empty() && (working_count_ == 0U); });
+}
+
+inline void background_compressor::work()
+{
+    lower_priority();
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (true)
+    {
+        condition_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+
+        if (queue_.empty())
+        {
+            return; // Stopped, and nothing left.
+        }
+
+        auto name{std::move(queue_.front())};
+        queue_.pop_front();
+        ++working_count_;
+
+        lock.unlock();
+
+        try
+        {
+            compress_file(name);
+        }
+        catch (...)
+        {
+            // Keep the original file. There is no one to report to.
+        }
+
+        lock.lock();
+
+        if ((--working_count_ == 0U) && queue_.empty())
+        {
+            idle_condition_.notify_all();
+        }
+    }
+}
+
+inline void background_compressor::lower_priority() noexcept
+{
+#if defined(__linux__)
+    // Both of them apply to the calling thread only on Linux.
+    constexpr const int lowest_nice{19};
+    constexpr const int ioprio_who_process{1};
+    constexpr const int ioprio_class_idle{3};
+    constexpr const int ioprio_class_shift{13};
+
+    const auto thread_id{static_cast<::id_t>(::syscall(SYS_gettid))};
+
+    static_cast<void>(::setpriority(PRIO_PROCESS, thread_id, lowest_nice));
+    static_cast<void>(::syscall(SYS_ioprio_set, ioprio_who_process, 0,
+                                ioprio_class_idle << ioprio_class_shift));
+#endif
+}
+
+inline void background_compressor::compress_file(const path_type &name)
+{
+#if defined(LOGENCY_ZSTD) || defined(LOGENCY_ZLIB)
+    constexpr const std::size_t chunk_size{64U * 1024U};
+
+    std::ifstream input{name, std::ios_base::binary};
+    if (!input)
+    {
+        throw logency::system_error(
+            std::error_code{errno, std::generic_category()},
+            "Failed to open file"); // No period needed.
+    }
+
+    const auto target{path_type{name}.concat(extension)};
+    const auto temporary{path_type{target}.concat(".tmp")};
+
+    auto remove_temporary{[&temporary]()
+                          {
+                              std::error_code code;
+                              std::filesystem::remove(temporary, code);
+                          }};
+
+    try
+    {
+        std::vector<char> in_buffer(chunk_size);
+
+    #if defined(LOGENCY_ZSTD)
+        std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context{
+            ZSTD_createCCtx(), &ZSTD_freeCCtx};
+        if (!context)
+        {
+            throw logency::runtime_error("Failed to compress file.");
+        }
+
+        std::ofstream output{temporary, std::ios_base::binary};
+        std::vector<char> out_buffer(ZSTD_CStreamOutSize());
+
+        bool is_last{false};
+        while (!is_last)
+        {
+            input.read(in_buffer.data(),
+                       static_cast<std::streamsize>(in_buffer.size()));
+            const auto size{static_cast<std::size_t>(input.gcount())};
+
+            is_last = (size < in_buffer.size());
+            const auto mode{is_last ? ZSTD_e_end : ZSTD_e_continue};
+
+            ZSTD_inBuffer in{in_buffer.data(), size, 0U};
+            bool is_finished{false};
+
+            while (!is_finished)
+            {
+                ZSTD_outBuffer out{out_buffer.data(), out_buffer.size(), 0U};
+
+                const auto remaining{
+                    ZSTD_compressStream2(context.get(), &out, &in, mode)};
+                if (ZSTD_isError(remaining) != 0U)
+                {
+                    throw logency::runtime_error("Failed to compress file.");
+                }
+
+                output.write(out_buffer.data(),
+                             static_cast<std::streamsize>(out.pos));
+
+                is_finished = is_last ? (remaining == 0U)
+                                      : (in.pos == in.size);
+            }
+        }
+
+        output.close();
+        if (!output)
+        {
+            throw logency::system_error(
+                std::error_code{errno, std::generic_category()},
+                "Failed to write content"); // No period needed.
+        }
+    #else
+        auto *output{gzopen(temporary.string().c_str(), "wb")};
+        if (output == nullptr)
+        {
+            throw logency::system_error(
+                std::error_code{errno, std::generic_category()},
+                "Failed to open file"); // No period needed.
+        }
+
+        bool is_written{true};
+        do
+        {
+            input.read(in_buffer.data(),
+                       static_cast<std::streamsize>(in_buffer.size()));
+            const auto size{static_cast<unsigned>(input.gcount())};
+
+            is_written = (size == 0U) ||
+                         (gzwrite(output, in_buffer.data(), size) ==
+                          static_cast<int>(size));
+        } while (is_written && input);
+
+        if ((gzclose(output) != Z_OK) || !is_written)
+        {
+            throw logency::runtime_error("Failed to compress file.");
+        }
+    #endif
+
+        std::error_code code;
+        std::filesystem::rename(temporary, target, code);
+        if (code)
+        {
+            throw logency::system_error(code, "Failed to rename file");
+        }
+    }
+    catch (...)
+    {
+        remove_temporary();
+        throw;
+    }
+
+    input.close();
+
+    // The file might be deleted by the retention while it is compressed, and
+    // the retention has already looked for the compressed one. Do not leave
+    // it behind.
+    std::error_code code;
+    if (!std::filesystem::exists(name, code) && !code)
+    {
+        std::filesystem::remove(target, code);
+        return;
+    }
+
+    std::filesystem::remove(name, code);
+#else
+    static_cast<void>(name);
+#endif
+}
+
+} // namespace logency::detail::file
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_BACKGROUND_COMPRESSOR_HPP_
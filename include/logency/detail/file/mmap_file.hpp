@@ -0,0 +1,327 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_MMAP_FILE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_MMAP_FILE_HPP_
+
+#if !defined(_WIN32)
+
+    #include "logency/core/exception.hpp"
+    #include "logency/detail/file/basic_file.hpp"
+    #include "logency/detail/file/file_helper.hpp"
+
+    #include <cassert>
+    #include <cerrno>
+    #include <cstddef>
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+    #include <string>
+    #include <string_view>
+    #include <system_error>
+
+namespace logency::detail::file
+{
+
+/**
+ * \brief This class represent the file_object backed by a memory mapping.
+ *
+ * It has the same contract as basic_file. The file is grown by \a chunk_size
+ * bytes at a time with \c posix_fallocate, and mapped as a whole. write()
+ * copies the content into the mapping, so no system call is made until the
+ * mapping is full. flush() schedules the write back with \c msync(MS_ASYNC).
+ *
+ * \par Space
+ * The blocks of the file are allocated before it is mapped. Hence running out
+ * of space throws logency::system_error from write(), instead of raising
+ * \c SIGBUS while copying into the mapping. On macOS, which has no
+ * \c posix_fallocate, the file is only extended with \c ftruncate.
+ *
+ * \par Crash
+ * Content in the mapping is kept by the page cache even if the process dies.
+ * The file is truncated to the written content only when it is closed
+ * normally. Otherwise, the tail of the last chunk is filled with zero.
+ *
+ * \par Content
+ * Content is written as it is, without any locale conversion. Hence only
+ * single byte character is supported.
+ *
+ * \tparam CharT Character type for the file content.
+ */
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class mmap_file
+{
+    static_assert(sizeof(CharT) == 1U,
+                  "mmap_file only supports single byte character.");
+
+public:
+    using value_type = CharT;
+    using traits_type = Traits;
+    using string_view_type =
+        typename std::basic_string_view<value_type, traits_type>;
+    using size_type = std::size_t;
+
+    /**
+     * \brief Default size which the file grows by in bytes.
+     */
+    static constexpr const size_type default_chunk_size{4U * 1024U * 1024U};
+
+    /**
+     * \brief Initializes a new instance of the mmap_file object class
+     *
+     * Create the file named \a filename and its \a mode. It will create the
+     * file if \a filename is not existed. Otherwise, it will open it.
+     *
+     * \param filename Specified file name.
+     * \param mode Specified mode.
+     * \param chunk_size Size which the file grows by in bytes.
+     * \throw logency::system_error if the file failed to open.
+     */
+    explicit mmap_file(const char *filename, file_open_mode mode,
+                       size_type chunk_size = default_chunk_size);
+
+    /**
+     * \overload
+     */
+    explicit mmap_file(const std::string &filename, file_open_mode mode,
+                       size_type chunk_size = default_chunk_size);
+
+    /**
+     * \overload
+     */
+    template <typename FsPath>
+    explicit mmap_file(const FsPath &filename, file_open_mode mode,
+                       size_type chunk_size = default_chunk_size);
+
+    /**
+     * \brief Unmap the file, truncate it to the written content and close it.
+     *
+     * Error is ignored.
+     */
+    ~mmap_file();
+
+    mmap_file(const mmap_file &other) = delete;
+    auto operator=(const mmap_file &other) -> mmap_file & = delete;
+    mmap_file(mmap_file &&other) noexcept = delete;
+    auto operator=(mmap_file &&other) noexcept -> mmap_file & = delete;
+
+    /**
+     * \brief write the \a buffer to the file.
+     *
+     * \param buffer Specified buffer.
+     * \throw logency::system_error when it failed to grow the file.
+     */
+    void write(string_view_type buffer);
+
+    /**
+     * \brief Schedule the written content to be written back.
+     *
+     * \throw logency::system_error when it failed to flush.
+     */
+    void flush();
+
+private:
+    void reserve(size_type size);
+
+    /**
+     * \brief Allocate the blocks of [\a offset, \a offset + \a length) and
+     * extend the file to cover them.
+     *
+     * \return \c 0, or the error number.
+     */
+    [[nodiscard]] auto allocate(size_type offset, size_type length) noexcept
+        -> int;
+
+    void unmap() noexcept;
+
+    [[noreturn]] static void throw_error(const char *what);
+
+    int descriptor_{-1};
+
+    value_type *mapping_{nullptr};
+    const size_type chunk_size_;
+    size_type capacity_{0U}; //!< Size of the mapping and the file.
+    size_type size_{0U};     //!< Size of the written content.
+};
+
+template <typename CharT, typename Traits>
+mmap_file<CharT, Traits>::mmap_file(const char *filename, file_open_mode mode,
+                                    size_type chunk_size)
+    : chunk_size_{chunk_size}
+{
+    assert(chunk_size_ != 0U);
+
+    constexpr const ::mode_t permission{0666};
+    const int flags{O_RDWR | O_CREAT | O_CLOEXEC |
+                    ((mode == file_open_mode::truncate) ? O_TRUNC : 0)};
+
+    create_necessary_directory(filename);
+
+    do
+    {
+        descriptor_ = ::open(filename, flags, permission);
+    } while ((descriptor_ == -1) && (errno == EINTR));
+
+    if (descriptor_ == -1)
+    {
+        throw_error("Failed to open file");
+    }
+
+    struct ::stat status
+    {
+    };
+
+    if (::fstat(descriptor_, &status) == -1)
+    {
+        const auto error{errno};
+        ::close(descriptor_);
+
+        errno = error;
+        throw_error("Failed to open file");
+    }
+
+    // Content is appended after the existing one.
+    size_ = static_cast<size_type>(status.st_size);
+    capacity_ = size_;
+}
+
+template <typename CharT, typename Traits>
+mmap_file<CharT, Traits>::mmap_file(const std::string &filename,
+                                    file_open_mode mode, size_type chunk_size)
+    : mmap_file{filename.c_str(), mode, chunk_size}
+{
+}
+
+template <typename CharT, typename Traits>
+template <typename FsPath>
+mmap_file<CharT, Traits>::mmap_file(const FsPath &filename,
+                                    file_open_mode mode, size_type chunk_size)
+    : mmap_file{filename.c_str(), mode, chunk_size}
+{
+}
+
+template <typename CharT, typename Traits>
+mmap_file<CharT, Traits>::~mmap_file()
+{
+    unmap();
+
+    if (capacity_ != size_)
+    {
+        // Nothing can be done in destructor if it fails.
+        static_cast<void>(
+            ::ftruncate(descriptor_, static_cast<::off_t>(size_)));
+    }
+
+    ::close(descriptor_);
+}
+
+template <typename CharT, typename Traits>
+void mmap_file<CharT, Traits>::flush()
+{
+    assert(descriptor_ != -1);
+
+    if ((mapping_ != nullptr) &&
+        (::msync(mapping_, capacity_, MS_ASYNC) == -1))
+    {
+        throw_error("Failed to flush the file");
+    }
+}
+
+template <typename CharT, typename Traits>
+void mmap_file<CharT, Traits>::write(string_view_type buffer)
+{
+    assert(descriptor_ != -1);
+
+    if (buffer.empty())
+    {
+        return;
+    }
+
+    if ((mapping_ == nullptr) || (buffer.size() > capacity_ - size_))
+    {
+        reserve(size_ + buffer.size());
+    }
+
+    traits_type::copy(mapping_ + size_, buffer.data(), buffer.size()); // NOLINT
+    size_ += buffer.size();
+}
+
+template <typename CharT, typename Traits>
+void mmap_file<CharT, Traits>::reserve(size_type size)
+{
+    // Grow by whole chunks, so the file is remapped only once in a while.
+    const auto capacity{((size + chunk_size_ - 1U) / chunk_size_) *
+                        chunk_size_};
+
+    unmap();
+
+    if (capacity != capacity_)
+    {
+        if (const auto error{allocate(size_, capacity - size_)}; error != 0)
+        {
+            // Drop whatever is allocated, so the destructor does not keep it.
+            static_cast<void>(
+                ::ftruncate(descriptor_, static_cast<::off_t>(capacity_)));
+
+            errno = error;
+            throw_error("Failed to write content");
+        }
+    }
+
+    capacity_ = capacity;
+
+    auto *mapping{::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, descriptor_, 0)};
+
+    if (mapping == MAP_FAILED) // NOLINT(*-cstyle-cast)
+    {
+        throw_error("Failed to write content");
+    }
+
+    mapping_ = static_cast<value_type *>(mapping);
+}
+
+template <typename CharT, typename Traits>
+auto mmap_file<CharT, Traits>::allocate(size_type offset,
+                                        size_type length) noexcept -> int
+{
+    #if defined(__APPLE__)
+    const auto size{static_cast<::off_t>(offset + length)};
+
+    return (::ftruncate(descriptor_, size) == -1) ? errno : 0;
+    #else
+    int error{0};
+
+    do
+    {
+        // It returns the error number instead of setting errno.
+        error = ::posix_fallocate(descriptor_, static_cast<::off_t>(offset),
+                                  static_cast<::off_t>(length));
+    } while (error == EINTR);
+
+    return error;
+    #endif
+}
+
+template <typename CharT, typename Traits>
+void mmap_file<CharT, Traits>::unmap() noexcept
+{
+    if (mapping_ != nullptr)
+    {
+        ::munmap(mapping_, capacity_);
+        mapping_ = nullptr;
+    }
+}
+
+template <typename CharT, typename Traits>
+void mmap_file<CharT, Traits>::throw_error(const char *what)
+{
+    throw logency::system_error(std::error_code{errno, std::generic_category()},
+                                what);
+}
+
+} // namespace logency::detail::file
+
+#endif
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_MMAP_FILE_HPP_
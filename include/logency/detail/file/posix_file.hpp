@@ -0,0 +1,271 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_POSIX_FILE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_POSIX_FILE_HPP_
+
+#if !defined(_WIN32)
+
+    #include "logency/core/exception.hpp"
+    #include "logency/detail/file/basic_file.hpp"
+    #include "logency/detail/file/file_helper.hpp"
+
+    #include <cassert>
+    #include <cerrno>
+    #include <cstddef>
+
+    #include <fcntl.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+
+    #include <filesystem>
+    #include <memory>
+    #include <string>
+    #include <string_view>
+    #include <system_error>
+
+namespace logency::detail::file
+{
+
+/**
+ * \brief This class represent the file_object backed by a POSIX file
+ * descriptor.
+ *
+ * It has the same contract as basic_file. Content is kept in a large
+ * user-space buffer, and goes to the file when the buffer is full or on
+ * flush(). Content larger than the free space is written along with the
+ * buffer by a single \c writev.
+ *
+ * \par Content
+ * Content is written as it is, without any locale conversion. Hence only
+ * single byte character is supported.
+ *
+ * \tparam CharT Character type for the file content.
+ */
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class posix_file
+{
+    static_assert(sizeof(CharT) == 1U,
+                  "posix_file only supports single byte character.");
+
+public:
+    using value_type = CharT;
+    using traits_type = Traits;
+    using string_view_type =
+        typename std::basic_string_view<value_type, traits_type>;
+    using size_type = std::size_t;
+
+    /**
+     * \brief Default size of the write buffer in bytes.
+     */
+    static constexpr const size_type default_buffer_size{256U * 1024U};
+
+    /**
+     * \brief Initializes a new instance of the posix_file object class
+     *
+     * Create the file named \a filename and its \a mode. It will create the
+     * file if \a filename is not existed. Otherwise, it will open it.
+     *
+     * \param filename Specified file name.
+     * \param mode Specified mode.
+     * \param buffer_size Size of the write buffer in bytes.
+     * \throw logency::system_error if the file failed to open.
+     */
+    explicit posix_file(const char *filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size);
+
+    /**
+     * \overload
+     */
+    explicit posix_file(const std::string &filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size);
+
+    /**
+     * \overload
+     */
+    template <typename FsPath>
+    explicit posix_file(const FsPath &filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size);
+
+    /**
+     * \brief Write the buffer out and close the file.
+     *
+     * Error is ignored. Call flush() before it to get notified.
+     */
+    ~posix_file();
+
+    posix_file(const posix_file &other) = delete;
+    auto operator=(const posix_file &other) -> posix_file & = delete;
+    posix_file(posix_file &&other) noexcept = delete;
+    auto operator=(posix_file &&other) noexcept -> posix_file & = delete;
+
+    /**
+     * \brief write the \a buffer to the file.
+     *
+     * \param buffer Specified buffer.
+     * \throw logency::system_error when it failed to write.
+     */
+    void write(string_view_type buffer);
+
+    /**
+     * \brief Write the buffered content to the file.
+     *
+     * \throw logency::system_error when it failed to write.
+     */
+    void flush();
+
+private:
+    static auto open_flags(file_open_mode mode) noexcept -> int;
+
+    void write_all(::iovec *vector, int count);
+
+    int descriptor_{-1};
+
+    std::unique_ptr<value_type[]> buffer_; // NOLINT(*-c-arrays)
+    const size_type capacity_;
+    size_type size_{0U};
+};
+
+template <typename CharT, typename Traits>
+posix_file<CharT, Traits>::posix_file(const char *filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size)
+    : buffer_{std::make_unique<value_type[]>(buffer_size)}, // NOLINT
+      capacity_{buffer_size}
+{
+    constexpr const ::mode_t permission{0666};
+
+    create_necessary_directory(filename);
+
+    do
+    {
+        descriptor_ = ::open(filename, open_flags(mode), permission);
+    } while ((descriptor_ == -1) && (errno == EINTR));
+
+    if (descriptor_ == -1)
+    {
+        throw logency::system_error(
+            std::error_code{errno, std::generic_category()},
+            "Failed to open file"); // No period needed.
+    }
+}
+
+template <typename CharT, typename Traits>
+posix_file<CharT, Traits>::posix_file(const std::string &filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size)
+    : posix_file{filename.c_str(), mode, buffer_size}
+{
+}
+
+template <typename CharT, typename Traits>
+template <typename FsPath>
+posix_file<CharT, Traits>::posix_file(const FsPath &filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size)
+    : posix_file{filename.c_str(), mode, buffer_size}
+{
+}
+
+template <typename CharT, typename Traits>
+posix_file<CharT, Traits>::~posix_file()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        // Nothing can be done in destructor.
+    }
+
+    ::close(descriptor_);
+}
+
+template <typename CharT, typename Traits>
+void posix_file<CharT, Traits>::flush()
+{
+    assert(descriptor_ != -1);
+
+    if (size_ == 0U)
+    {
+        return;
+    }
+
+    ::iovec vector{buffer_.get(), size_};
+
+    size_ = 0U; // Content is dropped if it fails, the same as fstream does.
+    write_all(&vector, 1);
+}
+
+template <typename CharT, typename Traits>
+auto posix_file<CharT, Traits>::open_flags(file_open_mode mode) noexcept -> int
+{
+    constexpr const int flags{O_WRONLY | O_CREAT | O_CLOEXEC};
+
+    return flags | ((mode == file_open_mode::append) ? O_APPEND : O_TRUNC);
+}
+
+template <typename CharT, typename Traits>
+void posix_file<CharT, Traits>::write(string_view_type buffer)
+{
+    assert(descriptor_ != -1);
+
+    if (buffer.size() <= capacity_ - size_)
+    {
+        traits_type::copy(buffer_.get() + size_, buffer.data(), buffer.size());
+        size_ += buffer.size();
+
+        return;
+    }
+
+    // Too large for the free space. Write both of them at once.
+    ::iovec vectors[2]{// NOLINT(*-c-arrays)
+                       {buffer_.get(), size_},
+                       {const_cast<value_type *>(buffer.data()), // NOLINT
+                        buffer.size()}};
+
+    size_ = 0U;
+    write_all(vectors, 2);
+}
+
+template <typename CharT, typename Traits>
+void posix_file<CharT, Traits>::write_all(::iovec *vector, int count)
+{
+    while (count > 0)
+    {
+        const auto written{::writev(descriptor_, vector, count)};
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw logency::system_error(
+                std::error_code{errno, std::generic_category()},
+                "Failed to write content"); // No period needed.
+        }
+
+        // Skip what is written. It might stop in the middle of a vector.
+        auto remain{static_cast<size_type>(written)};
+
+        while ((count > 0) && (remain >= vector->iov_len))
+        {
+            remain -= vector->iov_len;
+            ++vector; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            --count;
+        }
+
+        if (count > 0)
+        {
+            vector->iov_base = static_cast<std::byte *>(vector->iov_base) +
+                               remain; // NOLINT
+            vector->iov_len -= remain;
+        }
+    }
+}
+
+} // namespace logency::detail::file
+
+#endif
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_POSIX_FILE_HPP_
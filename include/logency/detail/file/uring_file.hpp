@@ -0,0 +1,707 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_URING_FILE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_URING_FILE_HPP_
+
+#if defined(__linux__)
+
+    #include "logency/core/exception.hpp"
+    #include "logency/detail/file/basic_file.hpp"
+    #include "logency/detail/file/file_helper.hpp"
+
+    #include <algorithm>
+    #include <cassert>
+    #include <cerrno>
+    #include <cstddef>
+    #include <cstdint>
+
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #include <memory>
+    #include <string>
+    #include <string_view>
+    #include <system_error>
+    #include <utility>
+    #include <vector>
+
+namespace logency::detail::file
+{
+
+/**
+ * \brief This class represent a minimal io_uring instance.
+ *
+ * It only submits write requests and reaps their completions. The system calls
+ * are made directly, so no library is needed.
+ *
+ * If io_uring is not available (old kernel, disabled by the system, etc.),
+ * valid() returns \c false.
+ */
+class uring
+{
+public:
+    /**
+     * \brief Set up the io_uring with at least \a entries entries.
+     */
+    explicit uring(unsigned entries) noexcept;
+    ~uring();
+
+    uring(const uring &other) = delete;
+    auto operator=(const uring &other) -> uring & = delete;
+    uring(uring &&other) noexcept = delete;
+    auto operator=(uring &&other) noexcept -> uring & = delete;
+
+    [[nodiscard]] auto valid() const noexcept -> bool;
+
+    /**
+     * \brief Submit the write of \a data to \a descriptor at \a offset.
+     *
+     * The caller must not submit more requests than the entries in flight.
+     *
+     * \throw logency::system_error if it failed to submit.
+     */
+    void write(int descriptor, const void *data, std::size_t size,
+               std::uint64_t offset, std::uint64_t user_data);
+
+    /**
+     * \brief Pass each completion to \a handler as (user_data, result).
+     *
+     * \param block Wait until at least one completion arrives.
+     * \throw logency::system_error if it failed to wait.
+     */
+    template <typename Handler>
+    void reap(bool block, Handler &&handler);
+
+private:
+    [[nodiscard]] static auto load(const unsigned *value) noexcept
+        -> unsigned;
+    static void store(unsigned *value, unsigned number) noexcept;
+
+    void release() noexcept;
+
+    /**
+     * Submit the pending entries, and wait for \a wait completions.
+     */
+    void enter(unsigned wait, const char *what);
+
+    template <typename T>
+    [[nodiscard]] auto at(void *base, std::uint32_t offset) const noexcept
+        -> T *;
+
+    int descriptor_{-1};
+
+    void *submission_ring_{MAP_FAILED}; // NOLINT(*-cstyle-cast)
+    std::size_t submission_ring_size_{0U};
+    void *completion_ring_{MAP_FAILED}; // NOLINT(*-cstyle-cast)
+    std::size_t completion_ring_size_{0U};
+    ::io_uring_sqe *entries_{nullptr};
+    std::size_t entries_size_{0U};
+
+    ::io_uring_params params_{};
+    unsigned pending_{0U}; //!< Entries which are not submitted yet.
+};
+
+/**
+ * \brief This class represent the file_object which writes through io_uring.
+ *
+ * It has the same contract as basic_file. Content is kept in one of several
+ * buffers. When the buffer is full or on flush(), it is submitted to io_uring
+ * and the next buffer is used, so the caller keeps going while the kernel
+ * writes. A buffer is waited only when it comes round again.
+ *
+ * \par Flush
+ * flush() only submits the buffered content. It is written in the background,
+ * and the error of it is thrown by the next write() or flush(). The destructor
+ * waits for all of them.
+ *
+ * \par Fallback
+ * If io_uring is not available, or \a buffer_count is 1, the content is
+ * written synchronously with \c pwrite when the buffer is full or on flush().
+ *
+ * \par Content
+ * Content is written as it is, without any locale conversion. Hence only
+ * single byte character is supported. The offset of the file is tracked by
+ * this object, so no one else should write the file at the same time.
+ *
+ * \tparam CharT Character type for the file content.
+ */
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class uring_file
+{
+    static_assert(sizeof(CharT) == 1U,
+                  "uring_file only supports single byte character.");
+
+public:
+    using value_type = CharT;
+    using traits_type = Traits;
+    using string_view_type =
+        typename std::basic_string_view<value_type, traits_type>;
+    using size_type = std::size_t;
+
+    /**
+     * \brief Default size of each buffer in bytes.
+     */
+    static constexpr const size_type default_buffer_size{256U * 1024U};
+
+    /**
+     * \brief Default number of buffers.
+     */
+    static constexpr const size_type default_buffer_count{4U};
+
+    /**
+     * \brief Initializes a new instance of the uring_file object class
+     *
+     * Create the file named \a filename and its \a mode. It will create the
+     * file if \a filename is not existed. Otherwise, it will open it.
+     *
+     * \param filename Specified file name.
+     * \param mode Specified mode.
+     * \param buffer_size Size of each buffer in bytes.
+     * \param buffer_count Number of buffers, which is the most writes in
+     * flight.
+     * \throw logency::system_error if the file failed to open.
+     */
+    explicit uring_file(const char *filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size,
+                        size_type buffer_count = default_buffer_count);
+
+    /**
+     * \overload
+     */
+    explicit uring_file(const std::string &filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size,
+                        size_type buffer_count = default_buffer_count);
+
+    /**
+     * \overload
+     */
+    template <typename FsPath>
+    explicit uring_file(const FsPath &filename, file_open_mode mode,
+                        size_type buffer_size = default_buffer_size,
+                        size_type buffer_count = default_buffer_count);
+
+    /**
+     * \brief Write all the content out and close the file.
+     *
+     * Error is ignored. Call flush() before it to get notified.
+     */
+    ~uring_file();
+
+    uring_file(const uring_file &other) = delete;
+    auto operator=(const uring_file &other) -> uring_file & = delete;
+    uring_file(uring_file &&other) noexcept = delete;
+    auto operator=(uring_file &&other) noexcept -> uring_file & = delete;
+
+    /**
+     * \brief Whether the content is written through io_uring.
+     */
+    [[nodiscard]] auto is_asynchronous() const noexcept -> bool;
+
+    /**
+     * \brief write the \a buffer to the file.
+     *
+     * \param buffer Specified buffer.
+     * \throw logency::system_error when it failed to write.
+     */
+    void write(string_view_type buffer);
+
+    /**
+     * \brief Submit the buffered content.
+     *
+     * \throw logency::system_error when it failed to write.
+     */
+    void flush();
+
+private:
+    struct buffer_type
+    {
+        std::unique_ptr<value_type[]> data; // NOLINT(*-c-arrays)
+        size_type size{0U};
+        ::off_t offset{0};
+        bool in_flight{false};
+    };
+
+    void submit();
+    void wait(const buffer_type &buffer);
+    void wait_all();
+    void complete(std::uint64_t index, int result) noexcept;
+    void write_at(const value_type *data, size_type size, ::off_t offset);
+    void check_error();
+
+    int descriptor_{-1};
+
+    std::unique_ptr<uring> ring_{};
+    std::vector<buffer_type> buffers_{};
+    size_type current_{0U};
+    const size_type capacity_;
+    ::off_t offset_{0};
+
+    int error_{0}; //!< First error of the writes in the background.
+};
+
+inline uring::uring(unsigned entries) noexcept
+{
+    descriptor_ = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, entries, &params_));
+
+    if (descriptor_ == -1)
+    {
+        return;
+    }
+
+    submission_ring_size_ =
+        params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+    completion_ring_size_ =
+        params_.cq_off.cqes + params_.cq_entries * sizeof(::io_uring_cqe);
+
+    const bool single_mmap{(params_.features & IORING_FEAT_SINGLE_MMAP) != 0U};
+
+    if (single_mmap)
+    {
+        submission_ring_size_ =
+            std::max(submission_ring_size_, completion_ring_size_);
+        completion_ring_size_ = submission_ring_size_;
+    }
+
+    submission_ring_ = ::mmap(nullptr, submission_ring_size_,
+                              PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              descriptor_, IORING_OFF_SQ_RING);
+
+    completion_ring_ =
+        single_mmap ? submission_ring_
+                    : ::mmap(nullptr, completion_ring_size_,
+                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             descriptor_, IORING_OFF_CQ_RING);
+
+    entries_size_ = params_.sq_entries * sizeof(::io_uring_sqe);
+
+    auto *entries_mapping{::mmap(nullptr, entries_size_,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, descriptor_,
+                                 IORING_OFF_SQES)};
+
+    if (entries_mapping != MAP_FAILED) // NOLINT(*-cstyle-cast)
+    {
+        entries_ = static_cast<::io_uring_sqe *>(entries_mapping);
+    }
+
+    if ((submission_ring_ == MAP_FAILED) || // NOLINT(*-cstyle-cast)
+        (completion_ring_ == MAP_FAILED) || // NOLINT(*-cstyle-cast)
+        (entries_ == nullptr))
+    {
+        release();
+    }
+}
+
+inline uring::~uring()
+{
+    release();
+}
+
+inline void uring::release() noexcept
+{
+    if (entries_ != nullptr)
+    {
+        ::munmap(entries_, entries_size_);
+        entries_ = nullptr;
+    }
+
+    if ((completion_ring_ != MAP_FAILED) && // NOLINT(*-cstyle-cast)
+        (completion_ring_ != submission_ring_))
+    {
+        ::munmap(completion_ring_, completion_ring_size_);
+    }
+    completion_ring_ = MAP_FAILED; // NOLINT(*-cstyle-cast)
+
+    if (submission_ring_ != MAP_FAILED) // NOLINT(*-cstyle-cast)
+    {
+        ::munmap(submission_ring_, submission_ring_size_);
+    }
+    submission_ring_ = MAP_FAILED; // NOLINT(*-cstyle-cast)
+
+    if (descriptor_ != -1)
+    {
+        ::close(descriptor_);
+        descriptor_ = -1;
+    }
+}
+
+inline auto uring::valid() const noexcept -> bool
+{
+    return descriptor_ != -1;
+}
+
+inline void uring::write(int descriptor, const void *data, std::size_t size,
+                         std::uint64_t offset, std::uint64_t user_data)
+{
+    assert(valid());
+
+    auto *tail_pointer{at<unsigned>(submission_ring_, params_.sq_off.tail)};
+    const auto mask{*at<unsigned>(submission_ring_, params_.sq_off.ring_mask)};
+
+    // Only this thread writes the tail.
+    const auto tail{*tail_pointer};
+    const auto index{tail & mask};
+
+    auto &entry{entries_[index]}; // NOLINT(*-pointer-arithmetic)
+    entry = ::io_uring_sqe{};
+    entry.opcode = IORING_OP_WRITE;
+    entry.fd = descriptor;
+    entry.addr = reinterpret_cast<std::uintptr_t>(data); // NOLINT
+    entry.len = static_cast<std::uint32_t>(size);
+    entry.off = offset;
+    entry.user_data = user_data;
+
+    at<unsigned>(submission_ring_, params_.sq_off.array)[index] = // NOLINT
+        index;
+    store(tail_pointer, tail + 1U);
+    ++pending_;
+
+    enter(0U, "Failed to submit content");
+}
+
+template <typename Handler>
+void uring::reap(bool block, Handler &&handler)
+{
+    assert(valid());
+
+    auto *head_pointer{at<unsigned>(completion_ring_, params_.cq_off.head)};
+    const auto *tail_pointer{
+        at<unsigned>(completion_ring_, params_.cq_off.tail)};
+    const auto mask{*at<unsigned>(completion_ring_, params_.cq_off.ring_mask)};
+    const auto *completions{
+        at<::io_uring_cqe>(completion_ring_, params_.cq_off.cqes)};
+
+    auto head{*head_pointer};
+
+    if ((head == load(tail_pointer)) && block)
+    {
+        enter(1U, "Failed to wait content");
+    }
+
+    for (const auto tail{load(tail_pointer)}; head != tail; ++head)
+    {
+        const auto &completion{completions[head & mask]}; // NOLINT
+
+        handler(completion.user_data, completion.res);
+    }
+
+    store(head_pointer, head);
+}
+
+inline auto uring::load(const unsigned *value) noexcept -> unsigned
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+inline void uring::store(unsigned *value, unsigned number) noexcept
+{
+    __atomic_store_n(value, number, __ATOMIC_RELEASE);
+}
+
+inline void uring::enter(unsigned wait, const char *what)
+{
+    const unsigned flags{wait != 0U ? IORING_ENTER_GETEVENTS : 0U};
+
+    while (true)
+    {
+        const auto result{::syscall(__NR_io_uring_enter, descriptor_, pending_,
+                                    wait, flags, nullptr, 0)};
+
+        if (result != -1)
+        {
+            pending_ -= static_cast<unsigned>(result);
+            return;
+        }
+
+        // The kernel is busy. The entries are submitted next time.
+        if (((errno == EAGAIN) || (errno == EBUSY)) && (wait == 0U))
+        {
+            return;
+        }
+
+        if (errno != EINTR)
+        {
+            throw logency::system_error(
+                std::error_code{errno, std::generic_category()}, what);
+        }
+    }
+}
+
+template <typename T>
+auto uring::at(void *base, std::uint32_t offset) const noexcept -> T *
+{
+    // NOLINTNEXTLINE(*-reinterpret-cast,*-pointer-arithmetic)
+    return reinterpret_cast<T *>(static_cast<std::byte *>(base) + offset);
+}
+
+template <typename CharT, typename Traits>
+uring_file<CharT, Traits>::uring_file(const char *filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size,
+                                      size_type buffer_count)
+    : capacity_{buffer_size}
+{
+    assert(buffer_size != 0U);
+    assert(buffer_count != 0U);
+
+    constexpr const ::mode_t permission{0666};
+    const int flags{O_WRONLY | O_CREAT | O_CLOEXEC |
+                    ((mode == file_open_mode::truncate) ? O_TRUNC : 0)};
+
+    create_necessary_directory(filename);
+
+    do
+    {
+        descriptor_ = ::open(filename, flags, permission);
+    } while ((descriptor_ == -1) && (errno == EINTR));
+
+    struct ::stat status
+    {
+    };
+
+    if ((descriptor_ == -1) || (::fstat(descriptor_, &status) == -1))
+    {
+        const auto error{errno};
+
+        if (descriptor_ != -1)
+        {
+            ::close(descriptor_);
+        }
+
+        throw logency::system_error(
+            std::error_code{error, std::generic_category()},
+            "Failed to open file"); // No period needed.
+    }
+
+    // Content is appended after the existing one.
+    offset_ = status.st_size;
+
+    if (buffer_count > 1U)
+    {
+        ring_ = std::make_unique<uring>(static_cast<unsigned>(buffer_count));
+
+        if (!ring_->valid())
+        {
+            ring_.reset();
+        }
+    }
+
+    // Synchronous write needs only one buffer.
+    buffers_.resize(is_asynchronous() ? buffer_count : 1U);
+
+    for (auto &buffer : buffers_)
+    {
+        buffer.data = std::make_unique<value_type[]>(capacity_); // NOLINT
+    }
+}
+
+template <typename CharT, typename Traits>
+uring_file<CharT, Traits>::uring_file(const std::string &filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size,
+                                      size_type buffer_count)
+    : uring_file{filename.c_str(), mode, buffer_size, buffer_count}
+{
+}
+
+template <typename CharT, typename Traits>
+template <typename FsPath>
+uring_file<CharT, Traits>::uring_file(const FsPath &filename,
+                                      file_open_mode mode,
+                                      size_type buffer_size,
+                                      size_type buffer_count)
+    : uring_file{filename.c_str(), mode, buffer_size, buffer_count}
+{
+}
+
+template <typename CharT, typename Traits>
+uring_file<CharT, Traits>::~uring_file()
+{
+    try
+    {
+        submit();
+        wait_all();
+    }
+    catch (...)
+    {
+        // Nothing can be done in destructor.
+    }
+
+    // The buffers must not be released while the kernel is using them.
+    ring_.reset();
+
+    ::close(descriptor_);
+}
+
+template <typename CharT, typename Traits>
+auto uring_file<CharT, Traits>::is_asynchronous() const noexcept -> bool
+{
+    return ring_ != nullptr;
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::flush()
+{
+    assert(descriptor_ != -1);
+
+    check_error();
+    submit();
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::write(string_view_type buffer)
+{
+    assert(descriptor_ != -1);
+
+    check_error();
+
+    while (!buffer.empty())
+    {
+        auto &current{buffers_[current_]};
+        const auto size{std::min(buffer.size(), capacity_ - current.size)};
+
+        traits_type::copy(current.data.get() + current.size, buffer.data(),
+                          size);
+        current.size += size;
+        buffer.remove_prefix(size);
+
+        if (current.size == capacity_)
+        {
+            submit();
+        }
+    }
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::submit()
+{
+    auto &current{buffers_[current_]};
+
+    if (current.size == 0U)
+    {
+        return;
+    }
+
+    if (!is_asynchronous())
+    {
+        // Content is dropped if it fails, the same as fstream does.
+        const auto size{std::exchange(current.size, 0U)};
+
+        write_at(current.data.get(), size, offset_);
+        offset_ += static_cast<::off_t>(size);
+        return;
+    }
+
+    current.offset = offset_;
+    current.in_flight = true;
+    offset_ += static_cast<::off_t>(current.size);
+
+    current_ = (current_ + 1U) % buffers_.size();
+
+    ring_->write(descriptor_, current.data.get(), current.size,
+                 static_cast<std::uint64_t>(current.offset),
+                 static_cast<std::uint64_t>(&current - buffers_.data()));
+
+    // Collect the finished writes, and wait for the next buffer if needed.
+    ring_->reap(false, [this](std::uint64_t index, int result)
+                { complete(index, result); });
+    wait(buffers_[current_]);
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::wait(const buffer_type &buffer)
+{
+    while (buffer.in_flight)
+    {
+        ring_->reap(true, [this](std::uint64_t index, int result)
+                    { complete(index, result); });
+    }
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::wait_all()
+{
+    if (is_asynchronous())
+    {
+        for (const auto &buffer : buffers_)
+        {
+            wait(buffer);
+        }
+    }
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::complete(std::uint64_t index,
+                                         int result) noexcept
+{
+    auto &buffer{buffers_[static_cast<size_type>(index)]};
+
+    // Short or failed write (e.g. the kernel does not support the operation).
+    // Write the rest synchronously.
+    const auto written{result < 0 ? 0U : static_cast<size_type>(result)};
+
+    if (written < buffer.size)
+    {
+        try
+        {
+            write_at(buffer.data.get() + written, buffer.size - written,
+                     buffer.offset + static_cast<::off_t>(written));
+        }
+        catch (const logency::system_error &e)
+        {
+            if (error_ == 0)
+            {
+                error_ = e.code().value();
+            }
+        }
+    }
+
+    buffer.size = 0U;
+    buffer.in_flight = false;
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::write_at(const value_type *data,
+                                         size_type size, ::off_t offset)
+{
+    while (size != 0U)
+    {
+        const auto written{::pwrite(descriptor_, data, size, offset)};
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw logency::system_error(
+                std::error_code{errno, std::generic_category()},
+                "Failed to write content"); // No period needed.
+        }
+
+        data += written; // NOLINT(*-pointer-arithmetic)
+        size -= static_cast<size_type>(written);
+        offset += written;
+    }
+}
+
+template <typename CharT, typename Traits>
+void uring_file<CharT, Traits>::check_error()
+{
+    if (error_ != 0)
+    {
+        throw logency::system_error(
+            std::error_code{std::exchange(error_, 0), std::generic_category()},
+            "Failed to write content"); // No period needed.
+    }
+}
+
+} // namespace logency::detail::file
+
+#endif
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_FILE_URING_FILE_HPP_
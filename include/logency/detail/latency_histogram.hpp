@@ -0,0 +1,190 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_LATENCY_HISTOGRAM_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_LATENCY_HISTOGRAM_HPP_
+
+#include "logency/core/stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace logency::detail
+{
+
+/**
+ * \brief This class represent the log-linear histogram of latencies, in the
+ * HDR histogram style.
+ *
+ * Each power of two range is split into \c 2^sub_bucket_bits buckets of the
+ * same width, so the relative error of the percentiles is below
+ * \c 1/2^sub_bucket_bits, about 3%. The latencies at or above
+ * \c 2^max_bits nanoseconds (about 18 minutes) fall into the last bucket,
+ * while the maximum is kept exactly.
+ *
+ * \par Thread safety
+ * record() should be serialized by the caller. summary() might be called by
+ * any thread at the same time.
+ */
+class latency_histogram
+{
+public:
+    using value_type = std::uint64_t; //!< Nanoseconds.
+
+    static constexpr const unsigned sub_bucket_bits{5U};
+    static constexpr const unsigned max_bits{40U};
+
+    void record(std::chrono::nanoseconds latency) noexcept;
+
+    [[nodiscard]] auto summary() const noexcept -> latency_stats;
+
+private:
+    static constexpr const std::size_t sub_bucket_count{1U
+                                                        << sub_bucket_bits};
+    static constexpr const std::size_t bucket_count{
+        (max_bits - sub_bucket_bits + 1U) * sub_bucket_count};
+
+    [[nodiscard]] static auto log2_floor(value_type value) noexcept
+        -> unsigned;
+    [[nodiscard]] static auto index_of(value_type value) noexcept
+        -> std::size_t;
+    [[nodiscard]] static auto upper_bound_of(std::size_t index) noexcept
+        -> value_type;
+
+    std::array<std::atomic<std::uint64_t>, bucket_count> counts_{};
+    std::atomic<value_type> max_{0U};
+};
+
+inline auto latency_histogram::index_of(value_type value) noexcept
+    -> std::size_t
+{
+    value = std::min(value, (value_type{1U} << max_bits) - 1U);
+
+    if (value < sub_bucket_count)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    const auto exponent{log2_floor(value)};
+    const auto shift{exponent - sub_bucket_bits};
+    const auto magnitude{static_cast<std::size_t>(shift) + 1U};
+    const auto sub{static_cast<std::size_t>(value >> shift) -
+                   sub_bucket_count};
+
+    return (magnitude * sub_bucket_count) + sub;
+}
+
+inline auto latency_histogram::log2_floor(value_type value) noexcept
+    -> unsigned
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63U - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned result{0U};
+
+    while ((value >>= 1U) != 0U)
+    {
+        ++result;
+    }
+
+    return result;
+#endif
+}
+
+inline void latency_histogram::record(std::chrono::nanoseconds latency) noexcept
+{
+    const auto count{
+        std::max<std::chrono::nanoseconds::rep>(latency.count(), 0)};
+    const auto value{static_cast<value_type>(count)};
+
+    // The only writer, hence no read-modify-write.
+    auto &bucket{counts_[index_of(value)]};
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1U,
+                 std::memory_order_relaxed);
+
+    if (value > max_.load(std::memory_order_relaxed))
+    {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+inline auto latency_histogram::summary() const noexcept -> latency_stats
+{
+    std::array<std::uint64_t, bucket_count> counts{};
+    latency_stats result{};
+
+    for (std::size_t index{0U}; index < bucket_count; ++index)
+    {
+        counts[index] = counts_[index].load(std::memory_order_relaxed);
+        result.count += counts[index];
+    }
+
+    const auto max{max_.load(std::memory_order_relaxed)};
+    result.max = std::chrono::nanoseconds{static_cast<std::int64_t>(max)};
+
+    if (result.count == 0U)
+    {
+        return result;
+    }
+
+    // Rank of the value at the permille, rounded up.
+    const auto rank_of{[&result](std::uint64_t permille)
+                       {
+                           return std::max<std::uint64_t>(
+                               ((result.count * permille) + 999U) / 1000U, 1U);
+                       }};
+
+    const std::array<std::uint64_t, 3U> ranks{rank_of(500U), rank_of(990U),
+                                              rank_of(999U)};
+    std::array<value_type, 3U> values{};
+
+    std::size_t target{0U};
+    std::uint64_t seen{0U};
+
+    for (std::size_t index{0U};
+         (index < bucket_count) && (target < ranks.size()); ++index)
+    {
+        seen += counts[index];
+
+        // The last bucket has no upper bound but the maximum.
+        const auto upper{(index + 1U == bucket_count)
+                             ? max
+                             : std::min(upper_bound_of(index), max)};
+
+        while ((target < ranks.size()) && (seen >= ranks[target]))
+        {
+            values[target] = upper;
+            ++target;
+        }
+    }
+
+    result.p50 = std::chrono::nanoseconds{static_cast<std::int64_t>(values[0])};
+    result.p99 = std::chrono::nanoseconds{static_cast<std::int64_t>(values[1])};
+    result.p999 =
+        std::chrono::nanoseconds{static_cast<std::int64_t>(values[2])};
+
+    return result;
+}
+
+inline auto latency_histogram::upper_bound_of(std::size_t index) noexcept
+    -> value_type
+{
+    const auto magnitude{index / sub_bucket_count};
+
+    if (magnitude == 0U)
+    {
+        return static_cast<value_type>(index);
+    }
+
+    const auto shift{static_cast<unsigned>(magnitude - 1U)};
+    const auto sub{static_cast<value_type>(index % sub_bucket_count)};
+    const auto lower{(sub_bucket_count + sub) << shift};
+
+    return lower + (value_type{1U} << shift) - 1U;
+}
+
+} // namespace logency::detail
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_LATENCY_HISTOGRAM_HPP_
@@ -0,0 +1,313 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_BLOCK_POOL_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_BLOCK_POOL_HPP_
+
+#include <cassert>
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace logency::detail::memory
+{
+
+/**
+ * \brief This class represent the pool of fixed size memory blocks.
+ *
+ * Blocks are carved from slabs and never go back to the system. Each thread
+ * keeps two chains of free blocks, and trades full chains with the shared
+ * pool. A block can be freed by any thread, so the pattern "allocated by the
+ * logging thread, freed by the sink thread" reaches a steady state without
+ * calling the system allocator at all.
+ *
+ * \par Lifetime
+ * There is one pool per block size and alignment. It lives until the process
+ * exits, since a block might be freed during static destruction. Once the
+ * cache of a thread is destroyed, that thread allocates and frees the blocks
+ * through the shared pool directly, under its mutex.
+ *
+ * \tparam Size Block size in bytes.
+ * \tparam Alignment Block alignment.
+ */
+template <std::size_t Size, std::size_t Alignment>
+class block_pool
+{
+    // Slabs only get the default new alignment.
+    static_assert(Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Over-aligned block is not supported.");
+
+public:
+    using size_type = std::size_t;
+
+    /**
+     * \brief Block count of a chain. It is also the block count of a slab.
+     */
+    static constexpr const size_type chain_size{64U};
+
+    static constexpr const size_type block_size{
+        ((((Size < sizeof(void *)) ? sizeof(void *) : Size) + Alignment - 1U) /
+         Alignment) *
+        Alignment};
+
+    [[nodiscard]] static auto instance() -> block_pool &;
+
+    [[nodiscard]] auto allocate() -> void *;
+    void deallocate(void *block) noexcept;
+
+    /**
+     * \brief Count of the slabs requested from the system so far.
+     */
+    [[nodiscard]] auto slab_count() const noexcept -> size_type;
+
+    block_pool(const block_pool &other) = delete;
+    block_pool(block_pool &&other) noexcept = delete;
+    auto operator=(const block_pool &other) -> block_pool & = delete;
+    auto operator=(block_pool &&other) noexcept -> block_pool & = delete;
+
+private:
+    using mutex_type = std::mutex;
+
+    template <typename Mutex>
+    using lock_type = std::scoped_lock<Mutex>;
+
+    struct free_block
+    {
+        free_block *next;
+    };
+
+    struct chain
+    {
+        free_block *head{nullptr};
+        size_type count{0U};
+    };
+
+    /**
+     * Free blocks owned by the current thread. Returned to the shared pool
+     * when the thread exits.
+     */
+    struct local_cache
+    {
+        explicit local_cache(bool *flag) noexcept;
+        ~local_cache();
+
+        local_cache(const local_cache &other) = delete;
+        local_cache(local_cache &&other) noexcept = delete;
+        auto operator=(const local_cache &other) -> local_cache & = delete;
+        auto operator=(local_cache &&other) noexcept -> local_cache & = delete;
+
+        chain current{};
+        chain spare{};
+        bool *destroyed;
+    };
+
+    block_pool() = default;
+    ~block_pool() = default;
+
+    /**
+     * \brief Get the cache of the current thread, or \c nullptr once it is
+     * destroyed.
+     */
+    [[nodiscard]] static auto local() -> local_cache *;
+
+    [[nodiscard]] auto acquire_chain() -> chain;
+    void release_chain(chain released) noexcept;
+    [[nodiscard]] auto allocate_shared() -> void *;
+    [[nodiscard]] auto new_slab() -> chain;
+
+    std::vector<chain> chains_{};
+    std::vector<std::unique_ptr<std::byte[]>> slabs_{}; // NOLINT(*-c-arrays)
+    std::atomic<size_type> slab_count_{0U};
+    mutex_type mutex_{};
+};
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::acquire_chain() -> chain
+{
+    {
+        lock_type<mutex_type> lock{mutex_};
+
+        if (!chains_.empty())
+        {
+            auto result{chains_.back()};
+            chains_.pop_back();
+
+            return result;
+        }
+    }
+
+    return new_slab();
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::allocate() -> void *
+{
+    auto *cache{local()};
+
+    if (cache == nullptr)
+    {
+        return allocate_shared();
+    }
+
+    if (cache->current.count == 0U)
+    {
+        if (cache->spare.count != 0U)
+        {
+            std::swap(cache->current, cache->spare);
+        }
+        else
+        {
+            cache->current = acquire_chain();
+        }
+    }
+
+    auto *block{cache->current.head};
+    cache->current.head = block->next;
+    --cache->current.count;
+
+    return block;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::allocate_shared() -> void *
+{
+    auto taken{acquire_chain()};
+
+    auto *block{taken.head};
+    taken.head = block->next;
+    --taken.count;
+
+    if (taken.count != 0U)
+    {
+        release_chain(taken);
+    }
+
+    return block;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+void block_pool<Size, Alignment>::deallocate(void *block) noexcept
+{
+    assert(block != nullptr);
+
+    auto *cache{local()};
+
+    if (cache == nullptr)
+    {
+        release_chain(chain{::new (block) free_block{nullptr}, 1U});
+        return;
+    }
+
+    if (cache->current.count == chain_size)
+    {
+        if (cache->spare.count != 0U)
+        {
+            release_chain(cache->spare);
+        }
+
+        cache->spare = cache->current;
+        cache->current = chain{};
+    }
+
+    auto *freed{::new (block) free_block{cache->current.head}};
+    cache->current.head = freed;
+    ++cache->current.count;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::instance() -> block_pool &
+{
+    // Never destroyed. See Lifetime.
+    static auto *pool{new block_pool{}};
+
+    return *pool;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::local() -> local_cache *
+{
+    // Trivially destructible, so it is still valid after `cache` is destroyed.
+    thread_local bool destroyed{false};
+    thread_local local_cache cache{&destroyed};
+
+    return destroyed ? nullptr : &cache;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::new_slab() -> chain
+{
+    // NOLINTNEXTLINE(*-c-arrays)
+    auto slab{std::make_unique<std::byte[]>(block_size * chain_size)};
+
+    chain result{};
+
+    for (size_type index{chain_size}; index > 0U; --index)
+    {
+        auto *block{slab.get() + (block_size * (index - 1U))};
+        result.head = ::new (block) free_block{result.head};
+    }
+
+    result.count = chain_size;
+
+    {
+        lock_type<mutex_type> lock{mutex_};
+        slabs_.push_back(std::move(slab));
+    }
+
+    slab_count_.fetch_add(1U, std::memory_order_relaxed);
+
+    return result;
+}
+
+template <std::size_t Size, std::size_t Alignment>
+void block_pool<Size, Alignment>::release_chain(chain released) noexcept
+{
+    try
+    {
+        lock_type<mutex_type> lock{mutex_};
+        chains_.push_back(released);
+    }
+    catch (...)
+    {
+        // Out of memory. The blocks are leaked, they are still valid memory.
+    }
+}
+
+template <std::size_t Size, std::size_t Alignment>
+auto block_pool<Size, Alignment>::slab_count() const noexcept -> size_type
+{
+    return slab_count_.load(std::memory_order_relaxed);
+}
+
+template <std::size_t Size, std::size_t Alignment>
+block_pool<Size, Alignment>::local_cache::local_cache(bool *flag) noexcept
+    : destroyed{flag}
+{
+}
+
+template <std::size_t Size, std::size_t Alignment>
+block_pool<Size, Alignment>::local_cache::~local_cache()
+{
+    auto &pool{instance()};
+
+    if (current.count != 0U)
+    {
+        pool.release_chain(current);
+    }
+
+    if (spare.count != 0U)
+    {
+        pool.release_chain(spare);
+    }
+
+    // The chains belong to the shared pool now.
+    current = chain{};
+    spare = chain{};
+    *destroyed = true;
+}
+
+} // namespace logency::detail::memory
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_BLOCK_POOL_HPP_
@@ -0,0 +1,86 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_POOL_ALLOCATOR_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_POOL_ALLOCATOR_HPP_
+
+#include "logency/detail/memory/block_pool.hpp"
+
+#include <cstddef>
+
+#include <memory>
+
+namespace logency::detail::memory
+{
+
+/**
+ * \brief This class represent the allocator backed by block_pool.
+ *
+ * Single object allocations come from the pool of its size. Array
+ * allocations fall back to std::allocator. It is stateless, so every instance
+ * compares equal.
+ *
+ * It is meant for std::allocate_shared(), which rebinds it to the type holding
+ * both the control block and the object.
+ *
+ * \tparam T Value type.
+ */
+template <typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using pool_type = block_pool<sizeof(T), alignof(T)>;
+
+    pool_allocator() noexcept = default;
+
+    template <typename U>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    pool_allocator(const pool_allocator<U> & /*other*/) noexcept
+    {
+    }
+
+    [[nodiscard]] auto allocate(size_type count) -> value_type *;
+    void deallocate(value_type *pointer, size_type count) noexcept;
+};
+
+template <typename T, typename U>
+bool operator==(const pool_allocator<T> & /*lhs*/,
+                const pool_allocator<U> & /*rhs*/) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const pool_allocator<T> & /*lhs*/,
+                const pool_allocator<U> & /*rhs*/) noexcept
+{
+    return false;
+}
+
+template <typename T>
+auto pool_allocator<T>::allocate(size_type count) -> value_type *
+{
+    if (count != 1U)
+    {
+        return std::allocator<value_type>{}.allocate(count);
+    }
+
+    return static_cast<value_type *>(pool_type::instance().allocate());
+}
+
+template <typename T>
+void pool_allocator<T>::deallocate(value_type *pointer,
+                                   size_type count) noexcept
+{
+    if (count != 1U)
+    {
+        std::allocator<value_type>{}.deallocate(pointer, count);
+        return;
+    }
+
+    pool_type::instance().deallocate(pointer);
+}
+
+} // namespace logency::detail::memory
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_MEMORY_POOL_ALLOCATOR_HPP_
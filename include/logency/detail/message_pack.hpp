@@ -1,6 +1,9 @@
 #ifndef LOGENCY_INCLUDE_LOGENCY_CORE_MESSAGE_PACK_HPP_
 #define LOGENCY_INCLUDE_LOGENCY_CORE_MESSAGE_PACK_HPP_
 
+#include "logency/detail/memory/pool_allocator.hpp"
+#include "logency/detail/string/name_registry.hpp"
+
 #include <memory>
 #include <string>
 #include <utility>
@@ -16,6 +19,10 @@ namespace logency
  * It is the basic unit for transfer message between each working unit like
  * queue, logger, and sink.
  *
+ * The logger is identified by its interned ID and name. The name refers to the
+ * storage of the name registry, which outlives the pack, so copying or
+ * releasing the pack never touches a reference count for it.
+ *
  * \tparam MessageType User message type
  */
 template <typename MessageType>
@@ -23,31 +30,53 @@ struct message_pack_base
 {
     using message_type = MessageType;
     using string_type = typename message_type::string_type;
+    using string_view_type = typename message_type::string_view_type;
+    using id_type =
+        typename detail::string::name_registry<string_type>::id_type;
 
-    explicit message_pack_base(std::shared_ptr<string_type> &&logger,
+    explicit message_pack_base(id_type id, string_view_type logger,
                                message_type &&message);
 
-    std::shared_ptr<string_type> logger_name;
+    id_type logger_id;
+    string_view_type logger_name;
     message_type message;
+
+#if defined(LOGENCY_LATENCY)
+    using clock_type = std::chrono::steady_clock;
+
+    clock_type::time_point enqueued_at{};   //!< Stamped by the logger.
+    clock_type::time_point dispatched_at{}; //!< Stamped by the dispatcher.
+#endif
 };
 
 template <typename MessageType>
 inline message_pack_base<MessageType>::message_pack_base(
-    std::shared_ptr<string_type> &&logger, message_type &&message)
-    : logger_name{std::move(logger)}, message{std::move(message)}
+    id_type id, string_view_type logger, message_type &&message)
+    : logger_id{id}, logger_name{logger}, message{std::move(message)}
 {
 }
 
 template <typename MessageType>
 using message_pack = std::shared_ptr<message_pack_base<MessageType>>;
 
+/**
+ * \brief Create the message pack.
+ *
+ * The pack is allocated from a pool shared by every thread. It is usually
+ * freed by the sink thread and reused by the logging thread, so it does not
+ * hit the system allocator in steady state.
+ */
 template <typename MessageType, typename... Args>
 auto make_message_pack(
-    std::shared_ptr<typename MessageType::string_type> logger, Args &&...args)
-    -> message_pack<MessageType>
+    typename message_pack_base<MessageType>::id_type id,
+    typename message_pack_base<MessageType>::string_view_type logger,
+    Args &&...args) -> message_pack<MessageType>
 {
-    return std::make_shared<message_pack_base<MessageType>>(
-        std::move(logger), std::forward<Args>(args)...);
+    using allocator_type =
+        detail::memory::pool_allocator<message_pack_base<MessageType>>;
+
+    return std::allocate_shared<message_pack_base<MessageType>>(
+        allocator_type{}, id, logger, std::forward<Args>(args)...);
 }
 
 } // namespace logency
@@ -0,0 +1,129 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_STRING_NAME_REGISTRY_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_STRING_NAME_REGISTRY_HPP_
+
+#include "logency/core/exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace logency::detail::string
+{
+
+/**
+ * \brief This class represent the table of interned names.
+ *
+ * Each distinct name is stored once and given a small integer ID, in the order
+ * they are interned. The stored name is never moved nor released until the
+ * registry is destroyed, so the view returned by resolve() can be kept and
+ * passed across threads without any reference counting.
+ *
+ * This class is meant to be thread safe. Interning and resolving take a
+ * mutex, hence the callers are expected to keep the result instead of calling
+ * them in the critical path.
+ *
+ * \tparam StringType Stored string type.
+ */
+template <typename StringType>
+class name_registry
+{
+public:
+    using string_type = StringType;
+    using string_view_type =
+        std::basic_string_view<typename string_type::value_type,
+                               typename string_type::traits_type>;
+    using id_type = std::uint32_t;
+
+    /**
+     * \brief Get the ID of \a name. Store it if it is not interned yet.
+     *
+     * \throw logency::runtime_error if there is no ID left.
+     */
+    [[nodiscard]] auto intern(string_view_type name) -> id_type;
+
+    /**
+     * \brief Get the interned name of \a id.
+     *
+     * \throw logency::runtime_error if \a id is not given by this registry.
+     */
+    [[nodiscard]] auto resolve(id_type id) const -> string_view_type;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    using mutex_type = std::mutex;
+    template <typename MutexType>
+    using lock_type = std::scoped_lock<MutexType>;
+
+    /**
+     * `std::deque` never moves its elements when it grows at the end.
+     */
+    std::deque<string_type> names_{};
+
+    /**
+     * Keyed by the view of `names_`, so the lookup does not allocate.
+     */
+    std::unordered_map<string_view_type, id_type> ids_{};
+
+    mutable mutex_type mutex_{};
+};
+
+template <typename StringType>
+auto name_registry<StringType>::intern(string_view_type name) -> id_type
+{
+    lock_type<mutex_type> lock{mutex_};
+
+    if (auto where{ids_.find(name)}; where != ids_.end())
+    {
+        return where->second;
+    }
+
+    if (names_.size() > std::numeric_limits<id_type>::max())
+    {
+        throw logency::runtime_error("Too many names are interned.");
+    }
+
+    const auto id{static_cast<id_type>(names_.size())};
+    const auto &stored{names_.emplace_back(name)};
+
+    try
+    {
+        ids_.emplace(string_view_type{stored}, id);
+    }
+    catch (...)
+    {
+        names_.pop_back();
+        throw;
+    }
+
+    return id;
+}
+
+template <typename StringType>
+auto name_registry<StringType>::resolve(id_type id) const -> string_view_type
+{
+    lock_type<mutex_type> lock{mutex_};
+
+    if (id >= names_.size())
+    {
+        throw logency::runtime_error("No such name in the registry.");
+    }
+
+    return names_[id];
+}
+
+template <typename StringType>
+auto name_registry<StringType>::size() const -> std::size_t
+{
+    lock_type<mutex_type> lock{mutex_};
+    return names_.size();
+}
+
+} // namespace logency::detail::string
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_STRING_NAME_REGISTRY_HPP_
@@ -1,8 +1,13 @@
 #ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_B_Q_HPP_
 #define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_B_Q_HPP_
 
+#include "logency/core/overflow_policy.hpp"
+#include "logency/detail/thread/pair_queue_interface.hpp"
+
 #include <cassert>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <mutex>
 #include <vector>
@@ -10,19 +15,52 @@
 namespace logency::detail::thread
 {
 
+/**
+ * \brief This class represent the blocking pair queue.
+ *
+ * \par Bound
+ * The queue is unbounded by default. When it is bounded, the overflow_policy
+ * tells what to do with the incoming item pair while the queue is full.
+ *
+ * The producer never waits when the queue is empty at the beginning of the
+ * call, since the consumer is not notified yet. It keeps the item pair instead.
+ * So the queue might hold one batch more than its bound.
+ *
+ * \tparam T First item type.
+ * \tparam U Second item type.
+ */
 template <typename T, typename U>
-class blocking_pair_queue
+class blocking_pair_queue : public pair_queue_interface<T, U>
 {
+    using base_type = pair_queue_interface<T, U>;
+
 public:
-    using size_type = typename std::size_t;
-    using first_type = T;
-    using second_type = U;
+    using size_type = typename base_type::size_type;
+    using first_type = typename base_type::first_type;
+    using second_type = typename base_type::second_type;
 
     template <typename ItemType>
-    using container_type = std::vector<ItemType>;
+    using container_type =
+        typename base_type::template container_type<ItemType>;
+
+    using droppable_type = typename base_type::droppable_type;
 
     explicit blocking_pair_queue(size_type reserve_size = 0);
-    ~blocking_pair_queue();
+
+    /**
+     * \brief Initializes a new instance of the bounded blocking_pair_queue
+     * class.
+     *
+     * \param reserve_size Reserved capacity.
+     * \param max_size Maximum item pair count. \c 0 means unbounded.
+     * \param policy What to do when the queue is full.
+     * \param droppable Tell whether the item pair can be dropped. Only used by
+     * overflow_policy::drop_by_level. Item pair is kept if it is empty.
+     */
+    explicit blocking_pair_queue(size_type reserve_size, size_type max_size,
+                                 overflow_policy policy,
+                                 droppable_type droppable = {});
+    ~blocking_pair_queue() override;
 
     blocking_pair_queue(const blocking_pair_queue &other) = delete;
     blocking_pair_queue(blocking_pair_queue &&other) noexcept = delete;
@@ -31,35 +69,66 @@ public:
     auto operator=(blocking_pair_queue &&other) noexcept
         -> blocking_pair_queue & = delete;
 
-    void reserve(size_type size);
-    void shrink_to_fit();
+    void reserve(size_type size) override;
+    void shrink_to_fit() override;
 
     [[nodiscard]] bool enqueue(const first_type &first,
                                const second_type &second);
-    [[nodiscard]] bool enqueue(first_type &&first, second_type &&second);
+    [[nodiscard]] bool enqueue(first_type &&first,
+                               second_type &&second) override;
 
     template <typename TIterator, typename UIterator>
     [[nodiscard]] bool enqueue_bulk(TIterator first_begin, TIterator first_end,
                                     UIterator second_begin,
                                     UIterator second_end);
 
-    [[nodiscard]] bool try_swap_bulk(container_type<first_type> &first,
-                                     container_type<second_type> &second);
+    [[nodiscard]] bool
+    try_swap_bulk(container_type<first_type> &first,
+                  container_type<second_type> &second) override;
+
+    [[nodiscard]] auto capacity() -> size_type override;
+    [[nodiscard]] auto size() -> size_type override;
+    [[nodiscard]] bool is_empty() override;
+    [[nodiscard]] bool is_full();
+
+    /**
+     * \brief Maximum item pair count. \c 0 means unbounded.
+     */
+    [[nodiscard]] auto max_size() const noexcept -> size_type;
 
-    [[nodiscard]] auto capacity() -> size_type;
-    [[nodiscard]] auto size() -> size_type;
-    [[nodiscard]] bool is_empty();
+    [[nodiscard]] auto dropped() const noexcept -> size_type override;
 
 private:
     using mutex_type = std::mutex;
+    using condition_variable_type = std::condition_variable;
 
     template <typename MutexLock>
     using lock_type = std::scoped_lock<MutexLock>;
 
+    template <typename MutexLock>
+    using wait_lock_type = std::unique_lock<MutexLock>;
+
+    void push_inner(wait_lock_type<mutex_type> &lock, first_type &&first,
+                    second_type &&second, bool &should_notify);
+    void drop_front_inner();
+    void erase_front_inner();
+    void wait_for_space_inner(wait_lock_type<mutex_type> &lock,
+                              bool should_notify);
+
+    [[nodiscard]] bool is_full_inner() const noexcept;
+    [[nodiscard]] auto size_inner() const noexcept -> size_type;
+
     std::vector<first_type> first_buffer_{};
     std::vector<second_type> second_buffer_{};
+    size_type front_{0U}; //!< Items before it are dropped by drop_oldest.
+
+    const size_type max_size_{0U};
+    const overflow_policy policy_{overflow_policy::block};
+    droppable_type droppable_{};
+    std::atomic<size_type> dropped_{0U};
 
     mutex_type buffer_mutex_{};
+    condition_variable_type space_variable_{};
 };
 
 template <typename T, typename U>
@@ -71,6 +140,19 @@ blocking_pair_queue<T, U>::blocking_pair_queue(size_type reserve_size)
     assert(first_buffer_.size() == second_buffer_.size());
 }
 
+template <typename T, typename U>
+blocking_pair_queue<T, U>::blocking_pair_queue(size_type reserve_size,
+                                               size_type max_size,
+                                               overflow_policy policy,
+                                               droppable_type droppable)
+    : max_size_{max_size}, policy_{policy}, droppable_{std::move(droppable)}
+{
+    first_buffer_.reserve(reserve_size);
+    second_buffer_.reserve(reserve_size);
+
+    assert(first_buffer_.size() == second_buffer_.size());
+}
+
 template <typename T, typename U>
 blocking_pair_queue<T, U>::~blocking_pair_queue() = default;
 
@@ -83,13 +165,60 @@ auto blocking_pair_queue<T, U>::capacity() -> size_type
     return first_buffer_.capacity();
 }
 
+template <typename T, typename U>
+void blocking_pair_queue<T, U>::drop_front_inner()
+{
+    assert(front_ < first_buffer_.size());
+
+    first_buffer_[front_] = first_type{};
+    second_buffer_[front_] = second_type{};
+    ++front_;
+    dropped_.fetch_add(1U, std::memory_order_relaxed);
+
+    // Keep the dropped prefix small. Amortized O(1) per dropped item pair.
+    if (front_ >= max_size_)
+    {
+        erase_front_inner();
+    }
+}
+
+template <typename T, typename U>
+auto blocking_pair_queue<T, U>::dropped() const noexcept -> size_type
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename U>
+void blocking_pair_queue<T, U>::erase_front_inner()
+{
+    const auto offset{static_cast<std::ptrdiff_t>(front_)};
+
+    first_buffer_.erase(first_buffer_.begin(), first_buffer_.begin() + offset);
+    second_buffer_.erase(second_buffer_.begin(),
+                         second_buffer_.begin() + offset);
+    front_ = 0U;
+}
+
 template <typename T, typename U>
 bool blocking_pair_queue<T, U>::is_empty()
 {
     lock_type<mutex_type> buffer_lock{buffer_mutex_};
     assert(first_buffer_.size() == second_buffer_.size());
 
-    return first_buffer_.empty();
+    return size_inner() == 0U;
+}
+
+template <typename T, typename U>
+bool blocking_pair_queue<T, U>::is_full()
+{
+    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    return is_full_inner();
+}
+
+template <typename T, typename U>
+bool blocking_pair_queue<T, U>::is_full_inner() const noexcept
+{
+    return (max_size_ != 0U) && (size_inner() >= max_size_);
 }
 
 template <typename T, typename U>
@@ -103,13 +232,13 @@ template <typename T, typename U>
 bool blocking_pair_queue<T, U>::enqueue(first_type &&first,
                                         second_type &&second)
 {
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    wait_lock_type<mutex_type> buffer_lock{buffer_mutex_};
     assert(first_buffer_.size() == second_buffer_.size());
 
-    const auto should_notify{first_buffer_.empty()};
+    bool should_notify{false};
 
-    first_buffer_.push_back(std::move(first));
-    second_buffer_.push_back(std::move(second));
+    push_inner(buffer_lock, std::move(first), std::move(second),
+               should_notify);
 
     assert(first_buffer_.size() == second_buffer_.size());
 
@@ -123,19 +252,78 @@ bool blocking_pair_queue<T, U>::enqueue_bulk(TIterator first_begin,
                                              UIterator second_begin,
                                              UIterator second_end)
 {
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    wait_lock_type<mutex_type> buffer_lock{buffer_mutex_};
     assert(first_buffer_.size() == second_buffer_.size());
 
-    const auto should_notify{first_buffer_.empty()};
+    if (max_size_ == 0U)
+    {
+        const auto should_notify{size_inner() == 0U};
+
+        first_buffer_.insert(std::end(first_buffer_), first_begin, first_end);
+        second_buffer_.insert(std::end(second_buffer_), second_begin,
+                              second_end);
+
+        assert(first_buffer_.size() == second_buffer_.size());
 
-    first_buffer_.insert(std::end(first_buffer_), first_begin, first_end);
-    second_buffer_.insert(std::end(second_buffer_), second_begin, second_end);
+        return should_notify;
+    }
+
+    bool should_notify{false};
+
+    for (; (first_begin != first_end) && (second_begin != second_end);
+         ++first_begin, ++second_begin)
+    {
+        push_inner(buffer_lock, first_type{*first_begin},
+                   second_type{*second_begin}, should_notify);
+    }
 
     assert(first_buffer_.size() == second_buffer_.size());
 
     return should_notify;
 }
 
+template <typename T, typename U>
+auto blocking_pair_queue<T, U>::max_size() const noexcept -> size_type
+{
+    return max_size_;
+}
+
+template <typename T, typename U>
+void blocking_pair_queue<T, U>::push_inner(wait_lock_type<mutex_type> &lock,
+                                           first_type &&first,
+                                           second_type &&second,
+                                           bool &should_notify)
+{
+    if (is_full_inner())
+    {
+        switch (policy_)
+        {
+        case overflow_policy::drop_newest:
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        case overflow_policy::drop_oldest:
+            drop_front_inner();
+            break;
+        case overflow_policy::drop_by_level:
+            if (droppable_ && droppable_(first, second))
+            {
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            }
+            wait_for_space_inner(lock, should_notify);
+            break;
+        case overflow_policy::block:
+            wait_for_space_inner(lock, should_notify);
+            break;
+        }
+    }
+
+    should_notify = should_notify || (size_inner() == 0U);
+
+    first_buffer_.push_back(std::move(first));
+    second_buffer_.push_back(std::move(second));
+}
+
 template <typename T, typename U>
 void blocking_pair_queue<T, U>::reserve(size_type size)
 {
@@ -166,7 +354,13 @@ auto blocking_pair_queue<T, U>::size() -> size_type
     lock_type<mutex_type> buffer_lock{buffer_mutex_};
     assert(first_buffer_.size() == second_buffer_.size());
 
-    return first_buffer_.size();
+    return size_inner();
+}
+
+template <typename T, typename U>
+auto blocking_pair_queue<T, U>::size_inner() const noexcept -> size_type
+{
+    return first_buffer_.size() - front_;
 }
 
 template <typename T, typename U>
@@ -178,21 +372,46 @@ bool blocking_pair_queue<T, U>::try_swap_bulk(
         return false;
     }
 
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    {
+        lock_type<mutex_type> buffer_lock{buffer_mutex_};
 
-    assert(first_buffer_.size() == second_buffer_.size());
+        assert(first_buffer_.size() == second_buffer_.size());
+
+        if (size_inner() == 0U)
+        {
+            return false;
+        }
+
+        if (front_ != 0U)
+        {
+            erase_front_inner();
+        }
+
+        first_buffer_.swap(first);
+        second_buffer_.swap(second);
 
-    if (first_buffer_.empty())
+        assert(first_buffer_.size() == second_buffer_.size());
+    }
+
+    if (max_size_ != 0U)
     {
-        return false;
+        space_variable_.notify_all();
     }
 
-    first_buffer_.swap(first);
-    second_buffer_.swap(second);
+    return true;
+}
 
-    assert(first_buffer_.size() == second_buffer_.size());
+template <typename T, typename U>
+void blocking_pair_queue<T, U>::wait_for_space_inner(
+    wait_lock_type<mutex_type> &lock, bool should_notify)
+{
+    // Nobody is notified to consume it yet. Waiting here never ends.
+    if (should_notify || (size_inner() == 0U))
+    {
+        return;
+    }
 
-    return true;
+    space_variable_.wait(lock, [this] { return !is_full_inner(); });
 }
 
 } // namespace logency::detail::thread
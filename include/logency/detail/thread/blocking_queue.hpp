@@ -1,14 +1,33 @@
 #ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_BLOCKING_QUEUE_HPP_
 #define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_BLOCKING_QUEUE_HPP_
 
+#include "logency/core/overflow_policy.hpp"
+
 #include <cassert>
+#include <cstddef>
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <vector>
 
 namespace logency::detail::thread
 {
 
+/**
+ * \brief This class represent the blocking queue.
+ *
+ * \par Bound
+ * The queue is unbounded by default. When it is bounded, the overflow_policy
+ * tells what to do with the incoming item while the queue is full.
+ *
+ * The producer never waits when the queue is empty at the beginning of the
+ * call, since the consumer is not notified yet. It keeps the item instead. So
+ * the queue might hold one batch more than its bound.
+ *
+ * \tparam T Item type.
+ */
 template <typename T>
 class blocking_queue
 {
@@ -19,7 +38,27 @@ public:
     template <typename ItemType>
     using container_type = std::vector<ItemType>;
 
+    using droppable_type = std::function<bool(const value_type &)>;
+    using full_handler_type = std::function<void()>;
+
     explicit blocking_queue(size_type reserve_size = 0);
+
+    /**
+     * \brief Initializes a new instance of the bounded blocking_queue class.
+     *
+     * \param reserve_size Reserved capacity.
+     * \param max_size Maximum item count. \c 0 means unbounded.
+     * \param policy What to do when the queue is full.
+     * \param droppable Tell whether the item can be dropped. Only used by
+     * overflow_policy::drop_by_level. Item is kept if it is empty.
+     * \param full_handler Called without lock instead of waiting, until the
+     * queue is not full. Use it when the producer may be the thread which
+     * should consume the queue.
+     */
+    explicit blocking_queue(size_type reserve_size, size_type max_size,
+                            overflow_policy policy,
+                            droppable_type droppable = {},
+                            full_handler_type full_handler = {});
     ~blocking_queue();
 
     blocking_queue(const blocking_queue &other) = delete;
@@ -42,15 +81,56 @@ public:
     [[nodiscard]] auto capacity() -> size_type;
     [[nodiscard]] auto size() -> size_type;
     [[nodiscard]] bool is_empty();
+    [[nodiscard]] bool is_full();
+
+    /**
+     * \brief Maximum item count. \c 0 means unbounded.
+     */
+    [[nodiscard]] auto max_size() const noexcept -> size_type;
+
+    /**
+     * \brief Count of the items dropped by the overflow policy.
+     */
+    [[nodiscard]] auto dropped() const noexcept -> size_type;
+
+    /**
+     * \brief Maximum item count the queue ever held. Lock free.
+     */
+    [[nodiscard]] auto high_water() const noexcept -> size_type;
 
 private:
     using mutex_type = std::mutex;
+    using condition_variable_type = std::condition_variable;
 
     template <typename MutexLock>
     using lock_type = std::scoped_lock<MutexLock>;
 
+    template <typename MutexLock>
+    using wait_lock_type = std::unique_lock<MutexLock>;
+
+    void push_inner(wait_lock_type<mutex_type> &lock, value_type &&value,
+                    bool &should_notify);
+    void drop_front_inner();
+    void wait_for_space_inner(wait_lock_type<mutex_type> &lock,
+                              bool should_notify);
+
+    void update_high_water_inner() noexcept;
+
+    [[nodiscard]] bool is_full_inner() const noexcept;
+    [[nodiscard]] auto size_inner() const noexcept -> size_type;
+
     container_type<value_type> buffer_{};
+    size_type front_{0U}; //!< Items before it are dropped by drop_oldest.
+
+    const size_type max_size_{0U};
+    const overflow_policy policy_{overflow_policy::block};
+    droppable_type droppable_{};
+    full_handler_type full_handler_{};
+    std::atomic<size_type> dropped_{0U};
+    std::atomic<size_type> high_water_{0U}; //!< Written under `buffer_mutex_`.
+
     mutex_type buffer_mutex_{};
+    condition_variable_type space_variable_{};
 };
 
 template <typename T>
@@ -59,6 +139,17 @@ blocking_queue<T>::blocking_queue(size_type reserve_size)
     buffer_.reserve(reserve_size);
 }
 
+template <typename T>
+blocking_queue<T>::blocking_queue(size_type reserve_size, size_type max_size,
+                                  overflow_policy policy,
+                                  droppable_type droppable,
+                                  full_handler_type full_handler)
+    : max_size_{max_size}, policy_{policy}, droppable_{std::move(droppable)},
+      full_handler_{std::move(full_handler)}
+{
+    buffer_.reserve(reserve_size);
+}
+
 template <typename T>
 blocking_queue<T>::~blocking_queue() = default;
 
@@ -69,11 +160,54 @@ auto blocking_queue<T>::capacity() -> size_type
     return buffer_.capacity();
 }
 
+template <typename T>
+void blocking_queue<T>::drop_front_inner()
+{
+    assert(front_ < buffer_.size());
+
+    buffer_[front_] = value_type{};
+    ++front_;
+    dropped_.fetch_add(1U, std::memory_order_relaxed);
+
+    // Keep the dropped prefix small. Amortized O(1) per dropped item.
+    if (front_ >= max_size_)
+    {
+        buffer_.erase(buffer_.begin(),
+                      buffer_.begin() + static_cast<std::ptrdiff_t>(front_));
+        front_ = 0U;
+    }
+}
+
+template <typename T>
+auto blocking_queue<T>::dropped() const noexcept -> size_type
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+auto blocking_queue<T>::high_water() const noexcept -> size_type
+{
+    return high_water_.load(std::memory_order_relaxed);
+}
+
 template <typename T>
 bool blocking_queue<T>::is_empty()
 {
     lock_type<mutex_type> buffer_lock{buffer_mutex_};
-    return buffer_.empty();
+    return size_inner() == 0U;
+}
+
+template <typename T>
+bool blocking_queue<T>::is_full()
+{
+    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    return is_full_inner();
+}
+
+template <typename T>
+bool blocking_queue<T>::is_full_inner() const noexcept
+{
+    return (max_size_ != 0U) && (size_inner() >= max_size_);
 }
 
 template <typename T>
@@ -85,11 +219,12 @@ bool blocking_queue<T>::enqueue(const value_type &value)
 template <typename T>
 bool blocking_queue<T>::enqueue(value_type &&value)
 {
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    wait_lock_type<mutex_type> buffer_lock{buffer_mutex_};
 
-    const auto should_notify{buffer_.empty()};
+    bool should_notify{false};
 
-    buffer_.push_back(std::move(value));
+    push_inner(buffer_lock, std::move(value), should_notify);
+    update_high_water_inner();
 
     return should_notify;
 }
@@ -98,15 +233,69 @@ template <typename T>
 template <typename Iterator>
 bool blocking_queue<T>::enqueue_bulk(Iterator begin, Iterator end)
 {
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
+    wait_lock_type<mutex_type> buffer_lock{buffer_mutex_};
+
+    if (max_size_ == 0U)
+    {
+        const auto should_notify{size_inner() == 0U};
+
+        buffer_.insert(std::end(buffer_), begin, end);
+        update_high_water_inner();
+
+        return should_notify;
+    }
 
-    const auto should_notify{buffer_.empty()};
+    bool should_notify{false};
 
-    buffer_.insert(std::end(buffer_), begin, end);
+    for (; begin != end; ++begin)
+    {
+        push_inner(buffer_lock, value_type{*begin}, should_notify);
+    }
+
+    update_high_water_inner();
 
     return should_notify;
 }
 
+template <typename T>
+auto blocking_queue<T>::max_size() const noexcept -> size_type
+{
+    return max_size_;
+}
+
+template <typename T>
+void blocking_queue<T>::push_inner(wait_lock_type<mutex_type> &lock,
+                                   value_type &&value, bool &should_notify)
+{
+    if (is_full_inner())
+    {
+        switch (policy_)
+        {
+        case overflow_policy::drop_newest:
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        case overflow_policy::drop_oldest:
+            drop_front_inner();
+            break;
+        case overflow_policy::drop_by_level:
+            if (droppable_ && droppable_(value))
+            {
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            }
+            wait_for_space_inner(lock, should_notify);
+            break;
+        case overflow_policy::block:
+            wait_for_space_inner(lock, should_notify);
+            break;
+        }
+    }
+
+    should_notify = should_notify || (size_inner() == 0U);
+
+    buffer_.push_back(std::move(value));
+}
+
 template <typename T>
 void blocking_queue<T>::reserve(size_type size)
 {
@@ -125,23 +314,80 @@ template <typename T>
 auto blocking_queue<T>::size() -> size_type
 {
     lock_type<mutex_type> buffer_lock{buffer_mutex_};
-    return buffer_.size();
+    return size_inner();
+}
+
+template <typename T>
+auto blocking_queue<T>::size_inner() const noexcept -> size_type
+{
+    return buffer_.size() - front_;
 }
 
 template <typename T>
 bool blocking_queue<T>::try_swap_bulk(container_type<value_type> &out)
 {
-    lock_type<mutex_type> buffer_lock{buffer_mutex_};
-    if (buffer_.empty())
     {
-        return false;
+        lock_type<mutex_type> buffer_lock{buffer_mutex_};
+        if (size_inner() == 0U)
+        {
+            return false;
+        }
+
+        if (front_ != 0U)
+        {
+            buffer_.erase(buffer_.begin(),
+                          buffer_.begin() +
+                              static_cast<std::ptrdiff_t>(front_));
+            front_ = 0U;
+        }
+
+        buffer_.swap(out);
     }
 
-    buffer_.swap(out);
+    if (max_size_ != 0U)
+    {
+        space_variable_.notify_all();
+    }
 
     return true;
 }
 
+template <typename T>
+void blocking_queue<T>::update_high_water_inner() noexcept
+{
+    if (const auto size{size_inner()};
+        size > high_water_.load(std::memory_order_relaxed))
+    {
+        high_water_.store(size, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+void blocking_queue<T>::wait_for_space_inner(wait_lock_type<mutex_type> &lock,
+                                             bool should_notify)
+{
+    if (full_handler_)
+    {
+        // Other producers may fill the space before the lock is taken back.
+        while (is_full_inner())
+        {
+            lock.unlock();
+            full_handler_();
+            lock.lock();
+        }
+
+        return;
+    }
+
+    // Nobody is notified to consume it yet. Waiting here never ends.
+    if (should_notify || (size_inner() == 0U))
+    {
+        return;
+    }
+
+    space_variable_.wait(lock, [this] { return !is_full_inner(); });
+}
+
 } // namespace logency::detail::thread
 
 #endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_BLOCKING_QUEUE_HPP_
@@ -0,0 +1,16 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_CACHE_LINE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_CACHE_LINE_HPP_
+
+#include <cstddef>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief Assumed cache line size. Used to keep hot atomics apart.
+ */
+constexpr const std::size_t cache_line_size{64U};
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_CACHE_LINE_HPP_
@@ -0,0 +1,75 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_PAIR_QUEUE_INTERFACE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_PAIR_QUEUE_INTERFACE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the common interface of the pair queue.
+ *
+ * The dispatcher only knows this interface. It lets the manager decide which
+ * queue implementation the dispatcher should use.
+ *
+ * \par Consumer
+ * try_swap_bulk() is called by one consumer at a time. The implementation is
+ * free to rely on it.
+ *
+ * \tparam T First item type.
+ * \tparam U Second item type.
+ */
+template <typename T, typename U>
+class pair_queue_interface
+{
+public:
+    using size_type = typename std::size_t;
+    using first_type = T;
+    using second_type = U;
+
+    template <typename ItemType>
+    using container_type = std::vector<ItemType>;
+
+    /**
+     * \brief Tell whether the item pair can be dropped when the queue is full.
+     */
+    using droppable_type =
+        std::function<bool(const first_type &, const second_type &)>;
+
+    virtual ~pair_queue_interface() = default;
+
+    virtual void reserve(size_type size) = 0;
+    virtual void shrink_to_fit() = 0;
+
+    /**
+     * \brief Enqueue the item pair.
+     *
+     * \return \c true if the consumer should be notified.
+     */
+    [[nodiscard]] virtual bool enqueue(first_type &&first,
+                                       second_type &&second) = 0;
+
+    /**
+     * \brief Move every available item pair into \a first and \a second.
+     *
+     * \return \c true if any item is moved out.
+     */
+    [[nodiscard]] virtual bool
+    try_swap_bulk(container_type<first_type> &first,
+                  container_type<second_type> &second) = 0;
+
+    [[nodiscard]] virtual auto capacity() -> size_type = 0;
+    [[nodiscard]] virtual auto size() -> size_type = 0;
+    [[nodiscard]] virtual bool is_empty() = 0;
+
+    /**
+     * \brief Count of the item pairs dropped by the overflow policy.
+     */
+    [[nodiscard]] virtual auto dropped() const noexcept -> size_type = 0;
+};
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_PAIR_QUEUE_INTERFACE_HPP_
@@ -0,0 +1,345 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_RING_PAIR_QUEUE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_RING_PAIR_QUEUE_HPP_
+
+#include "logency/core/exception.hpp"
+#include "logency/core/overflow_policy.hpp"
+#include "logency/detail/thread/cache_line.hpp"
+#include "logency/detail/thread/pair_queue_interface.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the bounded lock-free multi-producer
+ * single-consumer pair queue.
+ *
+ * Every slot carries a sequence number telling whether it is ready to be
+ * written or to be read (Dmitry Vyukov's bounded queue). Producers claim a
+ * slot with a single CAS on the enqueue position, so producers never wait for
+ * each other unless the queue is full.
+ *
+ * \par Full queue
+ * With overflow_policy::block, the producer yields until the consumer frees a
+ * slot. Do not produce from the consumer thread when the queue might be full.
+ * overflow_policy::drop_newest and overflow_policy::drop_by_level drop the
+ * incoming item pair instead. overflow_policy::drop_oldest is not supported,
+ * since producers cannot take a slot back from the consumer.
+ *
+ * \par Notification
+ * The queue remember whether the consumer has been notified. enqueue() returns
+ * \c true only for the first item after the consumer started to drain, which
+ * keeps the same contract as blocking_pair_queue.
+ *
+ * \tparam T First item type. Should be default constructible.
+ * \tparam U Second item type. Should be default constructible.
+ */
+template <typename T, typename U>
+class ring_pair_queue : public pair_queue_interface<T, U>
+{
+    using base_type = pair_queue_interface<T, U>;
+
+public:
+    using size_type = typename base_type::size_type;
+    using first_type = typename base_type::first_type;
+    using second_type = typename base_type::second_type;
+
+    template <typename ItemType>
+    using container_type =
+        typename base_type::template container_type<ItemType>;
+
+    using droppable_type = typename base_type::droppable_type;
+
+    static constexpr const size_type default_capacity{size_type{1U} << 16U};
+
+    /**
+     * \brief Initializes a new instance of the ring_pair_queue class.
+     *
+     * \param capacity Requested capacity. It will be rounded up to the power
+     * of two. Use default capacity if it is \c 0.
+     */
+    explicit ring_pair_queue(size_type capacity = default_capacity);
+
+    /**
+     * \brief Initializes a new instance of the ring_pair_queue class.
+     *
+     * \param capacity Requested capacity. It will be rounded up to the power
+     * of two. Use default capacity if it is \c 0.
+     * \param policy What to do when the queue is full.
+     * \param droppable Tell whether the item pair can be dropped. Only used by
+     * overflow_policy::drop_by_level. Item pair is kept if it is empty.
+     *
+     * \exception logency::runtime_error Policy is not supported.
+     */
+    explicit ring_pair_queue(size_type capacity, overflow_policy policy,
+                             droppable_type droppable = {});
+    ~ring_pair_queue() override;
+
+    ring_pair_queue(const ring_pair_queue &other) = delete;
+    ring_pair_queue(ring_pair_queue &&other) noexcept = delete;
+    auto operator=(const ring_pair_queue &other) -> ring_pair_queue & = delete;
+    auto operator=(ring_pair_queue &&other) noexcept
+        -> ring_pair_queue & = delete;
+
+    /**
+     * \brief Do nothing. The capacity is fixed on construction.
+     */
+    void reserve(size_type size) override;
+
+    /**
+     * \brief Do nothing. The capacity is fixed on construction.
+     */
+    void shrink_to_fit() override;
+
+    [[nodiscard]] bool enqueue(first_type &&first,
+                               second_type &&second) override;
+
+    /**
+     * \brief Append every ready item pair into \a first and \a second.
+     *
+     * \warning Single consumer only.
+     */
+    [[nodiscard]] bool
+    try_swap_bulk(container_type<first_type> &first,
+                  container_type<second_type> &second) override;
+
+    [[nodiscard]] auto capacity() -> size_type override;
+    [[nodiscard]] auto size() -> size_type override;
+    [[nodiscard]] bool is_empty() override;
+    [[nodiscard]] auto dropped() const noexcept -> size_type override;
+
+private:
+    struct slot
+    {
+        std::atomic<size_type> sequence{0U};
+        first_type first{};
+        second_type second{};
+    };
+
+    static auto round_up_capacity(size_type capacity) -> size_type;
+
+    [[nodiscard]] bool should_drop(const first_type &first,
+                                   const second_type &second) const;
+
+    const size_type mask_;
+    std::unique_ptr<slot[]> slots_; // NOLINT(*-avoid-c-arrays)
+
+    alignas(cache_line_size) std::atomic<size_type> enqueue_position_{0U};
+    alignas(cache_line_size) std::atomic<size_type> dequeue_position_{0U};
+    alignas(cache_line_size) std::atomic<bool> is_notified_{false};
+
+    const overflow_policy policy_{overflow_policy::block};
+    droppable_type droppable_{};
+    std::atomic<size_type> dropped_{0U};
+};
+
+template <typename T, typename U>
+ring_pair_queue<T, U>::ring_pair_queue(size_type capacity)
+    : ring_pair_queue(capacity, overflow_policy::block)
+{
+}
+
+template <typename T, typename U>
+ring_pair_queue<T, U>::ring_pair_queue(size_type capacity,
+                                       overflow_policy policy,
+                                       droppable_type droppable)
+    : mask_{round_up_capacity(capacity) - 1U},
+      slots_{std::make_unique<slot[]>(mask_ + 1U)}, // NOLINT(*-c-arrays)
+      policy_{policy}, droppable_{std::move(droppable)}
+{
+    if (policy_ == overflow_policy::drop_oldest)
+    {
+        throw logency::runtime_error(
+            "Overflow policy is not supported by this queue.");
+    }
+
+    for (size_type index{0U}; index <= mask_; ++index)
+    {
+        slots_[index].sequence.store(index, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename U>
+ring_pair_queue<T, U>::~ring_pair_queue() = default;
+
+template <typename T, typename U>
+auto ring_pair_queue<T, U>::capacity() -> size_type
+{
+    return mask_ + 1U;
+}
+
+template <typename T, typename U>
+auto ring_pair_queue<T, U>::dropped() const noexcept -> size_type
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename U>
+bool ring_pair_queue<T, U>::enqueue(first_type &&first, second_type &&second)
+{
+    auto position{enqueue_position_.load(std::memory_order_relaxed)};
+    slot *target{nullptr};
+
+    for (;;)
+    {
+        target = &slots_[position & mask_];
+
+        const auto sequence{target->sequence.load(std::memory_order_acquire)};
+        const auto difference{static_cast<std::ptrdiff_t>(sequence) -
+                              static_cast<std::ptrdiff_t>(position)};
+
+        if (difference == 0)
+        {
+            if (enqueue_position_.compare_exchange_weak(
+                    position, position + 1U, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            if (should_drop(first, second))
+            {
+                // Nothing is enqueued, so nobody has to be notified.
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+                return false;
+            }
+
+            // Full. Let the consumer catch up.
+            std::this_thread::yield();
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    target->first = std::move(first);
+    target->second = std::move(second);
+    target->sequence.store(position + 1U, std::memory_order_release);
+
+    /**
+     * Pairs with the exchange in try_swap_bulk(). Either the consumer sees
+     * this item in the current drain, or this producer notifies it again.
+     */
+    return !is_notified_.exchange(true, std::memory_order_acq_rel);
+}
+
+template <typename T, typename U>
+bool ring_pair_queue<T, U>::is_empty()
+{
+    return size() == 0U;
+}
+
+template <typename T, typename U>
+void ring_pair_queue<T, U>::reserve(size_type /*size*/)
+{
+}
+
+template <typename T, typename U>
+auto ring_pair_queue<T, U>::round_up_capacity(size_type capacity) -> size_type
+{
+    if (capacity == 0U)
+    {
+        return default_capacity;
+    }
+
+    size_type result{1U};
+
+    while (result < capacity)
+    {
+        if (result > (~size_type{0U} >> 1U))
+        {
+            throw logency::runtime_error("Requested capacity is too large.");
+        }
+
+        result <<= 1U;
+    }
+
+    // At least 2 slots. Sequence of a single slot cannot tell empty from full.
+    return (result < 2U) ? 2U : result;
+}
+
+template <typename T, typename U>
+bool ring_pair_queue<T, U>::should_drop(const first_type &first,
+                                        const second_type &second) const
+{
+    switch (policy_)
+    {
+    case overflow_policy::drop_newest:
+        return true;
+    case overflow_policy::drop_by_level:
+        return droppable_ && droppable_(first, second);
+    default:
+        return false;
+    }
+}
+
+template <typename T, typename U>
+void ring_pair_queue<T, U>::shrink_to_fit()
+{
+}
+
+template <typename T, typename U>
+auto ring_pair_queue<T, U>::size() -> size_type
+{
+    const auto tail{dequeue_position_.load(std::memory_order_acquire)};
+    const auto head{enqueue_position_.load(std::memory_order_acquire)};
+
+    // Claimed but not yet published slots are counted as well.
+    return (head > tail) ? (head - tail) : 0U;
+}
+
+template <typename T, typename U>
+bool ring_pair_queue<T, U>::try_swap_bulk(container_type<first_type> &first,
+                                          container_type<second_type> &second)
+{
+    if (first.size() != second.size())
+    {
+        return false;
+    }
+
+    is_notified_.exchange(false, std::memory_order_acq_rel);
+
+    auto position{dequeue_position_.load(std::memory_order_relaxed)};
+    const auto origin{position};
+
+    for (;;)
+    {
+        auto &source{slots_[position & mask_]};
+
+        if (source.sequence.load(std::memory_order_acquire) != position + 1U)
+        {
+            break; // Not published yet.
+        }
+
+        first.push_back(std::move(source.first));
+        second.push_back(std::move(source.second));
+
+        source.first = first_type{};
+        source.second = second_type{};
+
+        source.sequence.store(position + mask_ + 1U,
+                              std::memory_order_release);
+        ++position;
+    }
+
+    dequeue_position_.store(position, std::memory_order_release);
+
+    assert(first.size() == second.size());
+
+    return position != origin;
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_RING_PAIR_QUEUE_HPP_
@@ -0,0 +1,169 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_SNAPSHOT_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_SNAPSHOT_HPP_
+
+#include "logency/detail/thread/cache_line.hpp"
+
+#include <cassert>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the immutable value which is replaced as a
+ * whole, in the RCU (read-copy-update) style.
+ *
+ * Readers never take a lock. They load the current value and count themselves
+ * in the current epoch. A writer publishes a new value, flips the epoch, and
+ * waits until the readers of the previous epoch leave before it deletes the
+ * old value. Hence reading is cheap and never waits for a writer, while
+ * writing waits for the readers.
+ *
+ * \par Writer
+ * update() should be serialized by the caller.
+ *
+ * \tparam T Value type.
+ */
+template <typename T>
+class snapshot
+{
+public:
+    using value_type = T;
+
+    /**
+     * \brief This class represent the read-side critical section.
+     *
+     * The value it refers to is kept until it is destroyed.
+     */
+    class read_guard
+    {
+    public:
+        read_guard(const read_guard &other) = delete;
+        read_guard(read_guard &&other) noexcept = delete;
+        auto operator=(const read_guard &other) -> read_guard & = delete;
+        auto operator=(read_guard &&other) noexcept -> read_guard & = delete;
+
+        ~read_guard();
+
+        [[nodiscard]] auto operator*() const noexcept -> const value_type &;
+        [[nodiscard]] auto operator->() const noexcept -> const value_type *;
+
+    private:
+        friend snapshot;
+
+        explicit read_guard(const snapshot &owner) noexcept;
+
+        const snapshot &owner_;
+        unsigned epoch_;
+        const value_type *value_;
+    };
+
+    explicit snapshot(std::unique_ptr<const value_type> value) noexcept;
+    ~snapshot();
+
+    snapshot(const snapshot &other) = delete;
+    snapshot(snapshot &&other) noexcept = delete;
+    auto operator=(const snapshot &other) -> snapshot & = delete;
+    auto operator=(snapshot &&other) noexcept -> snapshot & = delete;
+
+    /**
+     * \brief Enter the read-side critical section.
+     */
+    [[nodiscard]] auto read() const noexcept -> read_guard;
+
+    /**
+     * \brief Publish \a value and delete the previous one once no reader
+     * refers to it.
+     */
+    void update(std::unique_ptr<const value_type> value);
+
+private:
+    std::atomic<const value_type *> value_;
+
+    alignas(cache_line_size) mutable std::atomic<unsigned> epoch_{0U};
+    alignas(cache_line_size) mutable std::array<std::atomic<int>, 2U>
+        readers_{};
+};
+
+template <typename T>
+snapshot<T>::read_guard::read_guard(const snapshot &owner) noexcept
+    : owner_{owner}, epoch_{0U}, value_{nullptr}
+{
+    for (;;)
+    {
+        epoch_ = owner_.epoch_.load();
+        owner_.readers_[epoch_ & 1U].fetch_add(1);
+
+        // Counted in the epoch the writer is going to wait for.
+        if (owner_.epoch_.load() == epoch_)
+        {
+            break;
+        }
+
+        owner_.readers_[epoch_ & 1U].fetch_sub(1);
+    }
+
+    value_ = owner_.value_.load();
+}
+
+template <typename T>
+snapshot<T>::read_guard::~read_guard()
+{
+    owner_.readers_[epoch_ & 1U].fetch_sub(1, std::memory_order_release);
+}
+
+template <typename T>
+auto snapshot<T>::read_guard::operator*() const noexcept -> const value_type &
+{
+    return *value_;
+}
+
+template <typename T>
+auto snapshot<T>::read_guard::operator->() const noexcept -> const value_type *
+{
+    return value_;
+}
+
+template <typename T>
+snapshot<T>::snapshot(std::unique_ptr<const value_type> value) noexcept
+    : value_{value.release()}
+{
+    assert(value_.load() != nullptr);
+}
+
+template <typename T>
+snapshot<T>::~snapshot()
+{
+    delete value_.load(); // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+template <typename T>
+auto snapshot<T>::read() const noexcept -> read_guard
+{
+    return read_guard{*this};
+}
+
+template <typename T>
+void snapshot<T>::update(std::unique_ptr<const value_type> value)
+{
+    assert(value);
+
+    const std::unique_ptr<const value_type> previous{
+        value_.exchange(value.release())};
+
+    // New readers count themselves in the next epoch, and see the new value.
+    const auto epoch{epoch_.fetch_add(1U)};
+
+    while (readers_[epoch & 1U].load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_SNAPSHOT_HPP_
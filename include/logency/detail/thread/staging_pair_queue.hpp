@@ -0,0 +1,592 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STAGING_PAIR_QUEUE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STAGING_PAIR_QUEUE_HPP_
+
+#include "logency/core/exception.hpp"
+#include "logency/core/overflow_policy.hpp"
+#include "logency/detail/thread/cache_line.hpp"
+#include "logency/detail/thread/pair_queue_interface.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the pair queue with one staging buffer per
+ * producer thread.
+ *
+ * Each producing thread gets its own bounded single-producer single-consumer
+ * ring on its first enqueue(). The ring is registered in the queue, and
+ * try_swap_bulk() drains every registered ring. Producers never write to a
+ * cache line that other producers write to.
+ *
+ * \par Order
+ * Items of the same producer keep their order. Items of different producers
+ * are drained ring by ring, they are not ordered against each other.
+ *
+ * \par Full buffer
+ * With overflow_policy::block, the producer yields until the consumer frees a
+ * slot. Do not produce from the consumer thread when the buffer might be full.
+ * overflow_policy::drop_newest and overflow_policy::drop_by_level drop the
+ * incoming item pair instead. overflow_policy::drop_oldest is not supported,
+ * since the producer cannot take a slot back from the consumer.
+ *
+ * \par Thread exit
+ * The buffer of an exited thread is kept until the consumer drains it.
+ *
+ * \tparam T First item type. Should be default constructible.
+ * \tparam U Second item type. Should be default constructible.
+ */
+template <typename T, typename U>
+class staging_pair_queue : public pair_queue_interface<T, U>
+{
+    using base_type = pair_queue_interface<T, U>;
+
+public:
+    using size_type = typename base_type::size_type;
+    using first_type = typename base_type::first_type;
+    using second_type = typename base_type::second_type;
+
+    template <typename ItemType>
+    using container_type =
+        typename base_type::template container_type<ItemType>;
+
+    using droppable_type = typename base_type::droppable_type;
+
+    static constexpr const size_type default_capacity{size_type{1U} << 12U};
+
+    /**
+     * \brief Initializes a new instance of the staging_pair_queue class.
+     *
+     * \param capacity Requested capacity of *each* staging buffer. It will be
+     * rounded up to the power of two. Use default capacity if it is \c 0.
+     */
+    explicit staging_pair_queue(size_type capacity = default_capacity);
+
+    /**
+     * \brief Initializes a new instance of the staging_pair_queue class.
+     *
+     * \param capacity Requested capacity of *each* staging buffer. It will be
+     * rounded up to the power of two. Use default capacity if it is \c 0.
+     * \param policy What to do when the buffer is full.
+     * \param droppable Tell whether the item pair can be dropped. Only used by
+     * overflow_policy::drop_by_level. Item pair is kept if it is empty.
+     *
+     * \exception logency::runtime_error Policy is not supported.
+     */
+    explicit staging_pair_queue(size_type capacity, overflow_policy policy,
+                                droppable_type droppable = {});
+    ~staging_pair_queue() override;
+
+    staging_pair_queue(const staging_pair_queue &other) = delete;
+    staging_pair_queue(staging_pair_queue &&other) noexcept = delete;
+    auto operator=(const staging_pair_queue &other)
+        -> staging_pair_queue & = delete;
+    auto operator=(staging_pair_queue &&other) noexcept
+        -> staging_pair_queue & = delete;
+
+    /**
+     * \brief Do nothing. The capacity is fixed on construction.
+     */
+    void reserve(size_type size) override;
+
+    /**
+     * \brief Do nothing. The capacity is fixed on construction.
+     */
+    void shrink_to_fit() override;
+
+    [[nodiscard]] bool enqueue(first_type &&first,
+                               second_type &&second) override;
+
+    /**
+     * \brief Append every ready item pair of every staging buffer into \a
+     * first and \a second.
+     *
+     * \warning Single consumer only.
+     */
+    [[nodiscard]] bool
+    try_swap_bulk(container_type<first_type> &first,
+                  container_type<second_type> &second) override;
+
+    /**
+     * \brief Total capacity of the registered staging buffers.
+     */
+    [[nodiscard]] auto capacity() -> size_type override;
+    [[nodiscard]] auto size() -> size_type override;
+    [[nodiscard]] bool is_empty() override;
+    [[nodiscard]] auto dropped() const noexcept -> size_type override;
+
+    /**
+     * \brief Capacity of each staging buffer.
+     */
+    [[nodiscard]] auto buffer_capacity() const noexcept -> size_type;
+
+    /**
+     * \brief Number of the registered staging buffers.
+     */
+    [[nodiscard]] auto buffer_count() -> size_type;
+
+private:
+    using mutex_type = std::mutex;
+
+    template <typename Mutex>
+    using lock_type = std::scoped_lock<Mutex>;
+
+    using id_type = std::uint64_t;
+
+    class staging_buffer
+    {
+    public:
+        explicit staging_buffer(size_type capacity);
+
+        [[nodiscard]] bool enqueue(first_type &&first, second_type &&second);
+        [[nodiscard]] bool drain(container_type<first_type> &first,
+                                 container_type<second_type> &second);
+
+        [[nodiscard]] auto size() const noexcept -> size_type;
+
+        /**
+         * \brief Tell whether the buffer is full. Producer only.
+         */
+        [[nodiscard]] bool is_full() noexcept;
+
+        void mark_as_orphaned() noexcept;
+        [[nodiscard]] bool is_orphaned() const noexcept;
+
+    private:
+        struct slot
+        {
+            first_type first{};
+            second_type second{};
+        };
+
+        const size_type mask_;
+        std::unique_ptr<slot[]> slots_; // NOLINT(*-avoid-c-arrays)
+
+        // Written by the producer only.
+        alignas(cache_line_size) std::atomic<size_type> head_{0U};
+        size_type cached_tail_{0U};
+
+        // Written by the consumer only.
+        alignas(cache_line_size) std::atomic<size_type> tail_{0U};
+
+        alignas(cache_line_size) std::atomic<bool> is_notified_{false};
+        std::atomic<bool> is_orphaned_{false};
+    };
+
+    using buffer_pointer = std::shared_ptr<staging_buffer>;
+
+    /**
+     * Buffers used by the current thread, one per queue it has produced into.
+     *
+     * The raw pointer is used by the fast path. It is valid as long as the
+     * queue is alive, since the queue never drops the buffer of a live thread.
+     */
+    struct producer_entry
+    {
+        id_type queue_id;
+        staging_buffer *buffer;
+        std::weak_ptr<staging_buffer> owner;
+    };
+
+    struct producer_registry
+    {
+        producer_registry() = default;
+        ~producer_registry();
+
+        producer_registry(const producer_registry &other) = delete;
+        producer_registry(producer_registry &&other) noexcept = delete;
+        auto operator=(const producer_registry &other)
+            -> producer_registry & = delete;
+        auto operator=(producer_registry &&other) noexcept
+            -> producer_registry & = delete;
+
+        std::vector<producer_entry> entries{};
+    };
+
+    static auto next_id() -> id_type;
+    static auto local_registry() -> producer_registry &;
+    static auto round_up_capacity(size_type capacity) -> size_type;
+
+    auto local_buffer() -> staging_buffer *;
+    auto register_buffer(producer_registry &registry) -> staging_buffer *;
+
+    [[nodiscard]] bool should_drop(const first_type &first,
+                                   const second_type &second) const;
+
+    const id_type id_;
+    const size_type buffer_capacity_;
+
+    const overflow_policy policy_{overflow_policy::block};
+    droppable_type droppable_{};
+    std::atomic<size_type> dropped_{0U};
+
+    std::vector<buffer_pointer> buffers_{};
+    mutex_type buffers_mutex_{};
+};
+
+template <typename T, typename U>
+staging_pair_queue<T, U>::staging_pair_queue(size_type capacity)
+    : staging_pair_queue(capacity, overflow_policy::block)
+{
+}
+
+template <typename T, typename U>
+staging_pair_queue<T, U>::staging_pair_queue(size_type capacity,
+                                             overflow_policy policy,
+                                             droppable_type droppable)
+    : id_{next_id()}, buffer_capacity_{round_up_capacity(capacity)},
+      policy_{policy}, droppable_{std::move(droppable)}
+{
+    if (policy_ == overflow_policy::drop_oldest)
+    {
+        throw logency::runtime_error(
+            "Overflow policy is not supported by this queue.");
+    }
+}
+
+template <typename T, typename U>
+staging_pair_queue<T, U>::~staging_pair_queue() = default;
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::buffer_capacity() const noexcept -> size_type
+{
+    return buffer_capacity_;
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::buffer_count() -> size_type
+{
+    lock_type<mutex_type> lock{buffers_mutex_};
+
+    return buffers_.size();
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::capacity() -> size_type
+{
+    return buffer_capacity_ * buffer_count();
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::dropped() const noexcept -> size_type
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::enqueue(first_type &&first,
+                                       second_type &&second)
+{
+    auto *buffer{local_buffer()};
+
+    if (policy_ != overflow_policy::block)
+    {
+        while (buffer->is_full())
+        {
+            if (should_drop(first, second))
+            {
+                // Nothing is enqueued, so nobody has to be notified.
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+                return false;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    return buffer->enqueue(std::move(first), std::move(second));
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::is_empty()
+{
+    return size() == 0U;
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::local_buffer() -> staging_buffer *
+{
+    auto &registry{local_registry()};
+
+    for (const auto &entry : registry.entries)
+    {
+        if (entry.queue_id == id_)
+        {
+            return entry.buffer;
+        }
+    }
+
+    return register_buffer(registry);
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::local_registry() -> producer_registry &
+{
+    thread_local producer_registry registry{};
+
+    return registry;
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::next_id() -> id_type
+{
+    static std::atomic<id_type> counter{0U};
+
+    return counter.fetch_add(1U, std::memory_order_relaxed);
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::register_buffer(producer_registry &registry)
+    -> staging_buffer *
+{
+    auto buffer{std::make_shared<staging_buffer>(buffer_capacity_)};
+
+    // Forget the queues which are gone.
+    registry.entries.erase(
+        std::remove_if(registry.entries.begin(), registry.entries.end(),
+                       [](const producer_entry &entry)
+                       { return entry.owner.expired(); }),
+        registry.entries.end());
+
+    registry.entries.push_back(producer_entry{id_, buffer.get(), buffer});
+
+    {
+        lock_type<mutex_type> lock{buffers_mutex_};
+        buffers_.push_back(buffer);
+    }
+
+    return buffer.get();
+}
+
+template <typename T, typename U>
+void staging_pair_queue<T, U>::reserve(size_type /*size*/)
+{
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::round_up_capacity(size_type capacity)
+    -> size_type
+{
+    if (capacity == 0U)
+    {
+        return default_capacity;
+    }
+
+    size_type result{1U};
+
+    while (result < capacity)
+    {
+        if (result > (~size_type{0U} >> 1U))
+        {
+            throw logency::runtime_error("Requested capacity is too large.");
+        }
+
+        result <<= 1U;
+    }
+
+    return result;
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::should_drop(const first_type &first,
+                                           const second_type &second) const
+{
+    switch (policy_)
+    {
+    case overflow_policy::drop_newest:
+        return true;
+    case overflow_policy::drop_by_level:
+        return droppable_ && droppable_(first, second);
+    default:
+        return false;
+    }
+}
+
+template <typename T, typename U>
+void staging_pair_queue<T, U>::shrink_to_fit()
+{
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::size() -> size_type
+{
+    lock_type<mutex_type> lock{buffers_mutex_};
+
+    size_type result{0U};
+
+    for (const auto &buffer : buffers_)
+    {
+        result += buffer->size();
+    }
+
+    return result;
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::try_swap_bulk(
+    container_type<first_type> &first, container_type<second_type> &second)
+{
+    if (first.size() != second.size())
+    {
+        return false;
+    }
+
+    lock_type<mutex_type> lock{buffers_mutex_};
+
+    bool is_drained{false};
+
+    for (auto &buffer : buffers_)
+    {
+        is_drained = buffer->drain(first, second) || is_drained;
+    }
+
+    // The thread is gone and its buffer is drained. Nobody writes to it again.
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                  [](const buffer_pointer &buffer) {
+                                      return buffer->is_orphaned() &&
+                                             (buffer->size() == 0U);
+                                  }),
+                   buffers_.end());
+
+    assert(first.size() == second.size());
+
+    return is_drained;
+}
+
+template <typename T, typename U>
+staging_pair_queue<T, U>::producer_registry::~producer_registry()
+{
+    for (auto &entry : entries)
+    {
+        if (auto buffer{entry.owner.lock()})
+        {
+            buffer->mark_as_orphaned();
+        }
+    }
+}
+
+template <typename T, typename U>
+staging_pair_queue<T, U>::staging_buffer::staging_buffer(size_type capacity)
+    : mask_{capacity - 1U},
+      slots_{std::make_unique<slot[]>(capacity)} // NOLINT(*-c-arrays)
+{
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::staging_buffer::drain(
+    container_type<first_type> &first, container_type<second_type> &second)
+{
+    /**
+     * Pairs with the fence in enqueue(). Either this drain sees the item, or
+     * the producer sees the cleared flag and notifies again.
+     */
+    is_notified_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const auto head{head_.load(std::memory_order_acquire)};
+    const auto origin{tail_.load(std::memory_order_relaxed)};
+
+    for (auto position{origin}; position != head; ++position)
+    {
+        auto &source{slots_[position & mask_]};
+
+        first.push_back(std::move(source.first));
+        second.push_back(std::move(source.second));
+
+        source.first = first_type{};
+        source.second = second_type{};
+    }
+
+    tail_.store(head, std::memory_order_release);
+
+    return head != origin;
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::staging_buffer::enqueue(first_type &&first,
+                                                       second_type &&second)
+{
+    const auto head{head_.load(std::memory_order_relaxed)};
+
+    if (head - cached_tail_ > mask_)
+    {
+        // Looks full. Refresh the tail, let the consumer catch up if needed.
+        while (head - (cached_tail_ = tail_.load(std::memory_order_acquire)) >
+               mask_)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    auto &target{slots_[head & mask_]};
+
+    target.first = std::move(first);
+    target.second = std::move(second);
+
+    head_.store(head + 1U, std::memory_order_release);
+
+    /**
+     * Pairs with the fence in drain(). The flag is only written when the
+     * consumer has cleared it, so the cache line normally stays shared.
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (is_notified_.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    return !is_notified_.exchange(true, std::memory_order_acq_rel);
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::staging_buffer::is_full() noexcept
+{
+    const auto head{head_.load(std::memory_order_relaxed)};
+
+    if (head - cached_tail_ <= mask_)
+    {
+        return false;
+    }
+
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+
+    return head - cached_tail_ > mask_;
+}
+
+template <typename T, typename U>
+bool staging_pair_queue<T, U>::staging_buffer::is_orphaned() const noexcept
+{
+    return is_orphaned_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename U>
+void staging_pair_queue<T, U>::staging_buffer::mark_as_orphaned() noexcept
+{
+    is_orphaned_.store(true, std::memory_order_release);
+}
+
+template <typename T, typename U>
+auto staging_pair_queue<T, U>::staging_buffer::size() const noexcept
+    -> size_type
+{
+    const auto tail{tail_.load(std::memory_order_acquire)};
+    const auto head{head_.load(std::memory_order_acquire)};
+
+    return (head > tail) ? (head - tail) : 0U;
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STAGING_PAIR_QUEUE_HPP_
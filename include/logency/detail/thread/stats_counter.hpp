@@ -0,0 +1,58 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STATS_COUNTER_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STATS_COUNTER_HPP_
+
+#include <cstdint>
+
+#include <atomic>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the counter for statistics.
+ *
+ * Every operation is relaxed. It does not order anything, and a reader might
+ * see a slightly stale value.
+ */
+class stats_counter
+{
+public:
+    using value_type = std::uint64_t;
+
+    void add(value_type count = 1U) noexcept;
+
+    /**
+     * \brief Raise the counter to \a value if it is lower.
+     */
+    void update_max(value_type value) noexcept;
+
+    [[nodiscard]] auto load() const noexcept -> value_type;
+
+private:
+    std::atomic<value_type> value_{0U};
+};
+
+inline void stats_counter::add(value_type count) noexcept
+{
+    value_.fetch_add(count, std::memory_order_relaxed);
+}
+
+inline void stats_counter::update_max(value_type value) noexcept
+{
+    auto current{value_.load(std::memory_order_relaxed)};
+
+    while ((current < value) &&
+           !value_.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed))
+    {
+    }
+}
+
+inline auto stats_counter::load() const noexcept -> value_type
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_STATS_COUNTER_HPP_
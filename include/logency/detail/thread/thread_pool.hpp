@@ -2,23 +2,41 @@
 #define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_POOL_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/core/stats.hpp"
+#include "logency/core/thread_option.hpp"
+#include "logency/detail/thread/cache_line.hpp"
+#include "logency/detail/thread/stats_counter.hpp"
+#include "logency/detail/thread/thread_setting.hpp"
 #include "logency/detail/thread/thread_unit_interface.hpp"
 
 #include <cassert>
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <exception>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <string>
+#include <system_error>
 #include <thread>
 #include <vector>
 
 namespace logency::detail::thread
 {
 
+/**
+ * \brief This class represent the work-stealing thread pool.
+ *
+ * Each worker owns a deque. A task enqueued by a worker goes to its own deque,
+ * and a task enqueued by any other thread goes to the shared injection queue.
+ * A worker takes the newest task of its own deque first, then the injection
+ * queue, then steals the oldest task of the other workers. It parks only when
+ * no task is queued anywhere.
+ *
+ * Hence the workers rarely touch the same lock, except for the injection
+ * queue.
+ */
 class thread_pool
 {
     using pool_type = std::vector<std::thread>;
@@ -30,6 +48,15 @@ public:
     using error_handler_type = std::function<void(const std::exception &)>;
 
     explicit thread_pool(size_type thread_number);
+
+    /**
+     * \brief Initializes a new instance of the thread_pool class whose
+     * threads run with \a option.
+     *
+     * \throw logency::system_error if it failed to create the threads or to
+     * apply \a option.
+     */
+    thread_pool(size_type thread_number, const thread_option &option);
     ~thread_pool();
 
     thread_pool(const thread_pool &other) = delete;
@@ -39,8 +66,28 @@ public:
 
     void enqueue(value_type task);
 
+    /**
+     * \brief Enqueue the \a task without taking its ownership.
+     *
+     * \a task should be alive until it is operated. It should not be enqueued
+     * again before that.
+     */
+    void enqueue(thread_unit_interface &task);
+
     [[nodiscard]] auto pool_size() const noexcept -> size_type;
 
+    /**
+     * \brief Tell whether the calling thread is one of the pool.
+     *
+     * The pool cannot be destroyed by its own thread, since it joins them.
+     */
+    [[nodiscard]] auto is_worker_thread() const noexcept -> bool;
+
+    /**
+     * \brief Get the counters of the pool. Lock free.
+     */
+    [[nodiscard]] auto stats() const noexcept -> thread_pool_stats;
+
     void set_error_handler(error_handler_type handler);
 
     void wait_until_queue_empty();
@@ -50,21 +97,61 @@ private:
     using condition_variable_type = std::condition_variable;
     template <class Mutex>
     using lock_type = std::unique_lock<Mutex>;
-    using task_queue_type = std::queue<value_type>;
+    /**
+     * \brief The queued task, which might be owned by the pool.
+     */
+    struct task_type
+    {
+        thread_unit_interface *unit{nullptr};
+        value_type owned{nullptr};
+    };
+
+    using task_queue_type = std::deque<task_type>;
+
+    struct alignas(cache_line_size) worker_type
+    {
+        mutex_type mutex{};
+        task_queue_type tasks{};
+
+        // Written by its own thread only.
+        stats_counter executed{};
+        stats_counter stolen{};
+    };
+
+    /**
+     * \brief The pool and the worker index of the current thread.
+     */
+    struct worker_context
+    {
+        const thread_pool *pool{nullptr};
+        size_type index{0U};
+    };
 
     static auto is_thread_number_valid(size_type thread_number) -> size_type;
 
+    static auto current_worker() noexcept -> worker_context &;
+
+    void push(task_type &&task);
+
     void tidy();
     void tidy_threads();
 
-    void thread_loop();
-    void stand_by(lock_type<mutex_type> &lock);
+    void thread_loop(size_type index, const thread_option *option);
+    void stand_by();
+
+    [[nodiscard]] auto take_task(size_type index) -> task_type;
+    [[nodiscard]] static auto pop_back(worker_type &worker) -> task_type;
+    [[nodiscard]] static auto pop_front(worker_type &worker) -> task_type;
 
     [[nodiscard]] int running_threads() const noexcept;
     [[nodiscard]] bool is_pending() const noexcept;
 
     pool_type threads_;
-    task_queue_type task_queue_;
+    std::vector<worker_type> workers_;
+    worker_type injection_{};
+
+    alignas(cache_line_size) std::atomic<size_type> queued_counter_{0U};
+    alignas(cache_line_size) std::atomic<size_type> parked_counter_{0U};
 
     mutex_type mutex_{};
     condition_variable_type task_variable_{};
@@ -74,19 +161,30 @@ private:
 
     std::atomic<int> running_counter_;
     std::atomic<bool> mark_as_destroy_{false};
+
+    size_type started_counter_{0U};  //!< Guarded by `mutex_`.
+    std::error_code setup_error_{}; //!< Guarded by `mutex_`.
 };
 
 inline thread_pool::thread_pool(size_t thread_number)
+    : thread_pool{thread_number, thread_option{}}
+{
+}
+
+inline thread_pool::thread_pool(size_type thread_number,
+                                const thread_option &option)
     : threads_(is_thread_number_valid(thread_number)),
+      workers_(thread_number),
       running_counter_{static_cast<int>(thread_number)}
 {
     assert(threads_.size() == thread_number);
 
     try
     {
-        for (auto &thread : threads_)
+        for (size_type index{0U}; index < threads_.size(); ++index)
         {
-            thread = std::thread{&thread_pool::thread_loop, this};
+            threads_[index] =
+                std::thread{&thread_pool::thread_loop, this, index, &option};
         }
     }
     catch (const std::system_error &e)
@@ -94,22 +192,127 @@ inline thread_pool::thread_pool(size_t thread_number)
         tidy();
         throw logency::system_error(e.code(), "Fail to create thread pool");
     }
+
+    // Wait for every thread to apply `option`, which is not kept.
+    std::error_code code;
+    {
+        lock_type<mutex_type> lock{mutex_};
+        pending_variable_.wait(
+            lock, [this] { return started_counter_ == threads_.size(); });
+        code = setup_error_;
+    }
+
+    if (code)
+    {
+        tidy();
+        throw logency::system_error(code, "Failed to set thread option");
+    }
 }
 
 inline thread_pool::~thread_pool() { tidy(); }
 
+inline auto thread_pool::current_worker() noexcept -> worker_context &
+{
+    static thread_local worker_context context{};
+    return context;
+}
+
 inline void thread_pool::enqueue(value_type task)
 {
+    auto *unit{task.get()};
+    push(task_type{unit, std::move(task)});
+}
+
+inline void thread_pool::enqueue(thread_unit_interface &task)
+{
+    push(task_type{&task, nullptr});
+}
+
+inline auto thread_pool::pool_size() const noexcept -> size_type
+{
+    return threads_.size();
+}
+
+inline auto thread_pool::is_worker_thread() const noexcept -> bool
+{
+    return current_worker().pool == this;
+}
+
+inline auto thread_pool::pop_back(worker_type &worker) -> task_type
+{
+    lock_type<mutex_type> lock{worker.mutex};
+
+    if (worker.tasks.empty())
+    {
+        return task_type{};
+    }
+
+    auto task{std::move(worker.tasks.back())};
+    worker.tasks.pop_back();
+    return task;
+}
+
+inline auto thread_pool::pop_front(worker_type &worker) -> task_type
+{
+    lock_type<mutex_type> lock{worker.mutex};
+
+    if (worker.tasks.empty())
+    {
+        return task_type{};
+    }
+
+    auto task{std::move(worker.tasks.front())};
+    worker.tasks.pop_front();
+    return task;
+}
+
+inline auto thread_pool::stats() const noexcept -> thread_pool_stats
+{
+    thread_pool_stats result{};
+
+    for (const auto &worker : workers_)
+    {
+        result.executed += worker.executed.load();
+        result.stolen += worker.stolen.load();
+    }
+
+    result.queued = queued_counter_.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+inline void thread_pool::push(task_type &&task)
+{
+    const auto &context{current_worker()};
+    auto &worker{(context.pool == this) ? workers_[context.index]
+                                        : injection_};
+
+    // Count it first, so the counter never drops below the queued tasks.
+    // Pairs with stand_by(). Either the parked worker sees the task, or this
+    // thread sees the parked worker.
+    queued_counter_.fetch_add(1U);
+
+    try
+    {
+        lock_type<mutex_type> lock{worker.mutex};
+        worker.tasks.push_back(std::move(task));
+    }
+    catch (...)
+    {
+        queued_counter_.fetch_sub(1U);
+        throw;
+    }
+
+    if (parked_counter_.load() != 0U)
     {
         lock_type<mutex_type> lock{mutex_};
-        task_queue_.push(std::move(task));
+        task_variable_.notify_one();
     }
-    task_variable_.notify_one();
 }
 
 inline bool thread_pool::is_pending() const noexcept
 {
-    return (running_threads() == 0) && task_queue_.empty();
+    return (running_threads() == 0) && (queued_counter_.load() == 0U);
 }
 
 inline auto thread_pool::is_thread_number_valid(size_type thread_number)
@@ -123,11 +326,6 @@ inline auto thread_pool::is_thread_number_valid(size_type thread_number)
     return thread_number;
 }
 
-inline auto thread_pool::pool_size() const noexcept -> size_type
-{
-    return threads_.size();
-}
-
 inline int thread_pool::running_threads() const noexcept
 {
     return running_counter_.load(std::memory_order::memory_order_relaxed);
@@ -139,44 +337,102 @@ inline void thread_pool::set_error_handler(error_handler_type handler)
     error_handler_ = std::move(handler);
 }
 
-inline void thread_pool::stand_by(lock_type<mutex_type> &lock)
+inline void thread_pool::stand_by()
 {
+    lock_type<mutex_type> lock{mutex_};
+
     running_counter_.fetch_sub(1);
+    parked_counter_.fetch_add(1U);
 
     if (is_pending())
     {
         pending_variable_.notify_all();
     }
 
-    task_variable_.wait(lock, [&]
-                        { return !task_queue_.empty() || mark_as_destroy_; });
+    task_variable_.wait(
+        lock,
+        [&] { return (queued_counter_.load() != 0U) || mark_as_destroy_; });
 
+    parked_counter_.fetch_sub(1U);
     running_counter_.fetch_add(1);
 }
 
-inline void thread_pool::thread_loop()
+inline auto thread_pool::take_task(size_type index) -> task_type
+{
+    // Newest task of its own first, since it is likely still in the cache.
+    if (auto task{pop_back(workers_[index])}; task.unit != nullptr)
+    {
+        return task;
+    }
+
+    if (auto task{pop_front(injection_)}; task.unit != nullptr)
+    {
+        return task;
+    }
+
+    for (size_type offset{1U}; offset < workers_.size(); ++offset)
+    {
+        auto &victim{workers_[(index + offset) % workers_.size()]};
+
+        if (auto task{pop_front(victim)}; task.unit != nullptr)
+        {
+            workers_[index].stolen.add();
+            return task;
+        }
+    }
+
+    return task_type{};
+}
+
+inline void thread_pool::thread_loop(size_type index,
+                                     const thread_option *option)
 {
+    current_worker() = worker_context{this, index};
+
+    {
+        const auto code{apply_thread_option(*option)};
+
+        lock_type<mutex_type> lock{mutex_};
+
+        if (code && !setup_error_)
+        {
+            setup_error_ = code;
+        }
+
+        ++started_counter_;
+        pending_variable_.notify_all();
+    }
+
     for (;;)
     {
         try
         {
-            value_type task{nullptr};
+            auto task{take_task(index)};
 
+            if (task.unit == nullptr)
             {
-                lock_type<mutex_type> lock{mutex_};
-
-                stand_by(lock);
+                if (queued_counter_.load() == 0U)
+                {
+                    if (mark_as_destroy_)
+                    {
+                        break;
+                    }
 
-                if (task_queue_.empty() && mark_as_destroy_)
+                    stand_by();
+                }
+                else
                 {
-                    break;
+                    // It is counted, but not pushed or taken yet.
+                    std::this_thread::yield();
                 }
 
-                task = std::move(task_queue_.front());
-                task_queue_.pop();
+                continue;
             }
 
-            task->operate_by_thread();
+            queued_counter_.fetch_sub(1U);
+            workers_[index].executed.add();
+
+            task.unit->operate_by_thread();
         }
         catch (const std::exception &e)
         {
@@ -190,17 +446,20 @@ inline void thread_pool::thread_loop()
         }
     }
 
-    assert(task_queue_.empty());
+    current_worker() = worker_context{};
 }
 
 inline void thread_pool::tidy()
 {
-    mark_as_destroy_ = true;
+    {
+        lock_type<mutex_type> lock{mutex_};
+        mark_as_destroy_ = true;
+    }
 
     // Clean it up *after* the `mark_as_destroy_` flag is raised.
     tidy_threads();
 
-    assert(task_queue_.empty());
+    assert(queued_counter_.load() == 0U);
 }
 
 inline void thread_pool::tidy_threads()
@@ -0,0 +1,113 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_SETTING_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_SETTING_HPP_
+
+#include "logency/core/thread_option.hpp"
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstddef>
+
+#include <system_error>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief Apply \a option to the calling thread.
+ *
+ * \return Error of the first setting which failed, or an empty error code.
+ */
+[[nodiscard]] inline auto apply_thread_option(const thread_option &option)
+    -> std::error_code
+{
+#if defined(__linux__)
+    if (!option.cpu_affinity.empty())
+    {
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for (const auto cpu : option.cpu_affinity)
+        {
+            if ((cpu < 0) || (cpu >= CPU_SETSIZE))
+            {
+                return std::make_error_code(std::errc::invalid_argument);
+            }
+
+            CPU_SET(static_cast<std::size_t>(cpu), &set);
+        }
+
+        if (const auto result{
+                ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set)};
+            result != 0)
+        {
+            return std::error_code{result, std::generic_category()};
+        }
+    }
+
+    if (option.scheduling != thread_scheduling::inherit)
+    {
+        int policy{SCHED_OTHER};
+        ::sched_param parameter{};
+
+        switch (option.scheduling)
+        {
+        case thread_scheduling::inherit:
+        case thread_scheduling::normal:
+            break;
+        case thread_scheduling::batch:
+            policy = SCHED_BATCH;
+            break;
+        case thread_scheduling::idle:
+            policy = SCHED_IDLE;
+            break;
+        case thread_scheduling::fifo:
+            policy = SCHED_FIFO;
+            parameter.sched_priority = option.priority;
+            break;
+        case thread_scheduling::round_robin:
+            policy = SCHED_RR;
+            parameter.sched_priority = option.priority;
+            break;
+        }
+
+        if (const auto result{
+                ::pthread_setschedparam(::pthread_self(), policy, &parameter)};
+            result != 0)
+        {
+            return std::error_code{result, std::generic_category()};
+        }
+    }
+
+    if (option.nice)
+    {
+        // The nice value belongs to the thread on Linux.
+        const auto thread_id{static_cast<::id_t>(::syscall(SYS_gettid))};
+
+        if (::setpriority(PRIO_PROCESS, thread_id, *option.nice) != 0)
+        {
+            return std::error_code{errno, std::generic_category()};
+        }
+    }
+
+    return std::error_code{};
+#else
+    if (!option.cpu_affinity.empty() || option.nice ||
+        (option.scheduling != thread_scheduling::inherit))
+    {
+        return std::make_error_code(std::errc::not_supported);
+    }
+
+    return std::error_code{};
+#endif
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_SETTING_HPP_
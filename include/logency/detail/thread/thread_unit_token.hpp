@@ -0,0 +1,115 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_UNIT_TOKEN_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_UNIT_TOKEN_HPP_
+
+#include "logency/detail/thread/thread_pool.hpp"
+#include "logency/detail/thread/thread_unit_interface.hpp"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace logency::detail::thread
+{
+
+/**
+ * \brief This class represent the task node embedded in its owner.
+ *
+ * schedule() enqueues the node itself into the thread pool, so it allocates
+ * nothing. The node is enqueued at most once until it is operated. Hence
+ * there is at most one pending run of the owner, no matter how many times it
+ * is scheduled.
+ *
+ * \par Lifetime
+ * The owner is kept alive by a \c std::shared_ptr while the node is queued.
+ *
+ * \par Clearing
+ * The node is able to be scheduled again right before \a Function is called,
+ * so the work which comes during the run is not missed.
+ *
+ * \tparam Owner Owner type which derives \c std::enable_shared_from_this.
+ */
+template <typename Owner>
+class thread_unit_token final : public thread_unit_interface
+{
+public:
+    using owner_type = Owner;
+    using function_type = void (owner_type::*)();
+
+    /**
+     * \brief Initializes a new instance of the thread_unit_token class.
+     *
+     * \param owner Owner which embeds the token.
+     * \param function Member function of the \a owner to run.
+     */
+    thread_unit_token(owner_type &owner, function_type function) noexcept;
+
+    thread_unit_token(const thread_unit_token &other) = delete;
+    thread_unit_token(thread_unit_token &&other) noexcept = delete;
+    auto operator=(const thread_unit_token &other)
+        -> thread_unit_token & = delete;
+    auto operator=(thread_unit_token &&other) noexcept
+        -> thread_unit_token & = delete;
+
+    /**
+     * \brief Enqueue the token into \a pool unless it is already pending.
+     *
+     * \return \c true if it is enqueued by this call.
+     */
+    bool schedule(thread_pool &pool);
+
+protected:
+    void operate_by_thread() final;
+
+private:
+    owner_type &owner_;
+    const function_type function_;
+
+    std::shared_ptr<owner_type> keep_alive_{};
+    std::atomic<bool> is_scheduled_{false};
+};
+
+template <typename Owner>
+thread_unit_token<Owner>::thread_unit_token(owner_type &owner,
+                                            function_type function) noexcept
+    : owner_{owner}, function_{function}
+{
+}
+
+template <typename Owner>
+bool thread_unit_token<Owner>::schedule(thread_pool &pool)
+{
+    if (is_scheduled_.exchange(true, std::memory_order_acq_rel))
+    {
+        return false;
+    }
+
+    // Only the winner of the flag touches `keep_alive_`.
+    keep_alive_ = owner_.shared_from_this();
+
+    try
+    {
+        pool.enqueue(*this);
+    }
+    catch (...)
+    {
+        keep_alive_.reset();
+        is_scheduled_.store(false, std::memory_order_release);
+        throw;
+    }
+
+    return true;
+}
+
+template <typename Owner>
+void thread_unit_token<Owner>::operate_by_thread()
+{
+    // It might be the last owner, so do not touch the members after the run.
+    const auto myself{std::move(keep_alive_)};
+    is_scheduled_.store(false, std::memory_order_release);
+
+    ((*myself).*function_)();
+}
+
+} // namespace logency::detail::thread
+
+#endif // LOGENCY_INCLUDE_LOGENCY_DETAIL_THREAD_THREAD_UNIT_TOKEN_HPP_
@@ -2,13 +2,22 @@
 #define LOGENCY_INCLUDE_LOGENCY_DISPATCHER_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/core/overflow_policy.hpp"
+#include "logency/core/stats.hpp"
 #include "logency/detail/message_pack.hpp"
 #include "logency/detail/thread/blocking_pair_queue.hpp"
+#include "logency/detail/thread/pair_queue_interface.hpp"
+#include "logency/detail/thread/ring_pair_queue.hpp"
+#include "logency/detail/thread/staging_pair_queue.hpp"
+#include "logency/detail/thread/stats_counter.hpp"
 #include "logency/detail/thread/thread_pool.hpp"
+#include "logency/detail/thread/thread_unit_token.hpp"
 #include "logency/logger.hpp"
+#include "logency/message/log_level.hpp"
 #include "logency/sink.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -17,6 +26,75 @@
 namespace logency
 {
 
+/**
+ * \brief Queue implementation used by the dispatcher.
+ */
+enum class dispatcher_queue
+{
+    /**
+     * \brief Unbounded queue guarded by a mutex.
+     */
+    blocking,
+    /**
+     * \brief Bounded lock-free multi-producer single-consumer ring.
+     *
+     * Producers yield while the ring is full.
+     */
+    lock_free,
+    /**
+     * \brief Bounded single-producer single-consumer buffer per producer
+     * thread.
+     *
+     * Producers do not share any cache line with each other. Messages of
+     * different threads are not ordered against each other. Producers yield
+     * while their own buffer is full.
+     */
+    per_thread
+};
+
+/**
+ * \brief Option of the dispatcher.
+ */
+struct dispatcher_option
+{
+    dispatcher_queue queue{dispatcher_queue::blocking};
+
+    /**
+     * \brief Capacity of the queue.
+     *
+     * For dispatcher_queue::blocking, it is the maximum message count. \c 0
+     * means unbounded.
+     *
+     * For dispatcher_queue::lock_free, and dispatcher_queue::per_thread as the
+     * capacity of each thread, it is rounded up to the power of two. \c 0
+     * means default capacity.
+     */
+    std::size_t capacity{0U};
+
+    /**
+     * \brief What to do when the queue is full.
+     *
+     * overflow_policy::drop_oldest is only supported by
+     * dispatcher_queue::blocking.
+     */
+    overflow_policy overflow{overflow_policy::block};
+
+    /**
+     * \brief Messages at or above this level are never dropped by
+     * overflow_policy::drop_by_level.
+     */
+    log_level keep_level{log_level::warning};
+
+    /**
+     * \brief Number of dispatchers the manager creates.
+     *
+     * Each dispatcher has its own queue with the options above, and they
+     * dispatch in parallel. A logger is assigned to one of them by the ID of
+     * its name, so the messages of a logger keep their order.
+     */
+    std::size_t shard_count{1U};
+};
+
 template <typename MessageType>
 class dispatcher : public std::enable_shared_from_this<dispatcher<MessageType>>
 {
@@ -31,6 +109,8 @@ public:
     using size_type = std::size_t;
 
     explicit dispatcher(std::weak_ptr<thread_pool_type> thread_pool);
+    dispatcher(std::weak_ptr<thread_pool_type> thread_pool,
+               dispatcher_option option);
     ~dispatcher();
 
     dispatcher(const dispatcher &other) = delete;
@@ -48,6 +128,16 @@ public:
     [[nodiscard]] auto queue_size() -> size_type;
     [[nodiscard]] bool is_queue_empty();
 
+    /**
+     * \brief Count of the messages dropped by the overflow policy.
+     */
+    [[nodiscard]] auto dropped_count() const noexcept -> size_type;
+
+    /**
+     * \brief Get the counters of the dispatcher. Lock free.
+     */
+    [[nodiscard]] auto stats() const noexcept -> dispatcher_stats;
+
 private:
     using mutex_type = std::mutex;
 
@@ -57,25 +147,18 @@ private:
     using logger_value_type = std::shared_ptr<logger_type>;
 
     using queue_type =
-        logency::detail::thread::blocking_pair_queue<logger_value_type,
-                                                     message_pack_type>;
+        logency::detail::thread::pair_queue_interface<logger_value_type,
+                                                      message_pack_type>;
+
+    static auto make_queue(const dispatcher_option &option)
+        -> std::unique_ptr<queue_type>;
+    static auto make_droppable(const dispatcher_option &option) ->
+        typename queue_type::droppable_type;
 
     template <typename T>
     using tray_type = typename queue_type::template container_type<T>;
 
-    class thread_unit_token
-        : public logency::detail::thread::thread_unit_interface
-    {
-    public:
-        using me_type = dispatcher<MessageType>;
-        explicit thread_unit_token(std::shared_ptr<me_type> myself);
-
-    protected:
-        void operate_by_thread() final;
-
-    private:
-        std::shared_ptr<me_type> myself_{};
-    };
+    using thread_unit_token = detail::thread::thread_unit_token<dispatcher>;
 
     void notify_thread_pool();
 
@@ -83,7 +166,7 @@ private:
     void dispatch_message_from_tray(tray_type<logger_value_type> &loggers,
                                     tray_type<message_pack_type> &messages);
 
-    queue_type queue_{};
+    std::unique_ptr<queue_type> queue_;
 
     // Keep it here to prevent deallocation
     tray_type<logger_value_type> logger_tray_;
@@ -92,11 +175,25 @@ private:
 
     std::weak_ptr<thread_pool_type> thread_pool_;
     mutex_type operate_mutex_{};
+
+    thread_unit_token token_{*this, &dispatcher::dispatch};
+
+    // Written under `operate_mutex_`.
+    detail::thread::stats_counter batch_count_{};
+    detail::thread::stats_counter message_count_{};
+    detail::thread::stats_counter max_batch_size_{};
 };
 
 template <typename MessageType>
 dispatcher<MessageType>::dispatcher(std::weak_ptr<thread_pool_type> thread_pool)
-    : thread_pool_{std::move(thread_pool)}
+    : dispatcher{std::move(thread_pool), dispatcher_option{}}
+{
+}
+
+template <typename MessageType>
+dispatcher<MessageType>::dispatcher(std::weak_ptr<thread_pool_type> thread_pool,
+                                    dispatcher_option option)
+    : queue_{make_queue(option)}, thread_pool_{std::move(thread_pool)}
 {
 }
 
@@ -114,11 +211,16 @@ void dispatcher<MessageType>::dispatch()
      */
     dispatch_message_from_tray(logger_tray_, message_tray_);
 
-    if (!queue_.try_swap_bulk(logger_tray_, message_tray_))
+    if (!queue_->try_swap_bulk(logger_tray_, message_tray_))
     {
         return;
     }
 
+    const auto batch_size{static_cast<std::uint64_t>(logger_tray_.size())};
+    batch_count_.add();
+    message_count_.add(batch_size);
+    max_batch_size_.update_max(batch_size);
+
     dispatch_message_from_tray(logger_tray_, message_tray_);
 }
 
@@ -138,6 +240,16 @@ void dispatcher<MessageType>::dispatch_message_from_tray(
         return;
     }
 
+#if defined(LOGENCY_LATENCY)
+    const auto dispatched_at{
+        message_pack_base<message_type>::clock_type::now()};
+
+    for (auto &message : messages)
+    {
+        message->dispatched_at = dispatched_at;
+    }
+#endif
+
     auto destination{loggers.begin()};
     auto current_logger{std::next(destination)};
 
@@ -183,11 +295,17 @@ void dispatcher<MessageType>::dispatch_message_from_tray(
     messages.clear();
 }
 
+template <typename MessageType>
+auto dispatcher<MessageType>::dropped_count() const noexcept -> size_type
+{
+    return queue_->dropped();
+}
+
 template <typename MessageType>
 void dispatcher<MessageType>::enqueue(logger_value_type &&logger,
                                       message_pack_type &&message)
 {
-    if (!queue_.enqueue(std::move(logger), std::move(message)))
+    if (!queue_->enqueue(std::move(logger), std::move(message)))
     {
         return;
     }
@@ -198,7 +316,52 @@ void dispatcher<MessageType>::enqueue(logger_value_type &&logger,
 template <typename MessageType>
 bool dispatcher<MessageType>::is_queue_empty()
 {
-    return queue_.is_empty();
+    return queue_->is_empty();
+}
+
+template <typename MessageType>
+auto dispatcher<MessageType>::make_queue(const dispatcher_option &option)
+    -> std::unique_ptr<queue_type>
+{
+    switch (option.queue)
+    {
+    case dispatcher_queue::blocking:
+        return std::make_unique<logency::detail::thread::blocking_pair_queue<
+            logger_value_type, message_pack_type>>(
+            0U, option.capacity, option.overflow, make_droppable(option));
+    case dispatcher_queue::lock_free:
+        return std::make_unique<logency::detail::thread::ring_pair_queue<
+            logger_value_type, message_pack_type>>(
+            option.capacity, option.overflow, make_droppable(option));
+    case dispatcher_queue::per_thread:
+        return std::make_unique<logency::detail::thread::staging_pair_queue<
+            logger_value_type, message_pack_type>>(
+            option.capacity, option.overflow, make_droppable(option));
+    }
+
+    throw logency::runtime_error("Unknown dispatcher queue.");
+}
+
+template <typename MessageType>
+auto dispatcher<MessageType>::make_droppable(const dispatcher_option &option)
+    -> typename queue_type::droppable_type
+{
+    if (option.overflow != overflow_policy::drop_by_level)
+    {
+        return {};
+    }
+
+    if constexpr (has_log_level_v<message_type>)
+    {
+        return [keep_level = option.keep_level](
+                   const logger_value_type & /*logger*/,
+                   const message_pack_type &pack)
+        { return pack->message.level < keep_level; };
+    }
+    else
+    {
+        throw logency::runtime_error("Message type has no level to drop by.");
+    }
 }
 
 template <typename MessageType>
@@ -206,8 +369,7 @@ void dispatcher<MessageType>::notify_thread_pool()
 {
     if (auto where{thread_pool_.lock()})
     {
-        where->enqueue(
-            std::make_unique<thread_unit_token>(this->shared_from_this()));
+        token_.schedule(*where);
 
         return;
     }
@@ -218,19 +380,19 @@ void dispatcher<MessageType>::notify_thread_pool()
 template <typename MessageType>
 auto dispatcher<MessageType>::queue_capacity() -> size_type
 {
-    return queue_.capacity();
+    return queue_->capacity();
 }
 
 template <typename MessageType>
 auto dispatcher<MessageType>::queue_size() -> size_type
 {
-    return queue_.size();
+    return queue_->size();
 }
 
 template <typename MessageType>
 void dispatcher<MessageType>::reserve(size_type size)
 {
-    queue_.reserve(size);
+    queue_->reserve(size);
 
     {
         lock_type<mutex_type> lock{operate_mutex_};
@@ -243,7 +405,7 @@ void dispatcher<MessageType>::reserve(size_type size)
 template <typename T>
 void dispatcher<T>::shrink_to_fit()
 {
-    queue_.shrink_to_fit();
+    queue_->shrink_to_fit();
 
     {
         lock_type<mutex_type> lock{operate_mutex_};
@@ -254,16 +416,16 @@ void dispatcher<T>::shrink_to_fit()
 }
 
 template <typename MessageType>
-dispatcher<MessageType>::thread_unit_token::thread_unit_token(
-    std::shared_ptr<me_type> myself)
-    : myself_{std::move(myself)}
+auto dispatcher<MessageType>::stats() const noexcept -> dispatcher_stats
 {
-}
+    dispatcher_stats result{};
 
-template <typename MessageType>
-void dispatcher<MessageType>::thread_unit_token::operate_by_thread()
-{
-    myself_->dispatch();
+    result.batch_count = batch_count_.load();
+    result.message_count = message_count_.load();
+    result.max_batch_size = max_batch_size_.load();
+    result.dropped = queue_->dropped();
+
+    return result;
 }
 
 } // namespace logency
@@ -2,16 +2,23 @@
 #define LOGENCY_INCLUDE_LOGENCY_LOGGER_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/core/stats.hpp"
 #include "logency/detail/message_pack.hpp"
+#include "logency/detail/string/name_registry.hpp"
+#include "logency/detail/thread/snapshot.hpp"
+#include "logency/detail/thread/stats_counter.hpp"
+#include "logency/message/log_level.hpp"
 #include "logency/sink.hpp"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace logency
@@ -36,6 +43,8 @@ public:
     using sink_pointer_type = std::shared_ptr<sink_type>;
     using sink_pointers_type = std::vector<sink_pointer_type>;
     using dispatcher_type = dispatcher<message_type>;
+    using name_registry_type = detail::string::name_registry<string_type>;
+    using id_type = typename name_registry_type::id_type;
 
     using error_handler_type = std::function<void(const std::exception &)>;
     using filter_type =
@@ -43,6 +52,16 @@ public:
 
     explicit logger(string_type &&name,
                     std::weak_ptr<dispatcher_type> dispatcher);
+
+    /**
+     * \brief Initializes a new instance of the logger class whose \a name is
+     * interned in \a names.
+     *
+     * The message packs refer to the interned name, so \a names should
+     * outlive them.
+     */
+    logger(std::shared_ptr<name_registry_type> names, string_view_type name,
+           std::weak_ptr<dispatcher_type> dispatcher);
     ~logger();
 
     logger(const logger &other) = delete;
@@ -50,11 +69,62 @@ public:
     auto operator=(const logger &other) -> logger & = delete;
     auto operator=(logger &&other) noexcept -> logger & = delete;
 
+    /**
+     * \brief Construct the message from \a args and log it.
+     *
+     * If the first argument is a log_level, it is checked by should_log()
+     * before the message is constructed.
+     */
     template <typename... Args>
     void log(Args &&...args);
 
+    /**
+     * \brief Log the message at \a Level.
+     *
+     * The call compiles to nothing if \a Level is below LOGENCY_ACTIVE_LEVEL.
+     * \a Level is passed to the message constructor as the first argument.
+     */
+    template <log_level Level, typename... Args>
+    void log(Args &&...args);
+
+    /**
+     * \brief Tell whether the message at \a level would be logged.
+     *
+     * It is cheap enough to guard the expensive arguments of log().
+     */
+    [[nodiscard]] bool should_log(log_level level) const noexcept;
+
+    /**
+     * \brief Sets whether log() writes to the sinks on the calling thread.
+     * Thread safe.
+     *
+     * In synchronous mode, log() passes the message to the sink modules
+     * directly under the lock of each sink and flushes them, bypassing the
+     * dispatcher, the sink queues and the thread pool. Hence the message is
+     * written before log() returns. It suits low volume loggers, e.g. startup
+     * or audit.
+     *
+     * The order against the messages which are already queued by the other
+     * loggers is not kept. Default is asynchronous.
+     */
+    void set_synchronous(bool synchronous) noexcept;
+    [[nodiscard]] bool is_synchronous() const noexcept;
+
+    /**
+     * \brief Sets the minimum level of the logger. Thread safe.
+     *
+     * Default minimum level is log_level::trace.
+     */
+    void set_level(log_level level) noexcept;
+    [[nodiscard]] auto level() const noexcept -> log_level;
+
     [[nodiscard]] auto name() const noexcept -> string_type;
 
+    /**
+     * \brief Get the ID of the name, which is unique in its name registry.
+     */
+    [[nodiscard]] auto id() const noexcept -> id_type;
+
     void add_sink(sink_pointer_type sink);
     [[nodiscard]] auto find_sink(string_view_type name) -> sink_pointer_type;
     void delete_sink(string_view_type name);
@@ -63,6 +133,11 @@ public:
     void set_filter(filter_type filter);
     void set_error_handler(error_handler_type handler);
 
+    /**
+     * \brief Get the counters of the logger. Lock free.
+     */
+    [[nodiscard]] auto stats() const noexcept -> logger_stats;
+
 private:
     using mutex_type = std::mutex;
     template <typename MutexT>
@@ -74,26 +149,50 @@ private:
     void mark_as_destroy() noexcept;
     bool should_log(const message_pack_type &pack);
 
+    template <typename First, typename... Rest>
+    [[nodiscard]] bool should_log_arguments(const First &first,
+                                            const Rest &.../*rest*/) const;
+    [[nodiscard]] bool should_log_arguments() const noexcept;
+
     template <typename... Args>
     void log_inner(Args &&...args);
 
-    template <typename Iterator>
-    void delete_sink_inner(Iterator where);
+    void log_synchronously(const message_type &message);
 
-    template <typename Iterator>
-    auto find_sink_location(sink_pointer_type sink) -> Iterator;
-    template <typename Iterator>
-    auto find_sink_location(string_view_type name) -> Iterator;
+    void count_logged(const message_type &message) noexcept;
+
+    using sink_iterator_type = typename sink_pointers_type::const_iterator;
+
+    void delete_sink_inner(std::size_t index);
+
+    static auto find_sink_location(const sink_pointers_type &sinks,
+                                   const sink_pointer_type &sink)
+        -> sink_iterator_type;
+    static auto find_sink_location(const sink_pointers_type &sinks,
+                                   string_view_type name) -> sink_iterator_type;
 
     template <typename Iterator>
     void dispatch_message_to_sinks(Iterator begin, Iterator end);
 
-    // It will be used in message pack for multiple thread reasons.
-    std::shared_ptr<string_type> name_;
+    /**
+     * The loggers created without a manager share the process-wide one, which
+     * is never destroyed.
+     */
+    [[nodiscard]] static auto default_registry()
+        -> const std::shared_ptr<name_registry_type> &;
+
+    std::shared_ptr<name_registry_type> names_;
+    id_type id_;
+    string_view_type name_; //!< Refers to `names_`.
 
     std::weak_ptr<dispatcher_type> dispatcher_;
 
-    sink_pointers_type sinks_{};
+    /**
+     * Read by the dispatching threads without lock, and replaced as a whole
+     * by the others under `sink_mutex_`.
+     */
+    detail::thread::snapshot<sink_pointers_type> sinks_{
+        std::make_unique<const sink_pointers_type>()};
     mutex_type sink_mutex_;
 
     /**
@@ -105,13 +204,30 @@ private:
     error_handler_type error_handler_{};
     mutex_type error_handler_mutex_;
 
+    std::atomic<log_level> level_{log_level::trace};
+    std::atomic<bool> is_synchronous_{false};
     std::atomic<bool> mark_as_destroy_{false};
+
+    detail::thread::stats_counter logged_{};
+    std::array<detail::thread::stats_counter, log_string.size()>
+        logged_by_level_{};
+    detail::thread::stats_counter filtered_{};
 };
 
 template <typename MessageType>
 inline logger<MessageType>::logger(string_type &&name,
                                    std::weak_ptr<dispatcher_type> dispatcher)
-    : name_{std::make_shared<string_type>(std::move(name))},
+    : logger{default_registry(), string_view_type{name}, std::move(dispatcher)}
+{
+}
+
+template <typename MessageType>
+inline logger<MessageType>::logger(std::shared_ptr<name_registry_type> names,
+                                   string_view_type name,
+                                   std::weak_ptr<dispatcher_type> dispatcher)
+    : names_{std::move(names)},
+      id_{names_->intern(name)},
+      name_{names_->resolve(id_)},
       dispatcher_{std::move(dispatcher)}
 {
 }
@@ -124,29 +240,44 @@ void logger<MessageType>::add_sink(sink_pointer_type sink)
 {
     lock_type<mutex_type> lock{sink_mutex_};
 
-    if (find_sink_location<typename sink_pointers_type::iterator>(sink) !=
-        sinks_.end())
+    auto sinks{std::make_unique<sink_pointers_type>()};
     {
-        throw logency::runtime_error(
-            "This logger has connected to the sink already.");
+        const auto current{sinks_.read()};
+
+        if (find_sink_location(*current, sink) != current->end())
+        {
+            throw logency::runtime_error(
+                "This logger has connected to the sink already.");
+        }
+
+        sinks->reserve(current->size() + 1U);
+        sinks->assign(current->begin(), current->end());
     }
 
-    sinks_.push_back(std::move(sink));
+    sinks->push_back(std::move(sink));
+    sinks_.update(std::move(sinks));
 }
 
 template <typename MessageType>
 void logger<MessageType>::delete_sink(string_view_type name)
 {
     lock_type<mutex_type> lock{sink_mutex_};
-    auto where{find_sink_location<typename sink_pointers_type::iterator>(name)};
 
-    if (where == sinks_.end())
+    std::size_t index{0U};
     {
-        throw logency::runtime_error(
-            "Cannot found the sink requested in the logger.");
+        const auto current{sinks_.read()};
+        const auto where{find_sink_location(*current, name)};
+
+        if (where == current->end())
+        {
+            throw logency::runtime_error(
+                "Cannot found the sink requested in the logger.");
+        }
+
+        index = static_cast<std::size_t>(where - current->begin());
     }
 
-    delete_sink_inner(std::move(where));
+    delete_sink_inner(index);
 }
 
 template <typename MessageType>
@@ -154,15 +285,35 @@ void logger<MessageType>::delete_sink(sink_pointer_type sink)
 {
     lock_type<mutex_type> lock{sink_mutex_};
 
-    auto where{find_sink_location<typename sink_pointers_type::iterator>(sink)};
-
-    if (where == sinks_.end())
+    std::size_t index{0U};
     {
-        throw logency::runtime_error(
-            "Cannot found the sink requested in the logger.");
+        const auto current{sinks_.read()};
+        const auto where{find_sink_location(*current, sink)};
+
+        if (where == current->end())
+        {
+            throw logency::runtime_error(
+                "Cannot found the sink requested in the logger.");
+        }
+
+        index = static_cast<std::size_t>(where - current->begin());
     }
 
-    delete_sink_inner(std::move(where));
+    delete_sink_inner(index);
+}
+
+template <typename MessageType>
+void logger<MessageType>::count_logged(const message_type &message) noexcept
+{
+    if constexpr (has_log_level_v<message_type>)
+    {
+        logged_by_level_[static_cast<std::size_t>(message.level)].add();
+    }
+    else
+    {
+        static_cast<void>(message);
+        logged_.add();
+    }
 }
 
 template <typename MessageType>
@@ -175,29 +326,38 @@ void logger<MessageType>::dispatch_message_to_sinks(Iterator begin,
         return;
     }
 
-    lock_type<mutex_type> lock{sink_mutex_};
+    const auto sinks{sinks_.read()};
 
-    for (auto &sink : sinks_)
+    for (const auto &sink : *sinks)
     {
         sink->log(begin, end);
     }
 }
 
 template <typename MessageType>
-template <typename Iterator>
-void logger<MessageType>::delete_sink_inner(Iterator where)
+void logger<MessageType>::delete_sink_inner(std::size_t index)
 {
-    sinks_.erase(where);
+    // Called under `sink_mutex_`, so the snapshot does not change meanwhile.
+    auto sinks{std::make_unique<sink_pointers_type>()};
+    {
+        const auto current{sinks_.read()};
+
+        sinks->reserve(current->size() - 1U);
+        sinks->assign(current->begin(), current->end());
+    }
+
+    sinks->erase(sinks->begin() +
+                 static_cast<typename sink_pointers_type::difference_type>(
+                     index));
+    sinks_.update(std::move(sinks));
 }
 
 template <typename MessageType>
 auto logger<MessageType>::find_sink(string_view_type name) -> sink_pointer_type
 {
-    lock_type<mutex_type> lock{sink_mutex_};
+    const auto sinks{sinks_.read()};
 
-    if (auto where{
-            find_sink_location<typename sink_pointers_type::iterator>(name)};
-        where != sinks_.end())
+    if (auto where{find_sink_location(*sinks, name)}; where != sinks->end())
     {
         return *where;
     }
@@ -205,21 +365,29 @@ auto logger<MessageType>::find_sink(string_view_type name) -> sink_pointer_type
 }
 
 template <typename MessageType>
-template <typename Iterator>
-auto logger<MessageType>::find_sink_location(sink_pointer_type sink) -> Iterator
+auto logger<MessageType>::find_sink_location(const sink_pointers_type &sinks,
+                                             const sink_pointer_type &sink)
+    -> sink_iterator_type
 {
-    return std::find(sinks_.begin(), sinks_.end(), sink);
+    return std::find(sinks.begin(), sinks.end(), sink);
 }
 
 template <typename MessageType>
-template <typename Iterator>
-auto logger<MessageType>::find_sink_location(string_view_type name) -> Iterator
+auto logger<MessageType>::find_sink_location(const sink_pointers_type &sinks,
+                                             string_view_type name)
+    -> sink_iterator_type
 {
-    return std::find_if(sinks_.begin(), sinks_.end(),
+    return std::find_if(sinks.begin(), sinks.end(),
                         [&](const sink_pointer_type &sink) -> bool
                         { return sink->name() == name; });
 }
 
+template <typename MessageType>
+bool logger<MessageType>::is_synchronous() const noexcept
+{
+    return is_synchronous_.load(std::memory_order_relaxed);
+}
+
 template <typename MessageType>
 void logger<MessageType>::mark_as_destroy() noexcept
 {
@@ -230,6 +398,11 @@ template <typename MessageType>
 template <typename... Args>
 void logger<MessageType>::log(Args &&...args)
 {
+    if (!should_log_arguments(args...))
+    {
+        return;
+    }
+
     try
     {
         log_inner(std::forward<Args>(args)...);
@@ -249,6 +422,22 @@ void logger<MessageType>::log(Args &&...args)
     }
 }
 
+template <typename MessageType>
+template <log_level Level, typename... Args>
+void logger<MessageType>::log(Args &&...args)
+{
+    if constexpr (is_active_level(Level))
+    {
+        log(Level, std::forward<Args>(args)...);
+    }
+}
+
+template <typename MessageType>
+auto logger<MessageType>::level() const noexcept -> log_level
+{
+    return level_.load(std::memory_order_relaxed);
+}
+
 template <typename MessageType>
 template <typename... Args>
 void logger<MessageType>::log_inner(Args &&...args)
@@ -260,6 +449,13 @@ void logger<MessageType>::log_inner(Args &&...args)
             "It is illegal to log this logger anymore.");
     }
 
+    if (is_synchronous())
+    {
+        log_synchronously(message_type{std::forward<Args>(args)...});
+
+        return;
+    }
+
     auto dispatcher{dispatcher_.lock()};
 
     if (!dispatcher)
@@ -268,20 +464,83 @@ void logger<MessageType>::log_inner(Args &&...args)
     }
 
     auto message_pack{logency::make_message_pack<message_type>(
-        name_, message_type{std::forward<Args>(args)...})};
+        id_, name_, message_type{std::forward<Args>(args)...})};
 
     if (!should_log(message_pack))
     {
+        filtered_.add();
         return;
     }
 
+    count_logged(message_pack->message);
+
+#if defined(LOGENCY_LATENCY)
+    message_pack->enqueued_at =
+        message_pack_base<message_type>::clock_type::now();
+#endif
+
     dispatcher->enqueue(this->shared_from_this(), std::move(message_pack));
 }
 
+template <typename MessageType>
+void logger<MessageType>::log_synchronously(const message_type &message)
+{
+    if (filter_ && !filter_(name_, message))
+    {
+        filtered_.add();
+        return;
+    }
+
+    count_logged(message);
+
+    const auto sinks{sinks_.read()};
+
+    for (const auto &sink : *sinks)
+    {
+        sink->log_synchronously(name_, message);
+    }
+}
+
 template <typename MessageType>
 auto logger<MessageType>::name() const noexcept -> string_type
 {
-    return *name_;
+    return string_type{name_};
+}
+
+template <typename MessageType>
+auto logger<MessageType>::id() const noexcept -> id_type
+{
+    return id_;
+}
+
+template <typename MessageType>
+auto logger<MessageType>::default_registry()
+    -> const std::shared_ptr<name_registry_type> &
+{
+    // Leaked on purpose, since the packs might be released after exit.
+    static const auto *const registry{
+        new std::shared_ptr<name_registry_type>{ // NOLINT(*-owning-memory)
+            std::make_shared<name_registry_type>()}};
+
+    return *registry;
+}
+
+template <typename MessageType>
+auto logger<MessageType>::stats() const noexcept -> logger_stats
+{
+    logger_stats result{};
+
+    result.logged = logged_.load();
+
+    for (std::size_t index{0U}; index < logged_by_level_.size(); ++index)
+    {
+        result.logged_by_level[index] = logged_by_level_[index].load();
+        result.logged += result.logged_by_level[index];
+    }
+
+    result.filtered = filtered_.load();
+
+    return result;
 }
 
 template <typename MessageType>
@@ -291,6 +550,18 @@ void logger<MessageType>::set_error_handler(error_handler_type handler)
     error_handler_ = std::move(handler);
 }
 
+template <typename MessageType>
+void logger<MessageType>::set_level(log_level level) noexcept
+{
+    level_.store(level, std::memory_order_relaxed);
+}
+
+template <typename MessageType>
+void logger<MessageType>::set_synchronous(bool synchronous) noexcept
+{
+    is_synchronous_.store(synchronous, std::memory_order_relaxed);
+}
+
 template <typename MessageType>
 void logger<MessageType>::set_filter(filter_type filter)
 {
@@ -300,7 +571,35 @@ void logger<MessageType>::set_filter(filter_type filter)
 template <typename MessageType>
 bool logger<MessageType>::should_log(const message_pack_type &pack)
 {
-    return (filter_ ? filter_(name(), pack->message) : true);
+    return (filter_ ? filter_(name_, pack->message) : true);
+}
+
+template <typename MessageType>
+bool logger<MessageType>::should_log(log_level level) const noexcept
+{
+    return is_active_level(level) &&
+           (level >= level_.load(std::memory_order_relaxed));
+}
+
+template <typename MessageType>
+template <typename First, typename... Rest>
+bool logger<MessageType>::should_log_arguments(const First &first,
+                                               const Rest &.../*rest*/) const
+{
+    if constexpr (std::is_same_v<First, log_level>)
+    {
+        return should_log(first);
+    }
+    else
+    {
+        return true;
+    }
+}
+
+template <typename MessageType>
+bool logger<MessageType>::should_log_arguments() const noexcept
+{
+    return true;
 }
 
 } // namespace logency
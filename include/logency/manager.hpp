@@ -2,16 +2,25 @@
 #define LOGENCY_INCLUDE_LOGENCY_MANAGER_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/core/stats.hpp"
+#include "logency/detail/string/name_registry.hpp"
 #include "logency/detail/thread/thread_pool.hpp"
 #include "logency/dispatcher.hpp"
 #include "logency/logger.hpp"
 #include "logency/sink.hpp"
 #include "logency/sink_module/module_interface.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace logency
 {
@@ -60,6 +69,17 @@ public:
      */
     explicit manager(size_t thread_number);
 
+    /**
+     * \brief Initializes a new instance of the manager class with specified
+     * \a thread_number and dispatcher \a option.
+     *
+     * \param thread_number Specified thread.
+     * \param option Option of the dispatcher, e.g. which queue it uses and
+     * how many dispatchers to shard the loggers into.
+     * \throw logency::runtime_error if dispatcher_option::shard_count is 0.
+     */
+    manager(size_t thread_number, dispatcher_option option);
+
     /**
      * \brief Destroy the instance of the manager class.
      *
@@ -193,6 +213,28 @@ public:
                                 std::unique_ptr<sink_module_type> module)
         -> std::shared_ptr<sink_type>;
 
+    /**
+     * \brief Create a sink with a bounded queue, or on its own thread.
+     *
+     * With sink_option::dedicated_thread, the sink is operated by a thread
+     * created for it, which applies sink_option::thread. Otherwise it shares
+     * the thread pool of the manager.
+     *
+     * \param name Specified name for the sink.
+     * \param option Capacity and overflow policy of the sink queue.
+     * \param module Sink module of the sink.
+     * \return Requested pointer point to the sink.
+     * \throw logency::runtime_error If the name has already assigned.
+     * \throw logency::system_error If it failed to create the dedicated
+     * thread or to apply its option.
+     *
+     * \sa sink_option
+     */
+    [[nodiscard]] auto new_sink(string_view_type name,
+                                const sink_option &option,
+                                std::unique_ptr<sink_module_type> module)
+        -> std::shared_ptr<sink_type>;
+
     /**
      * \brief Check if the sink container has the requested sink named \a name.
      *
@@ -237,28 +279,84 @@ public:
 
     void set_error_handler(error_handler_type handler);
 
+    /**
+     * \brief Get the counters of the loggers, the sinks, the dispatchers and
+     * the thread pool.
+     *
+     * The counters are relaxed atomics, so reading them never blocks logging.
+     * Only listing the loggers and the sinks takes the locks of the manager.
+     */
+    [[nodiscard]] auto stats() -> manager_stats<string_type>;
+
+#if defined(LOGENCY_LATENCY)
+    /**
+     * \brief Get the latencies of each sink, by pipeline stage.
+     *
+     * Only available if \c LOGENCY_LATENCY is defined.
+     */
+    [[nodiscard]] auto latency()
+        -> std::vector<std::pair<string_type, sink_latency_stats>>;
+#endif
+
     void wait_until_idle();
 
 private:
     using dispatcher_type = dispatcher<message_type>;
     using thread_pool_type = detail::thread::thread_pool;
+    using name_registry_type = detail::string::name_registry<string_type>;
+    /**
+     * The maps are keyed by the interned names, so looking them up by
+     * `string_view_type` does not allocate.
+     */
     using logger_map =
-        std::unordered_map<string_type, std::shared_ptr<logger_type>>;
+        std::unordered_map<string_view_type, std::shared_ptr<logger_type>>;
     using sink_map =
-        std::unordered_map<string_type, std::shared_ptr<sink_type>>;
+        std::unordered_map<string_view_type, std::shared_ptr<sink_type>>;
+    using thread_pool_list = std::vector<std::weak_ptr<thread_pool_type>>;
     using queue_type =
         detail::thread::blocking_queue<std::shared_ptr<message_type>>;
     using mutex_type = std::mutex;
     template <typename MutexType>
     using lock_type = std::scoped_lock<MutexType>;
 
+    /**
+     * Owns the dedicated thread pool of a sink, so the pool lives as long as
+     * the sink does, even after the sink is deleted from the manager.
+     */
+    struct dedicated_sink_deleter
+    {
+        void operator()(sink_type *sink) noexcept;
+
+        std::shared_ptr<thread_pool_type> thread_pool;
+    };
+
+    static auto make_dispatchers(
+        const std::shared_ptr<thread_pool_type> &thread_pool,
+        const dispatcher_option &option)
+        -> std::vector<std::shared_ptr<dispatcher_type>>;
+
+    /**
+     * Hand the dispatchers out in turn. Called with `logger_map_mutex_`.
+     */
+    [[nodiscard]] auto select_dispatcher()
+        -> const std::shared_ptr<dispatcher_type> &;
+
+    /**
+     * Declared first to be destroyed last. The loggers, the sinks and their
+     * message packs refer to it.
+     */
+    std::shared_ptr<name_registry_type> names_{
+        std::make_shared<name_registry_type>()};
+
     std::shared_ptr<thread_pool_type> thread_pool_;
-    std::shared_ptr<dispatcher_type> dispatcher_;
+    std::vector<std::shared_ptr<dispatcher_type>> dispatchers_;
 
     logger_map logger_map_{};
+    std::size_t logger_counter_{0U}; //!< Guarded by `logger_map_mutex_`.
     mutex_type logger_map_mutex_{};
 
     sink_map sink_map_{};
+    thread_pool_list dedicated_threads_{}; //!< Guarded by `sink_map_mutex_`.
     mutex_type sink_map_mutex_{};
 
     error_handler_type error_handler_{};
@@ -272,8 +370,15 @@ inline manager<MessageType>::manager() : manager{1U}
 
 template <typename MessageType>
 inline manager<MessageType>::manager(size_t thread_number)
+    : manager{thread_number, dispatcher_option{}}
+{
+}
+
+template <typename MessageType>
+inline manager<MessageType>::manager(size_t thread_number,
+                                     dispatcher_option option)
     : thread_pool_{std::make_shared<thread_pool_type>(thread_number)},
-      dispatcher_{std::make_shared<dispatcher_type>(thread_pool_)}
+      dispatchers_{make_dispatchers(thread_pool_, option)}
 {
 }
 
@@ -296,7 +401,7 @@ inline void manager<MessageType>::delete_logger(string_view_type name)
 {
     lock_type<mutex_type> lock{logger_map_mutex_};
 
-    auto where = logger_map_.find(string_type{name});
+    auto where = logger_map_.find(name);
 
     if (where == logger_map_.end())
     {
@@ -312,13 +417,14 @@ inline void manager<MessageType>::delete_sink(string_view_type name)
 {
     lock_type<mutex_type> lock{sink_map_mutex_};
 
-    auto where = sink_map_.find(string_type{name});
+    auto where = sink_map_.find(name);
 
     if (where == sink_map_.end())
     {
         throw logency::runtime_error("No such name in the manager.");
     }
 
+    // A dedicated thread is kept by the sink, which might still be used.
     sink_map_.erase(where);
 }
 
@@ -328,8 +434,7 @@ inline auto manager<MessageType>::find_logger(string_view_type name)
 {
     lock_type<mutex_type> lock{logger_map_mutex_};
 
-    if (auto where{logger_map_.find(string_type{name})};
-        where != logger_map_.end())
+    if (auto where{logger_map_.find(name)}; where != logger_map_.end())
     {
         return where->second;
     }
@@ -343,7 +448,7 @@ inline auto manager<MessageType>::find_sink(string_view_type name)
 {
     lock_type<mutex_type> lock{sink_map_mutex_};
 
-    if (auto where{sink_map_.find(string_type{name})}; where != sink_map_.end())
+    if (auto where{sink_map_.find(name)}; where != sink_map_.end())
     {
         return where->second;
     }
@@ -351,22 +456,66 @@ inline auto manager<MessageType>::find_sink(string_view_type name)
     return nullptr;
 }
 
+#if defined(LOGENCY_LATENCY)
+template <typename MessageType>
+inline auto manager<MessageType>::latency()
+    -> std::vector<std::pair<string_type, sink_latency_stats>>
+{
+    lock_type<mutex_type> lock{sink_map_mutex_};
+
+    std::vector<std::pair<string_type, sink_latency_stats>> result;
+    result.reserve(sink_map_.size());
+
+    for (const auto &sink : sink_map_)
+    {
+        result.emplace_back(string_type{sink.first}, sink.second->latency());
+    }
+
+    return result;
+}
+#endif
+
+template <typename MessageType>
+inline auto manager<MessageType>::make_dispatchers(
+    const std::shared_ptr<thread_pool_type> &thread_pool,
+    const dispatcher_option &option)
+    -> std::vector<std::shared_ptr<dispatcher_type>>
+{
+    if (option.shard_count == 0U)
+    {
+        throw logency::runtime_error("'shard_count' is invalid.");
+    }
+
+    std::vector<std::shared_ptr<dispatcher_type>> dispatchers;
+    dispatchers.reserve(option.shard_count);
+
+    for (std::size_t index{0U}; index < option.shard_count; ++index)
+    {
+        dispatchers.push_back(
+            std::make_shared<dispatcher_type>(thread_pool, option));
+    }
+
+    return dispatchers;
+}
+
 template <typename MessageType>
 inline auto manager<MessageType>::new_logger(string_view_type name)
     -> std::shared_ptr<logger_type>
 {
     lock_type<mutex_type> lock{logger_map_mutex_};
 
-    auto result{logger_map_.try_emplace(
-        string_type{name},
-        std::make_unique<logger_type>(string_type{name}, dispatcher_))};
-
-    if (!result.second)
+    if (logger_map_.find(name) != logger_map_.end())
     {
         throw logency::runtime_error(
             "Already assigned a logger with the same name.");
     }
 
+    const auto id{names_->intern(name)};
+
+    auto result{logger_map_.try_emplace(
+        names_->resolve(id),
+        std::make_unique<logger_type>(names_, name, select_dispatcher()))};
+
     if (error_handler_)
     {
         result.first->second->set_error_handler(error_handler_);
@@ -394,20 +543,106 @@ manager<MessageType>::new_sink(string_view_type name,
                                std::unique_ptr<sink_module_type> module)
     -> std::shared_ptr<sink_type>
 {
-    lock_type<mutex_type> lock{sink_map_mutex_};
+    return new_sink(name, sink_option{}, std::move(module));
+}
 
-    auto result{sink_map_.try_emplace(
-        string_type{name},
-        std::make_unique<sink<message_type>>(string_type{name},
-                                             std::move(module), thread_pool_))};
+template <typename MessageType>
+inline auto
+manager<MessageType>::new_sink(string_view_type name, const sink_option &option,
+                               std::unique_ptr<sink_module_type> module)
+    -> std::shared_ptr<sink_type>
+{
+    lock_type<mutex_type> lock{sink_map_mutex_};
 
-    if (!result.second)
+    if (sink_map_.find(name) != sink_map_.end())
     {
         throw logency::runtime_error(
             "Already assigned a sink with the same name.");
     }
 
-    return result.first->second;
+    const auto key{names_->resolve(names_->intern(name))};
+
+    if (!option.dedicated_thread)
+    {
+        auto result{sink_map_.try_emplace(
+            key, std::make_unique<sink<message_type>>(
+                     string_type{name}, std::move(module), option,
+                     thread_pool_))};
+
+        return result.first->second;
+    }
+
+    auto thread_pool{std::make_shared<thread_pool_type>(1U, option.thread)};
+
+    if (error_handler_)
+    {
+        thread_pool->set_error_handler(error_handler_);
+    }
+
+    // Forget the pools of the released sinks.
+    dedicated_threads_.erase(
+        std::remove_if(dedicated_threads_.begin(), dedicated_threads_.end(),
+                       [](const auto &pool) { return pool.expired(); }),
+        dedicated_threads_.end());
+    dedicated_threads_.reserve(dedicated_threads_.size() + 1U);
+
+    auto created{std::make_unique<sink<message_type>>(
+        string_type{name}, std::move(module), option, thread_pool)};
+
+    // The deleter is called if it throws.
+    std::shared_ptr<sink_type> result{created.release(),
+                                      dedicated_sink_deleter{thread_pool}};
+
+    sink_map_.try_emplace(key, result);
+    dedicated_threads_.push_back(thread_pool);
+
+    return result;
+}
+
+template <typename MessageType>
+void manager<MessageType>::dedicated_sink_deleter::operator()(
+    sink_type *sink) noexcept
+{
+    delete sink; // NOLINT(cppcoreguidelines-owning-memory)
+
+    if (!thread_pool->is_worker_thread())
+    {
+        thread_pool.reset();
+        return;
+    }
+
+    // Released by its own thread, which cannot join itself. Hand the pool to
+    // another thread. If that fails, the pool is leaked and stays parked.
+    auto *released{new (std::nothrow) std::shared_ptr<thread_pool_type>{
+        std::move(thread_pool)}};
+
+    if (released == nullptr)
+    {
+        return;
+    }
+
+    try
+    {
+        std::thread{[released]
+                    {
+                        delete released; // NOLINT(*-owning-memory)
+                    }}
+            .detach();
+    }
+    catch (const std::system_error &)
+    {
+    }
+}
+
+template <typename MessageType>
+inline auto manager<MessageType>::select_dispatcher()
+    -> const std::shared_ptr<dispatcher_type> &
+{
+    /**
+     * Not by the name ID. The sinks take IDs from the same registry, so the
+     * IDs of the loggers might all fall on the same shard.
+     */
+    return dispatchers_[logger_counter_++ % dispatchers_.size()];
 }
 
 template <typename MessageType>
@@ -418,16 +653,86 @@ inline void manager<MessageType>::set_error_handler(error_handler_type handler)
 
     thread_pool_->set_error_handler(error_handler_);
 
+    {
+        lock_type<mutex_type> sink_lock{sink_map_mutex_};
+
+        for (const auto &dedicated : dedicated_threads_)
+        {
+            if (auto thread_pool{dedicated.lock()})
+            {
+                thread_pool->set_error_handler(error_handler_);
+            }
+        }
+    }
+
     for (auto &logger : logger_map_)
     {
         logger.second->set_error_handler(error_handler_);
     }
 }
 
+template <typename MessageType>
+inline auto manager<MessageType>::stats() -> manager_stats<string_type>
+{
+    manager_stats<string_type> result{};
+
+    {
+        lock_type<mutex_type> lock{logger_map_mutex_};
+
+        result.loggers.reserve(logger_map_.size());
+        for (const auto &logger : logger_map_)
+        {
+            result.loggers.emplace_back(string_type{logger.first},
+                                        logger.second->stats());
+        }
+    }
+
+    {
+        lock_type<mutex_type> lock{sink_map_mutex_};
+
+        result.sinks.reserve(sink_map_.size());
+        for (const auto &sink : sink_map_)
+        {
+            result.sinks.emplace_back(string_type{sink.first},
+                                      sink.second->stats());
+        }
+    }
+
+    result.dispatchers.reserve(dispatchers_.size());
+    for (const auto &dispatcher : dispatchers_)
+    {
+        result.dispatchers.push_back(dispatcher->stats());
+    }
+
+    result.thread_pool = thread_pool_->stats();
+
+    return result;
+}
+
 template <typename MessageType>
 inline void manager<MessageType>::wait_until_idle()
 {
+    // The shared pool feeds the dedicated threads, but not the other way.
     thread_pool_->wait_until_queue_empty();
+
+    std::vector<std::shared_ptr<thread_pool_type>> thread_pools;
+    {
+        lock_type<mutex_type> lock{sink_map_mutex_};
+
+        thread_pools.reserve(dedicated_threads_.size());
+        for (const auto &dedicated : dedicated_threads_)
+        {
+            if (auto thread_pool{dedicated.lock()})
+            {
+                thread_pools.push_back(std::move(thread_pool));
+            }
+        }
+    }
+
+    for (const auto &thread_pool : thread_pools)
+    {
+        thread_pool->wait_until_queue_empty();
+    }
 }
 
 } // namespace logency
@@ -0,0 +1,414 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_MESSAGE_DEFERRED_FMT_MESSAGE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_MESSAGE_DEFERRED_FMT_MESSAGE_HPP_
+
+#include "log_level.hpp"
+#include "message_formatter.hpp"
+#include "time.hpp"
+
+#include "fmt/core.h"
+#include "fmt/format.h"
+
+#include <cstddef>
+
+#include <chrono>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace logency::message
+{
+
+/**
+ * \brief This struct represent the fmt message which is formatted later.
+ *
+ * The constructor only copies the format string and the arguments. The
+ * formatting happens when the formatter of the sink module asks for the
+ * content, which is on the sink thread. The logging thread does not pay for
+ * fmt::format at all.
+ *
+ * \par Arguments
+ * Arguments are stored by value in an inline buffer, and on the heap when they
+ * do not fit. Strings (including `const char *` and string views) are copied
+ * into \c string_type, so the caller may release them right after logging.
+ * Other arguments must be copyable and must not refer to memory which might be
+ * released before the message is formatted.
+ *
+ * \par Format string
+ * Only the view of the format string is kept. Use a string literal, which is
+ * checked at compile time and lives for the whole program. Do not use
+ * fmt::runtime().
+ */
+struct deferred_fmt_message
+{
+    using value_type = char;
+    using traits_type = std::char_traits<value_type>;
+    using string_type = std::basic_string<value_type, traits_type>;
+    using string_view_type = std::basic_string_view<value_type, traits_type>;
+    using clock_type = std::chrono::system_clock;
+    using buffer_type = fmt::memory_buffer;
+
+    /**
+     * \brief Size of the inline buffer for the arguments in bytes.
+     */
+    static constexpr const std::size_t inline_size{64U};
+
+    explicit deferred_fmt_message(log_level level, string_view_type content);
+    explicit deferred_fmt_message(log_level level, string_type &&content);
+
+    template <typename... Args>
+    explicit deferred_fmt_message(log_level level,
+                                  fmt::format_string<Args...> fmt,
+                                  Args &&...args);
+
+    ~deferred_fmt_message();
+
+    deferred_fmt_message(const deferred_fmt_message &other);
+    deferred_fmt_message(deferred_fmt_message &&other) noexcept;
+    auto operator=(const deferred_fmt_message &other) -> deferred_fmt_message &;
+    auto operator=(deferred_fmt_message &&other) noexcept
+        -> deferred_fmt_message &;
+
+    /**
+     * \brief Format the content and append it to the buffer.
+     */
+    void format_to(buffer_type &buffer) const;
+
+    /**
+     * \brief Format the content.
+     */
+    [[nodiscard]] auto content() const -> string_type;
+
+    clock_type::time_point time;
+    log_level level;
+
+private:
+    /**
+     * Storage of the arguments. Either the arguments themselves, or the
+     * pointer to them on the heap.
+     */
+    union storage_type
+    {
+        alignas(std::max_align_t) std::byte buffer[inline_size]; // NOLINT
+        void *pointer;
+    };
+
+    struct operations_type
+    {
+        void (*format)(const storage_type &storage, fmt::string_view fmt,
+                       buffer_type &buffer);
+        void (*copy)(const storage_type &from, storage_type &to);
+        void (*move)(storage_type &from, storage_type &to) noexcept;
+        void (*destroy)(storage_type &storage) noexcept;
+    };
+
+    template <typename T>
+    using capture_type = std::conditional_t<
+        !std::is_arithmetic_v<std::decay_t<T>> &&
+            std::is_convertible_v<const std::decay_t<T> &, string_view_type>,
+        string_type, std::decay_t<T>>;
+
+    template <typename Tuple>
+    struct model;
+
+    void reset() noexcept;
+
+    fmt::string_view format_{};
+    const operations_type *operations_{nullptr};
+    storage_type storage_{};
+};
+
+/**
+ * \brief Stored arguments of one argument list.
+ *
+ * \tparam Tuple Tuple of the captured arguments.
+ */
+template <typename Tuple>
+struct deferred_fmt_message::model
+{
+    static constexpr const bool is_inline{
+        (sizeof(Tuple) <= inline_size) &&
+        (alignof(Tuple) <= alignof(std::max_align_t)) &&
+        std::is_nothrow_move_constructible_v<Tuple>};
+
+    static auto get(storage_type &storage) noexcept -> Tuple *
+    {
+        if constexpr (is_inline)
+        {
+            return std::launder(reinterpret_cast<Tuple *>(storage.buffer));
+        }
+        else
+        {
+            return static_cast<Tuple *>(storage.pointer);
+        }
+    }
+
+    static auto get(const storage_type &storage) noexcept -> const Tuple *
+    {
+        return get(const_cast<storage_type &>(storage)); // NOLINT
+    }
+
+    template <typename... Args>
+    static void construct(storage_type &storage, Args &&...args)
+    {
+        if constexpr (is_inline)
+        {
+            ::new (static_cast<void *>(storage.buffer))
+                Tuple{std::forward<Args>(args)...};
+        }
+        else
+        {
+            storage.pointer = new Tuple{std::forward<Args>(args)...};
+        }
+    }
+
+    static void format(const storage_type &storage, fmt::string_view fmt,
+                       buffer_type &buffer)
+    {
+        std::apply(
+            [&](const auto &...args)
+            {
+                fmt::vformat_to(std::back_inserter(buffer), fmt,
+                                fmt::make_format_args(args...));
+            },
+            *get(storage));
+    }
+
+    static void copy(const storage_type &from, storage_type &to)
+    {
+        construct(to, *get(from));
+    }
+
+    static void move(storage_type &from, storage_type &to) noexcept
+    {
+        if constexpr (is_inline)
+        {
+            construct(to, std::move(*get(from)));
+            get(from)->~Tuple();
+        }
+        else
+        {
+            to.pointer = from.pointer;
+            from.pointer = nullptr;
+        }
+    }
+
+    static void destroy(storage_type &storage) noexcept
+    {
+        if constexpr (is_inline)
+        {
+            get(storage)->~Tuple();
+        }
+        else
+        {
+            delete get(storage);
+        }
+    }
+
+    static constexpr const operations_type operations{&format, &copy, &move,
+                                                      &destroy};
+};
+
+struct deferred_fmt_stringifier
+{
+    using message_type = deferred_fmt_message;
+    using value_type = typename message_type::value_type;
+    using traits_type = typename message_type::traits_type;
+    using string_type = typename message_type::string_type;
+    using string_view_type = typename message_type::string_view_type;
+    using clock_type = typename message_type::clock_type;
+    using buffer_type = typename message_type::buffer_type;
+
+    [[nodiscard]] static auto format(string_view_type logger,
+                                     const message_type &message)
+        -> string_type;
+    [[nodiscard]] static auto format_first(string_view_type logger,
+                                           const message_type &message)
+        -> string_type;
+    [[nodiscard]] static auto format_second(string_view_type logger,
+                                            const message_type &message)
+        -> string_type;
+    [[nodiscard]] static auto format_third(string_view_type logger,
+                                           const message_type &message)
+        -> string_type;
+
+    /**
+     * \brief Same as format(), but append the output to the \a buffer.
+     */
+    static void format_to(buffer_type &buffer, string_view_type logger,
+                          const message_type &message);
+};
+
+inline deferred_fmt_message::deferred_fmt_message(log_level level,
+                                                  string_view_type content)
+    : deferred_fmt_message{level, "{}", content}
+{
+}
+
+inline deferred_fmt_message::deferred_fmt_message(log_level level,
+                                                  string_type &&content)
+    : deferred_fmt_message{level, "{}", std::move(content)}
+{
+}
+
+template <typename... Args>
+deferred_fmt_message::deferred_fmt_message(log_level level,
+                                           fmt::format_string<Args...> fmt,
+                                           Args &&...args)
+    : time{clock_type::now()}, level{level},
+      format_{static_cast<fmt::string_view>(fmt)}
+{
+    using model_type = model<std::tuple<capture_type<Args>...>>;
+
+    model_type::construct(storage_, std::forward<Args>(args)...);
+    operations_ = &model_type::operations;
+}
+
+inline deferred_fmt_message::~deferred_fmt_message()
+{
+    reset();
+}
+
+inline deferred_fmt_message::deferred_fmt_message(
+    const deferred_fmt_message &other)
+    : time{other.time}, level{other.level}, format_{other.format_}
+{
+    if (other.operations_ != nullptr)
+    {
+        other.operations_->copy(other.storage_, storage_);
+        operations_ = other.operations_;
+    }
+}
+
+inline deferred_fmt_message::deferred_fmt_message(
+    deferred_fmt_message &&other) noexcept
+    : time{other.time}, level{other.level}, format_{other.format_}
+{
+    if (other.operations_ != nullptr)
+    {
+        other.operations_->move(other.storage_, storage_);
+        operations_ = std::exchange(other.operations_, nullptr);
+    }
+}
+
+inline auto deferred_fmt_message::operator=(const deferred_fmt_message &other)
+    -> deferred_fmt_message &
+{
+    if (this != &other)
+    {
+        *this = deferred_fmt_message{other};
+    }
+
+    return *this;
+}
+
+inline auto deferred_fmt_message::operator=(
+    deferred_fmt_message &&other) noexcept -> deferred_fmt_message &
+{
+    if (this != &other)
+    {
+        reset();
+
+        time = other.time;
+        level = other.level;
+        format_ = other.format_;
+
+        if (other.operations_ != nullptr)
+        {
+            other.operations_->move(other.storage_, storage_);
+            operations_ = std::exchange(other.operations_, nullptr);
+        }
+    }
+
+    return *this;
+}
+
+inline auto deferred_fmt_message::content() const -> string_type
+{
+    buffer_type buffer;
+    format_to(buffer);
+
+    return fmt::to_string(buffer);
+}
+
+inline void deferred_fmt_message::format_to(buffer_type &buffer) const
+{
+    if (operations_ != nullptr)
+    {
+        operations_->format(storage_, format_, buffer);
+    }
+}
+
+inline void deferred_fmt_message::reset() noexcept
+{
+    if (operations_ != nullptr)
+    {
+        operations_->destroy(storage_);
+        operations_ = nullptr;
+    }
+}
+
+inline auto deferred_fmt_stringifier::format(string_view_type logger,
+                                             const message_type &message)
+    -> string_type
+{
+    buffer_type buffer;
+    format_to(buffer, logger, message);
+
+    return fmt::to_string(buffer);
+}
+
+inline void deferred_fmt_stringifier::format_to(buffer_type &buffer,
+                                               string_view_type logger,
+                                               const message_type &message)
+{
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
+
+    fmt::format_to(std::back_inserter(buffer), "[{}] [{:>8}] [{}] ", time,
+                   get_log_string<char>(message.level), logger);
+    message.format_to(buffer);
+    buffer.push_back('\n');
+}
+
+inline auto deferred_fmt_stringifier::format_first(string_view_type /*logger*/,
+                                                   const message_type &message)
+    -> string_type
+{
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
+
+    return fmt::format("[{}] ", time);
+}
+
+inline auto deferred_fmt_stringifier::format_second(
+    string_view_type /*logger*/, const message_type &message) -> string_type
+{
+    return fmt::format("[{:>8}]", get_log_string<char>(message.level));
+}
+
+inline auto deferred_fmt_stringifier::format_third(string_view_type logger,
+                                                   const message_type &message)
+    -> string_type
+{
+    buffer_type buffer;
+
+    fmt::format_to(std::back_inserter(buffer), " [{}] ", logger);
+    message.format_to(buffer);
+    buffer.push_back('\n');
+
+    return fmt::to_string(buffer);
+}
+
+using deferred_fmt_message_formatter =
+    buffer_message_formatter_base<deferred_fmt_message,
+                                  deferred_fmt_stringifier>;
+
+using deferred_fmt_color_message_formatter =
+    color_message_formatter_base<deferred_fmt_message,
+                                 deferred_fmt_stringifier>;
+
+} // namespace logency::message
+
+#endif // LOGENCY_INCLUDE_LOGENCY_MESSAGE_DEFERRED_FMT_MESSAGE_HPP_
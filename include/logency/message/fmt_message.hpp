@@ -5,10 +5,11 @@
 #include "message_formatter.hpp"
 #include "time.hpp"
 
-#include "fmt/chrono.h" // IWYU pragma: keep (fmt::format chrono)
 #include "fmt/core.h"
+#include "fmt/format.h"
 
 #include <chrono>
+#include <iterator>
 
 namespace logency::message
 {
@@ -45,6 +46,7 @@ struct fmt_stringifier
     using string_type = typename message_type::string_type;
     using string_view_type = typename message_type::string_view_type;
     using clock_type = typename message_type::clock_type;
+    using buffer_type = fmt::memory_buffer;
 
     [[nodiscard]] static auto format(string_view_type logger,
                                      const message_type &message)
@@ -58,6 +60,12 @@ struct fmt_stringifier
     [[nodiscard]] static auto format_third(string_view_type logger,
                                            const message_type &message)
         -> string_type;
+
+    /**
+     * \brief Same as format(), but append the output to the \a buffer.
+     */
+    static void format_to(buffer_type &buffer, string_view_type logger,
+                          const message_type &message);
 };
 
 inline fmt_message::fmt_message(log_level level, string_view_type content)
@@ -89,25 +97,31 @@ inline auto fmt_stringifier::format(string_view_type logger,
      * performance if we do it once.
      */
 
-    const int milliseconds{get_ms(message.time)};
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
+
+    return fmt::format("[{}] [{:>8}] [{}] {}\n", time,
+                       get_log_string<char>(message.level), logger,
+                       message.content);
+}
+
+inline void fmt_stringifier::format_to(buffer_type &buffer,
+                                      string_view_type logger,
+                                      const message_type &message)
+{
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
 
-    return fmt::format(
-        "[{0:%F %H:%M:%S}.{1:03}] [{2:>8}] [{3}] {4}\n",
-        std::chrono::time_point_cast<std::chrono::seconds>(message.time),
-        milliseconds, get_log_string<char>(message.level), logger,
-        message.content);
+    fmt::format_to(std::back_inserter(buffer), "[{}] [{:>8}] [{}] {}\n", time,
+                   get_log_string<char>(message.level), logger,
+                   message.content);
 }
 
 inline auto fmt_stringifier::format_first(string_view_type /*logger*/,
                                           const message_type &message)
     -> string_type
 {
-    const int milliseconds{get_ms(message.time)};
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
 
-    return fmt::format(
-        "[{0:%F %H:%M:%S}.{1:03}] ",
-        std::chrono::time_point_cast<std::chrono::seconds>(message.time),
-        milliseconds);
+    return fmt::format("[{}] ", time);
 }
 
 inline auto fmt_stringifier::format_second(string_view_type /*logger*/,
@@ -125,7 +139,7 @@ inline auto fmt_stringifier::format_third(string_view_type logger,
 }
 
 using fmt_message_formatter =
-    message_formatter_base<fmt_message, fmt_stringifier>;
+    buffer_message_formatter_base<fmt_message, fmt_stringifier>;
 
 using fmt_color_message_formatter =
     color_message_formatter_base<fmt_message, fmt_stringifier>;
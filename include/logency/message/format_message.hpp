@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <format>
+#include <iterator>
 #include <vector>
 
 namespace logency::message
@@ -45,6 +46,13 @@ struct format_stringifier
     using string_type = typename message_type::string_type;
     using string_view_type = typename message_type::string_view_type;
     using clock_type = typename message_type::clock_type;
+    using buffer_type = string_type;
+
+    /**
+     * \brief The time is written in UTC, like std::format does for
+     * std::chrono::sys_time.
+     */
+    using timestamp_type = timestamp_cache<value_type, time_zone::utc>;
 
     [[nodiscard]] static auto format(string_view_type logger,
                                      const message_type &message)
@@ -58,6 +66,12 @@ struct format_stringifier
     [[nodiscard]] static auto format_third(string_view_type logger,
                                            const message_type &message)
         -> string_type;
+
+    /**
+     * \brief Same as format(), but append the output to the \a buffer.
+     */
+    static void format_to(buffer_type &buffer, string_view_type logger,
+                          const message_type &message);
 };
 
 inline format_message::format_message(log_level level, string_view_type content)
@@ -89,25 +103,31 @@ inline auto format_stringifier::format(string_view_type logger,
      * the string value, which is likely to happen). It will speed up the
      * performance if we do it once.
      */
-    const int milliseconds{get_ms(message.time)};
+    const auto time{timestamp_type::local().format(message.time)};
+
+    return std::format("[{}] [{:>8}] [{}] {}\n", time,
+                       get_log_string<char>(message.level), logger,
+                       message.content);
+}
+
+inline void format_stringifier::format_to(buffer_type &buffer,
+                                         string_view_type logger,
+                                         const message_type &message)
+{
+    const auto time{timestamp_type::local().format(message.time)};
 
-    return std::format(
-        "[{0:%F %H:%M:%S}.{1:03}] [{2:>8}] [{3}] {4}\n",
-        std::chrono::time_point_cast<std::chrono::seconds>(message.time),
-        milliseconds, get_log_string<char>(message.level), logger,
-        message.content);
+    std::format_to(std::back_inserter(buffer), "[{}] [{:>8}] [{}] {}\n", time,
+                   get_log_string<char>(message.level), logger,
+                   message.content);
 }
 
 inline auto format_stringifier::format_first(string_view_type /*logger*/,
                                              const message_type &message)
     -> string_type
 {
-    const int milliseconds{get_ms(message.time)};
+    const auto time{timestamp_type::local().format(message.time)};
 
-    return std::format(
-        "[{0:%F %H:%M:%S}.{1:03}] ",
-        std::chrono::time_point_cast<std::chrono::seconds>(message.time),
-        milliseconds);
+    return std::format("[{}] ", time);
 }
 
 inline auto format_stringifier::format_second(string_view_type /*logger*/,
@@ -125,7 +145,7 @@ inline auto format_stringifier::format_third(string_view_type logger,
 }
 
 using format_message_formatter =
-    message_formatter_base<format_message, format_stringifier>;
+    buffer_message_formatter_base<format_message, format_stringifier>;
 
 using format_color_message_formatter =
     color_message_formatter_base<format_message, format_stringifier>;
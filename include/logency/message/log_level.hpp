@@ -6,6 +6,8 @@
 
 #include <array>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace logency
 {
@@ -23,6 +25,49 @@ enum class log_level : int
     critical = 5 //!< Warn user that something really bad happened.
 };
 
+/**
+ * \brief Least critical level compiled in, as the integer value of log_level.
+ *
+ * Define it before including logency, e.g. \c -DLOGENCY_ACTIVE_LEVEL=2, to
+ * compile trace and debug calls of logger::log<Level>() to nothing.
+ */
+#if !defined(LOGENCY_ACTIVE_LEVEL)
+    #define LOGENCY_ACTIVE_LEVEL 0
+#endif
+
+static_assert((LOGENCY_ACTIVE_LEVEL >= 0) && (LOGENCY_ACTIVE_LEVEL <= 5),
+              "LOGENCY_ACTIVE_LEVEL should be a value of log_level.");
+
+constexpr const log_level active_level{
+    static_cast<log_level>(LOGENCY_ACTIVE_LEVEL)};
+
+/**
+ * \brief Tell whether the level is compiled in.
+ */
+constexpr bool is_active_level(log_level level) noexcept
+{
+    return level >= active_level;
+}
+
+/**
+ * \brief Tell whether the message type \a T has a public \c level member of
+ * log_level.
+ */
+template <typename T, typename = void>
+struct has_log_level : std::false_type
+{
+};
+
+template <typename T>
+struct has_log_level<T, std::void_t<decltype(std::declval<const T &>().level)>>
+    : std::is_same<std::decay_t<decltype(std::declval<const T &>().level)>,
+                   log_level>
+{
+};
+
+template <typename T>
+constexpr const bool has_log_level_v{has_log_level<T>::value};
+
 constexpr const std::array<std::string_view, 6> log_string{
     {"trace", "debug", "info", "warning", "error", "critical"}};
 constexpr const std::array<std::wstring_view, 6> log_wstring{
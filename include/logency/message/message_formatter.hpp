@@ -5,6 +5,8 @@
 
 #include "logency/sink_module/color_output.hpp"
 
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace logency::message
@@ -28,6 +30,83 @@ private:
     stringifier_type stringifier{};
 };
 
+/**
+ * \brief This class represent the formatter which also appends its output into
+ * a reusable buffer.
+ *
+ * The stringifier should provide \c buffer_type and a static
+ * `format_to(buffer_type &, string_view_type, const message_type &)`.
+ */
+template <typename MessageType, typename StringifierType>
+class buffer_message_formatter_base
+    : public message_formatter_base<MessageType, StringifierType>
+{
+    using base_type = message_formatter_base<MessageType, StringifierType>;
+
+public:
+    using message_type = typename base_type::message_type;
+    using string_view_type = typename base_type::string_view_type;
+    using stringifier_type = typename base_type::stringifier_type;
+    using buffer_type = typename stringifier_type::buffer_type;
+
+    /**
+     * \brief Append the formatted message to the \a buffer.
+     */
+    void format_to(buffer_type &buffer, string_view_type logger,
+                   const message_type &message) const;
+};
+
+/**
+ * \brief Tell how a sink module should use the formatter.
+ *
+ * \c is_buffered is true when the formatter defines \c buffer_type and
+ * `format_to(buffer_type &, string_view_type, const message_type &)`. Sink
+ * modules prefer it to `operator()`, so they keep one buffer and reuse it
+ * for every message. Otherwise \c buffer_type is \c string_type and unused.
+ *
+ * \tparam Formatter Formatter type.
+ * \tparam MessageType Message type.
+ */
+template <typename Formatter, typename MessageType, typename = void>
+struct formatter_traits
+{
+    static constexpr const bool is_buffered{false};
+
+    using buffer_type = typename MessageType::string_type;
+
+    /**
+     * \brief Append the formatted \a message to the \a buffer with whichever
+     * the formatter provides.
+     */
+    static void format_to(Formatter &formatter, buffer_type &buffer,
+                          typename MessageType::string_view_type logger,
+                          const MessageType &message)
+    {
+        buffer.append(formatter(logger, message));
+    }
+};
+
+template <typename Formatter, typename MessageType>
+struct formatter_traits<
+    Formatter, MessageType,
+    std::void_t<typename Formatter::buffer_type,
+                decltype(std::declval<const Formatter &>().format_to(
+                    std::declval<typename Formatter::buffer_type &>(),
+                    std::declval<typename MessageType::string_view_type>(),
+                    std::declval<const MessageType &>()))>>
+{
+    static constexpr const bool is_buffered{true};
+
+    using buffer_type = typename Formatter::buffer_type;
+
+    static void format_to(Formatter &formatter, buffer_type &buffer,
+                          typename MessageType::string_view_type logger,
+                          const MessageType &message)
+    {
+        formatter.format_to(buffer, logger, message);
+    }
+};
+
 template <typename MessageType, typename StringifierType>
 class color_message_formatter_base
 {
@@ -64,6 +143,15 @@ inline auto message_formatter_base<MessageType, StringifierType>::operator()(
     return stringifier.format(logger, message);
 }
 
+template <typename MessageType, typename StringifierType>
+inline void
+buffer_message_formatter_base<MessageType, StringifierType>::format_to(
+    buffer_type &buffer, string_view_type logger,
+    const message_type &message) const
+{
+    stringifier_type::format_to(buffer, logger, message);
+}
+
 template <typename MessageType, typename StringifierType>
 inline auto
 color_message_formatter_base<MessageType, StringifierType>::operator()(
@@ -45,6 +45,7 @@ struct stream_stringifier
     using string_type = typename message_type::string_type;
     using string_view_type = typename message_type::string_view_type;
     using clock_type = typename message_type::clock_type;
+    using buffer_type = string_type;
 
     [[nodiscard]] static auto format(string_view_type logger,
                                      const message_type &message)
@@ -58,6 +59,12 @@ struct stream_stringifier
     [[nodiscard]] static auto format_third(string_view_type logger,
                                            const message_type &message)
         -> string_type;
+
+    /**
+     * \brief Same as format(), but append the output to the \a buffer.
+     */
+    static void format_to(buffer_type &buffer, string_view_type logger,
+                          const message_type &message);
 };
 
 template <typename CharT>
@@ -88,43 +95,66 @@ inline auto stream_stringifier<CharT>::format(string_view_type logger,
     return output;
 }
 
+template <typename CharT>
+inline void stream_stringifier<CharT>::format_to(buffer_type &buffer,
+                                                 string_view_type logger,
+                                                 const message_type &message)
+{
+    using size_type = typename string_type::size_type;
+
+    constexpr const size_type level_buffer_size{8};
+
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
+    const auto level{get_log_string<value_type>(message.level)};
+
+    buffer.push_back(static_cast<value_type>('['));
+    buffer.append(time);
+    buffer.push_back(static_cast<value_type>(']'));
+    buffer.push_back(static_cast<value_type>(' '));
+    buffer.push_back(static_cast<value_type>('['));
+
+    if (level.size() < level_buffer_size)
+    {
+        buffer.append(level_buffer_size - level.size(),
+                      static_cast<value_type>(' '));
+    }
+
+    buffer.append(level);
+    buffer.push_back(static_cast<value_type>(']'));
+    buffer.push_back(static_cast<value_type>(' '));
+    buffer.push_back(static_cast<value_type>('['));
+    buffer.append(logger);
+    buffer.push_back(static_cast<value_type>(']'));
+    buffer.push_back(static_cast<value_type>(' '));
+    buffer.append(message.content);
+    buffer.push_back(static_cast<value_type>('\n'));
+}
+
 template <>
 inline auto stream_stringifier<char>::format_first(string_view_type /*logger*/,
                                                    const message_type &message)
     -> string_type
 {
-    using size_type = string_type::size_type;
-
-    constexpr const size_type ms_buffer_size{3};
-
-    const auto tm_value{logency::message::get_tm(message.time)};
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
 
-    std::basic_stringstream<value_type> stream{};
-
-    stream << "[" << std::put_time(&tm_value, "%F %T") << "."
-           << std::setfill('0') << std::setw(ms_buffer_size)
-           << get_ms(message.time) << "] ";
+    string_type output{};
+    output.reserve(time.size() + 3U);
+    output.append("[").append(time).append("] ");
 
-    return stream.str();
+    return output;
 }
 
 template <>
 inline auto stream_stringifier<wchar_t>::format_first(
     string_view_type /*logger*/, const message_type &message) -> string_type
 {
-    using size_type = string_type::size_type;
-
-    constexpr const size_type ms_buffer_size{3};
+    const auto time{timestamp_cache<value_type>::local().format(message.time)};
 
-    const auto tm_value{logency::message::get_tm(message.time)};
+    string_type output{};
+    output.reserve(time.size() + 3U);
+    output.append(L"[").append(time).append(L"] ");
 
-    std::basic_stringstream<value_type> stream{};
-
-    stream << L"[" << std::put_time(&tm_value, L"%F %T") << L"."
-           << std::setfill(L'0') << std::setw(ms_buffer_size)
-           << get_ms(message.time) << L"] ";
-
-    return stream.str();
+    return output;
 }
 
 template <>
@@ -185,7 +215,8 @@ inline auto stream_stringifier<wchar_t>::format_third(
 
 template <typename CharT>
 using stream_message_formatter =
-    message_formatter_base<stream_message<CharT>, stream_stringifier<CharT>>;
+    buffer_message_formatter_base<stream_message<CharT>,
+                                  stream_stringifier<CharT>>;
 
 template <typename CharT>
 using stream_color_message_formatter =
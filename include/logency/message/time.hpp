@@ -3,17 +3,33 @@
 
 #include "logency/core/exception.hpp"
 
+#include <cstddef>
+
+#include <array>
 #include <chrono>
+#include <string_view>
 
 namespace logency::message
 {
 
+/**
+ * \brief Time zone of a formatted time point.
+ */
+enum class time_zone
+{
+    local,
+    utc
+};
+
 int get_ms(const std::chrono::system_clock::time_point &time_point);
 auto get_tm(const std::chrono::system_clock::time_point &time_point) -> std::tm;
+auto get_utc_tm(const std::chrono::system_clock::time_point &time_point)
+    -> std::tm;
 
 struct time_data
 {
-    explicit time_data(const std::chrono::system_clock::time_point &time_point);
+    explicit time_data(const std::chrono::system_clock::time_point &time_point,
+                       time_zone zone = time_zone::local);
 
     int year;
     int month;
@@ -24,14 +40,62 @@ struct time_data
     int millisecond;
 };
 
+/**
+ * \brief This class represent the cache of the formatted time point.
+ *
+ * The output looks like `2024-01-31 23:59:59.999`. The date and time part only
+ * changes once per second, so it is rebuilt when the second changes. Other
+ * time points only patch the milliseconds in.
+ *
+ * \note Years out of [0, 9999] are written with their last four digits.
+ *
+ * \tparam CharT Character type.
+ * \tparam Zone Time zone of the output.
+ */
+template <typename CharT, time_zone Zone = time_zone::local>
+class timestamp_cache
+{
+public:
+    using value_type = CharT;
+    using string_view_type = std::basic_string_view<value_type>;
+    using clock_type = std::chrono::system_clock;
+
+    static constexpr const std::size_t size{23U};
+
+    /**
+     * \brief The cache of the current thread.
+     */
+    [[nodiscard]] static auto local() -> timestamp_cache &;
+
+    /**
+     * \brief Format the time point in the time zone \a Zone.
+     *
+     * \return View to the cache. It is valid until the next call.
+     * \throw logency::system_error if the time cannot be parsed.
+     */
+    [[nodiscard]] auto format(const clock_type::time_point &time_point)
+        -> string_view_type;
+
+private:
+    using second_type =
+        std::chrono::time_point<clock_type, std::chrono::seconds>;
+
+    void write(std::size_t position, int value, std::size_t width) noexcept;
+
+    second_type second_{second_type::min()};
+    std::array<value_type, size> buffer_{};
+};
+
 inline time_data::time_data(
-    const std::chrono::system_clock::time_point &time_point)
+    const std::chrono::system_clock::time_point &time_point, time_zone zone)
     : millisecond{get_ms(time_point)}
 {
     constexpr const int year_base{1900};
     constexpr const int month_base{1};
 
-    std::tm tm_value{logency::message::get_tm(time_point)};
+    std::tm tm_value{zone == time_zone::utc
+                         ? logency::message::get_utc_tm(time_point)
+                         : logency::message::get_tm(time_point)};
 
     year = tm_value.tm_year + year_base;
     month = tm_value.tm_mon + month_base;
@@ -74,6 +138,40 @@ inline auto get_tm(const std::chrono::system_clock::time_point &time_point)
     return tm_value;
 }
 
+inline auto get_utc_tm(const std::chrono::system_clock::time_point &time_point)
+    -> std::tm
+{
+    auto time_value{std::chrono::system_clock::to_time_t(time_point)};
+    std::tm tm_value{};
+
+#if defined(__GNUC__) || defined(__GNUG__)
+    if (auto *result{gmtime_r(&time_value, &tm_value)}; result == NULL)
+    {
+        throw logency::system_error(
+            std::error_code{errno, std::generic_category()},
+            "Failed to parse std::tm");
+    }
+#elif defined(_MSC_VER)
+    if (auto result{gmtime_s(&tm_value, &time_value)}; result != 0)
+    {
+        throw logency::system_error(
+            std::error_code{result, std::generic_category()},
+            "Failed to parse std::tm");
+    }
+#else
+    auto *result{gmtime(&time_value)};
+    if (result == NULL)
+    {
+        throw logency::system_error(
+            std::error_code{errno, std::generic_category()},
+            "Failed to parse std::tm");
+    }
+    tm_value = *result;
+#endif
+
+    return tm_value;
+}
+
 inline int get_ms(const std::chrono::system_clock::time_point &time_point)
 {
     constexpr const int ms_unit{1000};
@@ -85,6 +183,61 @@ inline int get_ms(const std::chrono::system_clock::time_point &time_point)
         ms_unit);
 }
 
+template <typename CharT, time_zone Zone>
+auto timestamp_cache<CharT, Zone>::format(
+    const clock_type::time_point &time_point) -> string_view_type
+{
+    constexpr const int year_limit{10000};
+
+    if (const auto second{std::chrono::floor<std::chrono::seconds>(time_point)};
+        second != second_)
+    {
+        const time_data data{time_point, Zone};
+
+        write(0U, data.year % year_limit, 4U);
+        buffer_[4] = static_cast<value_type>('-');
+        write(5U, data.month, 2U);
+        buffer_[7] = static_cast<value_type>('-');
+        write(8U, data.day, 2U);
+        buffer_[10] = static_cast<value_type>(' ');
+        write(11U, data.hour, 2U);
+        buffer_[13] = static_cast<value_type>(':');
+        write(14U, data.minute, 2U);
+        buffer_[16] = static_cast<value_type>(':');
+        write(17U, data.second, 2U);
+        buffer_[19] = static_cast<value_type>('.');
+
+        second_ = second;
+    }
+
+    write(20U, get_ms(time_point), 3U);
+
+    return string_view_type{buffer_.data(), buffer_.size()};
+}
+
+template <typename CharT, time_zone Zone>
+auto timestamp_cache<CharT, Zone>::local() -> timestamp_cache &
+{
+    thread_local timestamp_cache cache{};
+
+    return cache;
+}
+
+template <typename CharT, time_zone Zone>
+void timestamp_cache<CharT, Zone>::write(std::size_t position, int value,
+                                         std::size_t width) noexcept
+{
+    constexpr const int base{10};
+
+    value = (value < 0) ? -value : value;
+
+    for (auto index{position + width}; index > position; --index)
+    {
+        buffer_[index - 1U] = static_cast<value_type>('0' + (value % base));
+        value /= base;
+    }
+}
+
 } // namespace logency::message
 
 #endif // LOGENCY_INCLUDE_LOGENCY_MESSAGE_TIME_HPP_
@@ -2,18 +2,28 @@
 #define LOGENCY_INCLUDE_LOGENCY_SINK_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/core/overflow_policy.hpp"
+#include "logency/core/stats.hpp"
+#include "logency/core/thread_option.hpp"
+#if defined(LOGENCY_LATENCY)
+    #include "logency/detail/latency_histogram.hpp"
+#endif
 #include "logency/detail/message_pack.hpp"
 #include "logency/detail/thread/blocking_queue.hpp"
+#include "logency/detail/thread/stats_counter.hpp"
 #include "logency/detail/thread/thread_pool.hpp"
+#include "logency/detail/thread/thread_unit_token.hpp"
 #include "logency/message/log_level.hpp"
 #include "logency/sink_module/module_interface.hpp"
 
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -21,6 +31,47 @@
 namespace logency
 {
 
+/**
+ * \brief Option of the sink.
+ */
+struct sink_option
+{
+    /**
+     * \brief Maximum message count of the sink queue. \c 0 means unbounded.
+     */
+    std::size_t capacity{0U};
+
+    /**
+     * \brief What to do when the queue is full.
+     *
+     * overflow_policy::block sinks the queued messages on the producing thread
+     * instead of waiting, since the producer might be the only thread of the
+     * thread pool. With dedicated_thread, the producer waits for the
+     * dedicated thread instead.
+     */
+    overflow_policy overflow{overflow_policy::block};
+
+    /**
+     * \brief Messages at or above this level are never dropped by
+     * overflow_policy::drop_by_level.
+     */
+    log_level keep_level{log_level::warning};
+
+    /**
+     * \brief Run the sink on its own thread instead of the shared thread
+     * pool of the manager.
+     *
+     * Use it for the slow sink, so it does not delay the others.
+     */
+    bool dedicated_thread{false};
+
+    /**
+     * \brief Option of the dedicated thread. Ignored without
+     * dedicated_thread.
+     */
+    thread_option thread{};
+};
+
 template <typename MessageType>
 class sink final : public std::enable_shared_from_this<sink<MessageType>>
 {
@@ -53,6 +104,18 @@ public:
                   size_type reserve_size,
                   std::weak_ptr<thread_pool_type> thread_pool);
 
+    /**
+     * \brief Initializes a new instance of the sink class with a bounded
+     * queue.
+     *
+     * \exception logency::runtime_error overflow_policy::drop_by_level is
+     * requested but the message type has no level.
+     */
+    explicit sink(string_type &&name,
+                  std::unique_ptr<sink_module_type> sink_module,
+                  const sink_option &option,
+                  std::weak_ptr<thread_pool_type> thread_pool);
+
     sink(const sink &other) = delete;
     sink(sink &&other) noexcept = delete;
     auto operator=(const sink &other) -> sink & = delete;
@@ -87,6 +150,18 @@ public:
     template <typename Iterator>
     void log(Iterator begin, Iterator end);
 
+    /**
+     * \brief Write the \a message to the sink module on the calling thread.
+     *
+     * The filter is applied, and the module is flushed afterward. It takes the
+     * same lock as the thread pool does when it sinks the queue.
+     *
+     * \param logger Name of the logger.
+     * \param message Specified message.
+     */
+    void log_synchronously(string_view_type logger,
+                           const message_type &message);
+
     [[nodiscard]] auto sink_module() const noexcept -> const sink_module_type &;
     [[nodiscard]] auto sink_module() noexcept -> sink_module_type &;
 
@@ -96,6 +171,26 @@ public:
     [[nodiscard]] auto queue_size() -> size_type;
     [[nodiscard]] bool is_queue_empty();
 
+    /**
+     * \brief Count of the messages dropped by the overflow policy.
+     */
+    [[nodiscard]] auto dropped_count() const noexcept -> size_type;
+
+    /**
+     * \brief Get the counters of the sink. Lock free.
+     */
+    [[nodiscard]] auto stats() const noexcept -> sink_stats;
+
+#if defined(LOGENCY_LATENCY)
+    /**
+     * \brief Get the latencies of the messages written by the sink, by
+     * pipeline stage. Lock free.
+     *
+     * The messages logged in synchronous mode are not recorded.
+     */
+    [[nodiscard]] auto latency() const noexcept -> sink_latency_stats;
+#endif
+
 private:
     using mutex_type = std::mutex;
     template <typename MutexT>
@@ -104,23 +199,16 @@ private:
     template <typename T>
     using tray_type = typename queue_type::template container_type<T>;
 
-    class thread_unit_token
-        : public logency::detail::thread::thread_unit_interface
-    {
-    public:
-        using me_type = sink<MessageType>;
-        explicit thread_unit_token(std::shared_ptr<me_type> &&myself);
-
-    protected:
-        void operate_by_thread() final;
-
-    private:
-        std::shared_ptr<me_type> myself_{};
-    };
+    using thread_unit_token = detail::thread::thread_unit_token<sink>;
 
     template <typename Iterator>
     void log_message(Iterator begin, Iterator end);
 
+    static auto make_droppable(const sink_option &option) ->
+        typename queue_type::droppable_type;
+    auto make_full_handler(const sink_option &option) ->
+        typename queue_type::full_handler_type;
+
     [[nodiscard]] bool should_flush(const message_pack_type &pack);
     [[nodiscard]] bool should_log(const message_pack_type &pack);
 
@@ -129,6 +217,13 @@ private:
     void sink_message();
     void sink_message_from_tray(tray_type<message_pack_type> &tray);
 
+#if defined(LOGENCY_LATENCY)
+    using clock_type = typename message_pack_base<message_type>::clock_type;
+
+    template <typename Iterator>
+    void record_latency(Iterator begin, Iterator end);
+#endif
+
     queue_type queue_;
 
     //!< Keep it here to prevent deallocation
@@ -143,6 +238,27 @@ private:
     std::weak_ptr<thread_pool_type> thread_pool_;
 
     mutex_type queue_tray_mutex_{};
+
+    thread_unit_token token_{*this, &sink::sink_message};
+
+    /**
+     * `enqueued_` is written by the dispatching threads, and the others by
+     * the thread holding `queue_tray_mutex_`.
+     */
+    detail::thread::stats_counter enqueued_{};
+    detail::thread::stats_counter written_{};
+    detail::thread::stats_counter flush_count_{};
+    detail::thread::stats_counter error_count_{};
+
+#if defined(LOGENCY_LATENCY)
+    // Written under `queue_tray_mutex_`.
+    typename clock_type::time_point drained_at_{};
+
+    detail::latency_histogram dispatcher_queue_latency_{};
+    detail::latency_histogram sink_queue_latency_{};
+    detail::latency_histogram write_latency_{};
+    detail::latency_histogram end_to_end_latency_{};
+#endif
 };
 
 template <typename MessageType>
@@ -167,12 +283,34 @@ sink<MessageType>::sink(string_type &&name,
     }
 }
 
+template <typename MessageType>
+sink<MessageType>::sink(string_type &&name,
+                        std::unique_ptr<sink_module_type> sink_module,
+                        const sink_option &option,
+                        std::weak_ptr<thread_pool_type> thread_pool)
+    : queue_{0U, option.capacity, option.overflow, make_droppable(option),
+             make_full_handler(option)},
+      name_{std::move(name)}, sink_module_{std::move(sink_module)},
+      thread_pool_{std::move(thread_pool)}
+{
+    if (!sink_module_)
+    {
+        throw logency::runtime_error("No sink_module assigned.");
+    }
+}
+
 template <typename MessageType>
 sink<MessageType>::~sink()
 {
     sink_module_->flush();
 }
 
+template <typename MessageType>
+auto sink<MessageType>::dropped_count() const noexcept -> size_type
+{
+    return queue_.dropped();
+}
+
 template <typename MessageType>
 bool sink<MessageType>::is_queue_empty()
 {
@@ -205,6 +343,32 @@ void sink<MessageType>::log(Iterator begin, Iterator end)
     log_message(head, tail);
 }
 
+template <typename MessageType>
+void sink<MessageType>::log_synchronously(string_view_type logger,
+                                          const message_type &message)
+{
+    if (filter_ && !filter_(logger, message))
+    {
+        return;
+    }
+
+    lock_type<mutex_type> lock{queue_tray_mutex_};
+
+    try
+    {
+        sink_module_->log_message(logger, message);
+        written_.add();
+
+        sink_module_->flush();
+        flush_count_.add();
+    }
+    catch (...)
+    {
+        error_count_.add();
+        throw;
+    }
+}
+
 template <typename MessageType>
 template <typename Iterator>
 void sink<MessageType>::log_message(Iterator begin, Iterator end)
@@ -214,12 +378,62 @@ void sink<MessageType>::log_message(Iterator begin, Iterator end)
         return;
     }
 
+    enqueued_.add(static_cast<std::uint64_t>(std::distance(begin, end)));
+
     if (queue_.enqueue_bulk(begin, end))
     {
         notify_thread_pool();
     }
 }
 
+template <typename MessageType>
+auto sink<MessageType>::make_droppable(const sink_option &option) ->
+    typename queue_type::droppable_type
+{
+    if (option.overflow != overflow_policy::drop_by_level)
+    {
+        return {};
+    }
+
+    if constexpr (has_log_level_v<message_type>)
+    {
+        return [keep_level = option.keep_level](const message_pack_type &pack)
+        { return pack->message.level < keep_level; };
+    }
+    else
+    {
+        throw logency::runtime_error("Message type has no level to drop by.");
+    }
+}
+
+template <typename MessageType>
+auto sink<MessageType>::make_full_handler(const sink_option &option) ->
+    typename queue_type::full_handler_type
+{
+    // The dedicated thread drains the queue, so the producer can wait for it.
+    if (option.dedicated_thread)
+    {
+        return {};
+    }
+
+    return [this] { sink_message(); };
+}
+
+#if defined(LOGENCY_LATENCY)
+template <typename MessageType>
+auto sink<MessageType>::latency() const noexcept -> sink_latency_stats
+{
+    sink_latency_stats result{};
+
+    result.dispatcher_queue = dispatcher_queue_latency_.summary();
+    result.sink_queue = sink_queue_latency_.summary();
+    result.write = write_latency_.summary();
+    result.end_to_end = end_to_end_latency_.summary();
+
+    return result;
+}
+#endif
+
 template <typename MessageType>
 auto sink<MessageType>::name() const noexcept -> string_type
 {
@@ -229,8 +443,6 @@ auto sink<MessageType>::name() const noexcept -> string_type
 template <typename MessageType>
 void sink<MessageType>::notify_thread_pool()
 {
-    using token_type = thread_unit_token;
-
     auto pool{thread_pool_.lock()};
 
     if (!pool)
@@ -238,7 +450,7 @@ void sink<MessageType>::notify_thread_pool()
         throw logency::runtime_error("Thread pool does not exist any longer.");
     }
 
-    pool->enqueue(std::make_unique<token_type>(this->shared_from_this()));
+    token_.schedule(*pool);
 }
 
 template <typename MessageType>
@@ -253,6 +465,40 @@ auto sink<MessageType>::queue_size() -> size_type
     return queue_.size();
 }
 
+#if defined(LOGENCY_LATENCY)
+template <typename MessageType>
+template <typename Iterator>
+void sink<MessageType>::record_latency(Iterator begin, Iterator end)
+{
+    const auto written_at{clock_type::now()};
+    const typename clock_type::time_point unset{};
+
+    for (; begin != end; ++begin)
+    {
+        const auto &pack{**begin};
+
+        // Unset if the pack did not come through a logger or a dispatcher.
+        if (pack.dispatched_at != unset)
+        {
+            sink_queue_latency_.record(drained_at_ - pack.dispatched_at);
+
+            if (pack.enqueued_at != unset)
+            {
+                dispatcher_queue_latency_.record(pack.dispatched_at -
+                                                 pack.enqueued_at);
+            }
+        }
+
+        if (pack.enqueued_at != unset)
+        {
+            end_to_end_latency_.record(written_at - pack.enqueued_at);
+        }
+
+        write_latency_.record(written_at - drained_at_);
+    }
+}
+#endif
+
 template <typename MessageType>
 void sink<MessageType>::reserve(size_type size)
 {
@@ -303,6 +549,10 @@ void sink<MessageType>::sink_message()
         return;
     }
 
+#if defined(LOGENCY_LATENCY)
+    drained_at_ = clock_type::now();
+#endif
+
     sink_message_from_tray(queue_output_tray_);
 }
 
@@ -310,32 +560,68 @@ template <typename MessageType>
 void sink<MessageType>::sink_message_from_tray(
     tray_type<message_pack_type> &tray)
 {
-    auto pack{tray.begin()};
+    /*
+     * The tray is passed to the module in segments. A segment ends at the
+     * message which should be flushed, or at the end of the tray.
+     */
+    auto begin{tray.begin()};
+    auto end{begin};
+    bool is_written{false};
 
     try
     {
-        for (; pack != tray.end(); ++pack)
+        for (; begin != tray.end(); begin = end)
         {
-            const auto instance{*pack};
+            bool is_flush{false};
 
-            sink_module_->log_message(*(instance->logger_name),
-                                      instance->message);
+            while ((end != tray.end()) && !is_flush)
+            {
+                is_flush = should_flush(*end);
+                ++end;
+            }
+
+            is_written = false;
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            sink_module_->log_messages(&(*begin), &(*begin) + (end - begin));
+            written_.add(static_cast<std::uint64_t>(end - begin));
+            is_written = true;
 
-            if (should_flush(*pack))
+#if defined(LOGENCY_LATENCY)
+            record_latency(begin, end);
+#endif
+
+            if (is_flush)
             {
                 sink_module_->flush();
+                flush_count_.add();
             }
         }
     }
     catch (const std::exception &e)
     {
+        error_count_.add();
+
         /*
          * If it throws:
-         * 1. Erase the sink message in tray and keep the remaining one.
+         * 1. Erase the written messages and the failing one in tray, and keep
+         *    the remaining ones.
          * 2. Tell the thread pool that it still have some message here.
          * 3. Throw the exception to prevent the tray being cleared.
          */
-        tray.erase(tray.begin(), pack + 1);
+        auto failed{end};
+
+        if (!is_written)
+        {
+            const auto logged{
+                std::min(sink_module_->logged_messages(),
+                         static_cast<std::size_t>(end - begin) - 1U)};
+            written_.add(static_cast<std::uint64_t>(logged));
+
+            failed = std::next(begin, static_cast<std::ptrdiff_t>(logged + 1U));
+        }
+
+        tray.erase(tray.begin(), failed);
         notify_thread_pool();
 
         throw;
@@ -359,28 +645,31 @@ auto sink<MessageType>::sink_module() noexcept -> sink_module_type &
 }
 
 template <typename MessageType>
-bool sink<MessageType>::should_flush(const message_pack_type &pack)
+auto sink<MessageType>::stats() const noexcept -> sink_stats
 {
-    return (flusher_ ? flusher_(*(pack->logger_name), pack->message) : false);
-}
+    sink_stats result{};
 
-template <typename MessageType>
-bool sink<MessageType>::should_log(const message_pack_type &pack)
-{
-    return (filter_ ? filter_(*(pack->logger_name), pack->message) : true);
+    result.enqueued = enqueued_.load();
+    result.written = written_.load();
+    result.dropped = queue_.dropped();
+    result.bytes_written = sink_module_->written_bytes();
+    result.flush_count = flush_count_.load();
+    result.error_count = error_count_.load();
+    result.queue_high_water = queue_.high_water();
+
+    return result;
 }
 
 template <typename MessageType>
-sink<MessageType>::thread_unit_token::thread_unit_token(
-    std::shared_ptr<me_type> &&myself)
-    : myself_{std::move(myself)}
+bool sink<MessageType>::should_flush(const message_pack_type &pack)
 {
+    return (flusher_ ? flusher_(pack->logger_name, pack->message) : false);
 }
 
 template <typename MessageType>
-void sink<MessageType>::thread_unit_token::operate_by_thread()
+bool sink<MessageType>::should_log(const message_pack_type &pack)
 {
-    myself_->sink_message();
+    return (filter_ ? filter_(pack->logger_name, pack->message) : true);
 }
 
 } // namespace logency
@@ -2,12 +2,12 @@
 #define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_BASIC_FILE_MODULE_HPP_
 
 #include "logency/detail/file/basic_file.hpp"
+#include "logency/message/message_formatter.hpp"
 #include "module_interface.hpp"
 
 #include <cassert>
 
 #include <chrono>
-#include <functional>
 #include <string>
 #include <type_traits>
 
@@ -22,26 +22,36 @@ namespace logency::sink_module
  *
  * \tparam MessageType MessageType type.
  * \tparam Formatter Formatter type.
+ * \tparam File File type. It should provide the same constructors, \c write
+ * and \c flush as logency::detail::file::basic_file, e.g.
+ * logency::detail::file::posix_file.
  */
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter,
+          typename File = logency::detail::file::basic_file<
+              typename MessageType::value_type>>
 class basic_file_module : public module_interface<MessageType>
 {
     using base_type = module_interface<MessageType>;
 
 public:
     using message_type = typename base_type::message_type;
+    using message_pack_type = typename base_type::message_pack_type;
     using value_type = typename message_type::value_type;
     using string_type = typename message_type::string_type;
     using string_view_type = typename message_type::string_view_type;
     using formatter_type = Formatter;
 
-    using file_type = logency::detail::file::basic_file<value_type>;
+    using file_type = File;
     using file_open_mode = logency::file_open_mode;
 
+    using formatter_traits_type =
+        logency::message::formatter_traits<formatter_type, message_type>;
+    using buffer_type = typename formatter_traits_type::buffer_type;
+
     static_assert(
-        std::is_convertible<typename decltype(std::function{
-                                std::declval<formatter_type>()})::result_type,
-                            string_type>::value,
+        formatter_traits_type::is_buffered ||
+            std::is_invocable_r_v<string_type, formatter_type &,
+                                  string_view_type, const message_type &>,
         "Formatter output cannot transfer input message to "
         "\"std::basic_string<value_type>\".");
 
@@ -72,6 +82,12 @@ public:
     void log_message(string_view_type logger,
                      const message_type &message) override;
 
+    /**
+     * \copydoc module_interface::log_messages
+     */
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override;
+
 protected:
     template <typename T>
     void log_to_stream(const T &value);
@@ -79,49 +95,60 @@ protected:
 private:
     file_type file_;                            //!< represent the file.
     std::unique_ptr<formatter_type> formatter_; //!< message formatter.
+    buffer_type buffer_{}; //!< Reused by the buffered formatter.
 };
 
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter, typename File>
 template <typename CharT>
-basic_file_module<MessageType, Formatter>::basic_file_module(
+basic_file_module<MessageType, Formatter, File>::basic_file_module(
     const CharT *name, file_open_mode mode,
     std::unique_ptr<formatter_type> formatter)
     : file_{name, mode}, formatter_{std::move(formatter)}
 {
 }
 
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter, typename File>
 template <typename CharT>
-basic_file_module<MessageType, Formatter>::basic_file_module(
+basic_file_module<MessageType, Formatter, File>::basic_file_module(
     const std::basic_string<CharT> &name, file_open_mode mode,
     std::unique_ptr<formatter_type> formatter)
     : file_{name, mode}, formatter_{std::move(formatter)}
 {
 }
 
-template <typename MessageType, typename Formatter>
-basic_file_module<MessageType, Formatter>::~basic_file_module() = default;
+template <typename MessageType, typename Formatter, typename File>
+basic_file_module<MessageType, Formatter, File>::~basic_file_module() = default;
 
-template <typename MessageType, typename Formatter>
-void basic_file_module<MessageType, Formatter>::flush()
+template <typename MessageType, typename Formatter, typename File>
+void basic_file_module<MessageType, Formatter, File>::flush()
 {
     file_.flush();
 }
 
-template <typename MessageType, typename Formatter>
-void basic_file_module<MessageType, Formatter>::log_message(
+template <typename MessageType, typename Formatter, typename File>
+void basic_file_module<MessageType, Formatter, File>::log_message(
     string_view_type logger, const message_type &message)
 {
-    auto formatted_message{(*formatter_)(logger, message)};
+    log_to_stream(
+        base_type::format_message(*formatter_, buffer_, logger, message));
+}
 
-    log_to_stream(formatted_message);
+template <typename MessageType, typename Formatter, typename File>
+void basic_file_module<MessageType, Formatter, File>::log_messages(
+    const message_pack_type *first, const message_pack_type *last)
+{
+    base_type::log_batch(*formatter_, buffer_, first, last,
+                         [this](string_view_type value)
+                         { log_to_stream(value); });
 }
 
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter, typename File>
 template <typename T>
-void basic_file_module<MessageType, Formatter>::log_to_stream(const T &value)
+void basic_file_module<MessageType, Formatter, File>::log_to_stream(
+    const T &value)
 {
     file_.write(value);
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
 }
 
 } // namespace logency::sink_module
@@ -186,6 +186,7 @@ void color_console_module_base<
     assert(ostream_->good());
 
     ostream_->write(value.data(), static_cast<std::streamsize>(value.size()));
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
 }
 
 template <typename MessageType, typename Formatter, typename ConsoleMutex>
@@ -3,12 +3,13 @@
 
 #include "color_output.hpp"
 #include "logency/detail/thread/console_mutex.hpp"
+#include "logency/message/message_formatter.hpp"
 #include "module_interface.hpp"
 
 #include <cassert>
 
-#include <functional>
 #include <ostream>
+#include <type_traits>
 
 namespace logency::sink_module
 {
@@ -21,6 +22,7 @@ class console_module : public module_interface<MessageType>
 
 public:
     using message_type = typename base_type::message_type;
+    using message_pack_type = typename base_type::message_pack_type;
     using value_type = typename message_type::value_type;
     using traits_type = typename message_type::traits_type;
     using string_type = typename message_type::string_type;
@@ -32,10 +34,14 @@ public:
     using color_attribute_type = color_attribute;
     using mutex_type = typename ConsoleMutex::mutex_type;
 
+    using formatter_traits_type =
+        logency::message::formatter_traits<formatter_type, message_type>;
+    using buffer_type = typename formatter_traits_type::buffer_type;
+
     static_assert(
-        std::is_convertible<typename decltype(std::function{
-                                std::declval<formatter_type>()})::result_type,
-                            string_type>::value,
+        formatter_traits_type::is_buffered ||
+            std::is_invocable_r_v<string_type, formatter_type &,
+                                  string_view_type, const message_type &>,
         "Formatter output cannot transfer input message to \"string_type\".");
 
     explicit console_module(ostream_type *stream,
@@ -59,6 +65,12 @@ public:
     void log_message(string_view_type logger,
                      const message_type &message) override;
 
+    /**
+     * \copydoc module_interface::log_messages
+     */
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override;
+
     auto ostream() noexcept -> ostream_type &;
     auto ostream() const noexcept -> const ostream_type &;
 
@@ -71,6 +83,7 @@ private:
 
     ostream_type *ostream_;
     std::unique_ptr<formatter_type> formatter_;
+    buffer_type buffer_{}; //!< Reused by the buffered formatter.
 
     mutex_type &mutex_;
     bool is_color_parse_enable_{false};
@@ -104,9 +117,17 @@ template <typename MessageType, typename Formatter, typename ConsoleMutex>
 void console_module<MessageType, Formatter, ConsoleMutex>::log_message(
     string_view_type logger, const message_type &message)
 {
-    const auto formatted_message{(*formatter_)(logger, message)};
+    log_to_stream(
+        base_type::format_message(*formatter_, buffer_, logger, message));
+}
 
-    log_to_stream(formatted_message);
+template <typename MessageType, typename Formatter, typename ConsoleMutex>
+void console_module<MessageType, Formatter, ConsoleMutex>::log_messages(
+    const message_pack_type *first, const message_pack_type *last)
+{
+    base_type::log_batch(*formatter_, buffer_, first, last,
+                         [this](string_view_type value)
+                         { log_to_stream(value); });
 }
 
 template <typename MessageType, typename Formatter, typename ConsoleMutex>
@@ -121,6 +142,8 @@ void console_module<MessageType, Formatter, ConsoleMutex>::log_to_stream(
         ostream_->write(value.data(),
                         static_cast<std::streamsize>(value.size()));
     }
+
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
 }
 
 template <typename MessageType, typename Formatter, typename ConsoleMutex>
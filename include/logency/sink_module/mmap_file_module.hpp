@@ -0,0 +1,34 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_MMAP_FILE_MODULE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_MMAP_FILE_MODULE_HPP_
+
+#if !defined(_WIN32)
+
+    #include "basic_file_module.hpp"
+    #include "logency/detail/file/mmap_file.hpp"
+
+namespace logency::sink_module
+{
+
+/**
+ * \brief This class represent the single file sink which writes through a
+ * memory mapping.
+ *
+ * The formatted messages are copied into the mapping of the file, so logging
+ * a batch does not make any system call. Flush only schedules the write back.
+ * See logency::detail::file::mmap_file for details.
+ *
+ * \tparam MessageType MessageType type.
+ * \tparam Formatter Formatter type.
+ */
+template <typename MessageType, typename Formatter>
+using mmap_file_module =
+    basic_file_module<MessageType, Formatter,
+                      logency::detail::file::mmap_file<
+                          typename MessageType::value_type,
+                          typename MessageType::traits_type>>;
+
+} // namespace logency::sink_module
+
+#endif
+
+#endif // LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_MMAP_FILE_MODULE_HPP_
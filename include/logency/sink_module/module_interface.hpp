@@ -1,7 +1,14 @@
 #ifndef LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_BASE_MODULE_INTERFACE_HPP_
 #define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_BASE_MODULE_INTERFACE_HPP_
 
+#include "logency/detail/message_pack.hpp"
+#include "logency/message/message_formatter.hpp"
+
+#include <cstddef>
+
+#include <atomic>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace logency::sink_module
@@ -20,11 +27,26 @@ class module_interface
 {
 public:
     using message_type = MessageType;
+    using message_pack_type = logency::message_pack<message_type>;
 
     using string_view_type = typename message_type::string_view_type;
 
+    /**
+     * \brief Character count which a module should write its batch buffer
+     * at, instead of growing it further.
+     */
+    static constexpr const std::size_t batch_buffer_size{64U * 1024U};
+
+    module_interface() noexcept = default;
     virtual ~module_interface() = default;
 
+    // The counter is copied, so the derived modules stay copyable.
+    module_interface(const module_interface &other) noexcept;
+    module_interface(module_interface &&other) noexcept;
+    auto operator=(const module_interface &other) noexcept
+        -> module_interface &;
+    auto operator=(module_interface &&other) noexcept -> module_interface &;
+
     /**
      * \brief flush the sink module.
      */
@@ -40,8 +62,270 @@ public:
      */
     virtual void log_message(string_view_type logger,
                              const message_type &message) = 0;
+
+    /**
+     * \brief log the message packs in [\a first, \a last) into the module.
+     *
+     * The sink passes a whole batch at once. The default implementation calls
+     * log_message() for each of them. Override it to handle the batch in one
+     * go, e.g. format it into one buffer and write it once.
+     *
+     * An override reports how far it got with set_logged_messages(), so the
+     * sink only discards the failing message if it throws.
+     *
+     * \param first Pointer to the first message pack.
+     * \param last Pointer past the last message pack.
+     */
+    virtual void log_messages(const message_pack_type *first,
+                              const message_pack_type *last);
+
+    /**
+     * \brief Count of the message packs written by the last log_messages()
+     * call.
+     *
+     * If log_messages() throws, the pack at this index is the one which
+     * failed, and the packs before it are written.
+     */
+    [[nodiscard]] auto logged_messages() const noexcept -> std::size_t;
+
+    /**
+     * \brief Bytes written by the module. Thread safe.
+     *
+     * It stays \c 0 unless the module calls count_written_bytes().
+     */
+    [[nodiscard]] auto written_bytes() const noexcept -> std::size_t;
+
+protected:
+    /**
+     * \brief Add \a size to written_bytes(). Called by the module after it
+     * writes.
+     */
+    void count_written_bytes(std::size_t size) noexcept;
+
+    /**
+     * \brief Set logged_messages(). Called by log_messages() after it writes.
+     */
+    void set_logged_messages(std::size_t count) noexcept;
+
+    /**
+     * \brief Format \a message into \a buffer, which is cleared first.
+     *
+     * \param formatter Formatter used through message::formatter_traits.
+     * \return View to the content of \a buffer.
+     */
+    template <typename Formatter, typename Buffer>
+    [[nodiscard]] static auto format_message(Formatter &formatter,
+                                             Buffer &buffer,
+                                             string_view_type logger,
+                                             const message_type &message)
+        -> string_view_type;
+
+    /**
+     * \brief Format the message packs in [\a first, \a last) into \a buffer,
+     * and pass its content to \a write once it reaches batch_buffer_size and
+     * at the end. It keeps logged_messages() up to date.
+     *
+     * If a message cannot be formatted, the messages before it are written
+     * before it throws.
+     *
+     * \param formatter Formatter used through message::formatter_traits.
+     * \param buffer Reused buffer. It is cleared first.
+     * \param write Called with `string_view_type`.
+     * \param separate Called with the size of the pending content and the
+     * size of each formatted message. If it returns \c true, the pending
+     * content and the message are passed to \a write apart, e.g. so the
+     * message starts a new file.
+     */
+    template <typename Formatter, typename Buffer, typename Write,
+              typename Separate>
+    void log_batch(Formatter &formatter, Buffer &buffer,
+                   const message_pack_type *first,
+                   const message_pack_type *last, Write write,
+                   Separate separate);
+
+    /**
+     * \overload
+     */
+    template <typename Formatter, typename Buffer, typename Write>
+    void log_batch(Formatter &formatter, Buffer &buffer,
+                   const message_pack_type *first,
+                   const message_pack_type *last, Write write);
+
+private:
+    std::atomic<std::size_t> written_bytes_{0U};
+    std::size_t logged_messages_{0U};
 };
 
+template <typename MessageType>
+module_interface<MessageType>::module_interface(
+    const module_interface &other) noexcept
+    : written_bytes_{other.written_bytes()}
+{
+}
+
+template <typename MessageType>
+module_interface<MessageType>::module_interface(
+    module_interface &&other) noexcept
+    : module_interface{static_cast<const module_interface &>(other)}
+{
+}
+
+template <typename MessageType>
+auto module_interface<MessageType>::operator=(
+    const module_interface &other) noexcept -> module_interface &
+{
+    written_bytes_.store(other.written_bytes(), std::memory_order_relaxed);
+    return *this;
+}
+
+template <typename MessageType>
+auto module_interface<MessageType>::operator=(
+    module_interface &&other) noexcept -> module_interface &
+{
+    return *this = static_cast<const module_interface &>(other);
+}
+
+template <typename MessageType>
+void module_interface<MessageType>::log_messages(
+    const message_pack_type *first, const message_pack_type *last)
+{
+    set_logged_messages(0U);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (; first != last; ++first)
+    {
+        log_message((*first)->logger_name, (*first)->message);
+        set_logged_messages(logged_messages_ + 1U);
+    }
+}
+
+template <typename MessageType>
+auto module_interface<MessageType>::logged_messages() const noexcept
+    -> std::size_t
+{
+    return logged_messages_;
+}
+
+template <typename MessageType>
+template <typename Formatter, typename Buffer>
+auto module_interface<MessageType>::format_message(Formatter &formatter,
+                                                   Buffer &buffer,
+                                                   string_view_type logger,
+                                                   const message_type &message)
+    -> string_view_type
+{
+    buffer.clear();
+    logency::message::formatter_traits<Formatter, message_type>::format_to(
+        formatter, buffer, logger, message);
+
+    return string_view_type{buffer.data(), buffer.size()};
+}
+
+template <typename MessageType>
+template <typename Formatter, typename Buffer, typename Write,
+          typename Separate>
+void module_interface<MessageType>::log_batch(
+    Formatter &formatter, Buffer &buffer, const message_pack_type *first,
+    const message_pack_type *last, Write write, Separate separate)
+{
+    using formatter_traits_type =
+        logency::message::formatter_traits<Formatter, message_type>;
+
+    buffer.clear();
+    set_logged_messages(0U);
+
+    // Index of the current message pack.
+    std::size_t index{0U};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (; first != last; ++first, ++index)
+    {
+        const auto offset{buffer.size()};
+
+        try
+        {
+            formatter_traits_type::format_to(formatter, buffer,
+                                             (*first)->logger_name,
+                                             (*first)->message);
+        }
+        catch (...)
+        {
+            // Only this message is lost.
+            buffer.resize(offset);
+            if (offset != 0U)
+            {
+                write(string_view_type{buffer.data(), buffer.size()});
+                set_logged_messages(index);
+            }
+
+            throw;
+        }
+
+        const string_view_type pending{buffer.data(), buffer.size()};
+
+        if (separate(offset, pending.size() - offset))
+        {
+            if (offset != 0U)
+            {
+                write(pending.substr(0U, offset));
+                set_logged_messages(index);
+            }
+
+            write(pending.substr(offset));
+            set_logged_messages(index + 1U);
+            buffer.clear();
+        }
+        else if (pending.size() >= batch_buffer_size)
+        {
+            write(pending);
+            set_logged_messages(index + 1U);
+            buffer.clear();
+        }
+    }
+
+    if (buffer.size() != 0U)
+    {
+        write(string_view_type{buffer.data(), buffer.size()});
+        set_logged_messages(index);
+    }
+}
+
+template <typename MessageType>
+template <typename Formatter, typename Buffer, typename Write>
+void module_interface<MessageType>::log_batch(Formatter &formatter,
+                                              Buffer &buffer,
+                                              const message_pack_type *first,
+                                              const message_pack_type *last,
+                                              Write write)
+{
+    log_batch(formatter, buffer, first, last, std::move(write),
+              [](std::size_t /*pending*/, std::size_t /*size*/)
+              { return false; });
+}
+
+template <typename MessageType>
+auto module_interface<MessageType>::written_bytes() const noexcept
+    -> std::size_t
+{
+    return written_bytes_.load(std::memory_order_relaxed);
+}
+
+template <typename MessageType>
+void module_interface<MessageType>::set_logged_messages(
+    std::size_t count) noexcept
+{
+    logged_messages_ = count;
+}
+
+template <typename MessageType>
+void module_interface<MessageType>::count_written_bytes(
+    std::size_t size) noexcept
+{
+    // Only the thread holding the sink writes, hence no read-modify-write.
+    written_bytes_.store(written_bytes_.load(std::memory_order_relaxed) + size,
+                         std::memory_order_relaxed);
+}
+
 } // namespace logency::sink_module
 
 #endif // LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_BASE_MODULE_INTERFACE_HPP_
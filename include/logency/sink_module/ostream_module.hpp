@@ -2,11 +2,11 @@
 #define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_OSTREAM_MODULE_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/message/message_formatter.hpp"
 #include "module_interface.hpp"
 
 #include <cassert>
 
-#include <functional>
 #include <ostream>
 #include <type_traits>
 
@@ -29,6 +29,7 @@ class ostream_module : public module_interface<MessageType>
 
 public:
     using message_type = typename base_type::message_type;
+    using message_pack_type = typename base_type::message_pack_type;
     using value_type = typename message_type::value_type;
     using traits_type = typename message_type::traits_type;
     using string_type = typename message_type::string_type;
@@ -39,10 +40,14 @@ public:
     using ostream_type = std::basic_ostream<value_type, traits_type>;
     using formatter_type = Formatter;
 
+    using formatter_traits_type =
+        logency::message::formatter_traits<formatter_type, message_type>;
+    using buffer_type = typename formatter_traits_type::buffer_type;
+
     static_assert(
-        std::is_convertible<typename decltype(std::function{
-                                std::declval<formatter_type>()})::result_type,
-                            string_type>::value,
+        formatter_traits_type::is_buffered ||
+            std::is_invocable_r_v<string_type, formatter_type &,
+                                  string_view_type, const message_type &>,
         "Formatter output cannot transfer input message to \"string_type\".");
 
     /**
@@ -78,6 +83,12 @@ public:
     void log_message(string_view_type logger,
                      const message_type &message) override;
 
+    /**
+     * \copydoc module_interface::log_messages
+     */
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override;
+
 protected:
     void log_to_stream(string_view_type value);
 
@@ -86,6 +97,7 @@ private:
 
     ostream_type *ostream_; //!< ostream pointer to prevent slicing.
      std::unique_ptr<formatter_type> formatter_;
+    buffer_type buffer_{}; //!< Reused by the buffered formatter.
 };
 
 template <typename MessageType, typename Formatter>
@@ -111,9 +123,17 @@ template <typename MessageType, typename Formatter>
 void ostream_module<MessageType, Formatter>::log_message(
     string_view_type logger, const message_type &message)
 {
-    auto formatted_message{(*formatter_)(logger, message)};
+    log_to_stream(
+        base_type::format_message(*formatter_, buffer_, logger, message));
+}
 
-    log_to_stream(formatted_message);
+template <typename MessageType, typename Formatter>
+void ostream_module<MessageType, Formatter>::log_messages(
+    const message_pack_type *first, const message_pack_type *last)
+{
+    base_type::log_batch(*formatter_, buffer_, first, last,
+                         [this](string_view_type value)
+                         { log_to_stream(value); });
 }
 
 template <typename MessageType, typename Formatter>
@@ -124,6 +144,7 @@ void ostream_module<MessageType, Formatter>::log_to_stream(
     assert(ostream_->good());
 
     ostream_->write(value.data(), static_cast<std::streamsize>(value.size()));
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
 }
 
 template <typename MessageType, typename Formatter>
@@ -2,8 +2,10 @@
 #define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_ROTATION_FILE_MODULE_HPP_
 
 #include "logency/core/exception.hpp"
+#include "logency/detail/file/background_compressor.hpp"
 #include "logency/detail/file/basic_file.hpp"
 #include "logency/detail/file/file_helper.hpp"
+#include "logency/message/message_formatter.hpp"
 #include "module_interface.hpp"
 
 #include <cassert>
@@ -12,7 +14,7 @@
 #include <chrono>
 #include <filesystem>
 #include <fstream>
-#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <system_error>
@@ -30,23 +32,60 @@ enum class construct_mode
     create_new_file
 };
 
+/**
+ * \brief How the files are named when they rotate.
+ */
+enum class naming_mode
+{
+    /**
+     * The current file is always the given name. On rotation, every archive
+     * file is renamed to the next index (a.txt -> a-1.txt -> a-2.txt).
+     */
+    cascade,
+
+    /**
+     * Each file is named by an increasing index (a-1.txt, a-2.txt, ...) and
+     * is never renamed. On rotation, only the oldest file is deleted.
+     * Closed files can be compressed. See rotation_file_module::set_compressor.
+     */
+    sequence
+};
+
 struct rotate_info
 {
     using file_size_type = std::uintmax_t;
 
     file_size_type file_size{0U};
     int file_count{0};
+    naming_mode naming{naming_mode::cascade};
 };
 
 } // namespace rotation_file
 
-template <typename MessageType, typename Formatter>
+/**
+ * \brief This class represent the file sink which rotates its file by size.
+ *
+ * How the files are named is selected by rotate_info::naming. With
+ * rotation_file::naming_mode::sequence, a rotation costs one close, one open
+ * and at most one delete, no matter how many files are kept.
+ *
+ * \tparam MessageType MessageType type.
+ * \tparam Formatter Formatter type.
+ * \tparam File File type. It should provide the same constructors, \c write
+ * and \c flush as logency::detail::file::basic_file, e.g.
+ * logency::detail::file::posix_file.
+ */
+template <typename MessageType, typename Formatter,
+          typename File = logency::detail::file::basic_file<
+              typename MessageType::value_type,
+              typename MessageType::traits_type>>
 class rotation_file_module : public module_interface<MessageType>
 {
     using base_type = module_interface<MessageType>;
 
 public:
     using message_type = typename base_type::message_type;
+    using message_pack_type = typename base_type::message_pack_type;
     using value_type = typename message_type::value_type;
     using traits_type = typename message_type::traits_type;
     using string_type = typename message_type::string_type;
@@ -54,17 +93,22 @@ public:
 
     using formatter_type = Formatter;
 
-    using file_type =
-        logency::detail::file::basic_file<value_type, traits_type>;
+    using file_type = File;
 
     using construct_mode = rotation_file::construct_mode;
+    using naming_mode = rotation_file::naming_mode;
+    using compressor_type = logency::detail::file::background_compressor;
     using file_size_type = rotation_file::rotate_info::file_size_type;
     using rotate_info = rotation_file::rotate_info;
 
+    using formatter_traits_type =
+        logency::message::formatter_traits<formatter_type, message_type>;
+    using buffer_type = typename formatter_traits_type::buffer_type;
+
     static_assert(
-        std::is_convertible<typename decltype(std::function{
-                                std::declval<formatter_type>()})::result_type,
-                            string_type>::value,
+        formatter_traits_type::is_buffered ||
+            std::is_invocable_r_v<string_type, formatter_type &,
+                                  string_view_type, const message_type &>,
         "Formatter output cannot transfer input message to \"string_type\".");
 
     template <typename CharT>
@@ -97,6 +141,25 @@ public:
     void log_message(string_view_type logger,
                      const message_type &message) override;
 
+    /**
+     * \copydoc module_interface::log_messages
+     */
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override;
+
+    /**
+     * \brief Sets the compressor which compresses the closed files.
+     *
+     * Each file is handed to \a compressor right after it is closed, and the
+     * oldest file is deleted whether it is compressed or not. The compressor
+     * can be shared by several modules to cap the jobs among them.
+     *
+     * \param compressor Specified compressor. \c nullptr to stop compressing.
+     * \throw logency::runtime_error if the naming is not naming_mode::sequence,
+     * whose files are renamed while they might be compressed.
+     */
+    void set_compressor(std::shared_ptr<compressor_type> compressor);
+
 private:
     using path_type = std::filesystem::path;
     using file_value_type = path_type::value_type;
@@ -115,7 +178,11 @@ private:
     static void get_file_info(const path_type &name, file_info &info);
     static auto get_file_size(const path_type &name) -> std::optional<size_t>;
 
+    [[nodiscard]] auto current_name() const -> path_type;
+    void find_last_index();
+
     void close_file();
+    void log_to_file(string_view_type value);
     void rotate_file();
     void rotate();
     bool should_rotate(file_size_type offset);
@@ -125,13 +192,16 @@ private:
     file_info file_info_;
     const rotate_info rotate_info_;
     file_size_type current_size_{};
+    int index_{0}; //!< Index of the current file in naming_mode::sequence.
+    std::shared_ptr<compressor_type> compressor_{};
 
     std::unique_ptr<formatter_type> formatter_;
+    buffer_type buffer_{}; //!< Reused by the buffered formatter.
 };
 
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter, typename File>
 template <typename CharT>
-rotation_file_module<MessageType, Formatter>::rotation_file_module(
+rotation_file_module<MessageType, Formatter, File>::rotation_file_module(
     const CharT *name, rotate_info rotate_info, construct_mode mode,
     std::unique_ptr<formatter_type> formatter)
     : rotation_file_module{std::basic_string<CharT>{name}, rotate_info, mode,
@@ -139,9 +209,9 @@ rotation_file_module<MessageType, Formatter>::rotation_file_module(
 {
 }
 
-template <typename MessageType, typename Formatter>
+template <typename MessageType, typename Formatter, typename File>
 template <typename CharT>
-rotation_file_module<MessageType, Formatter>::rotation_file_module(
+rotation_file_module<MessageType, Formatter, File>::rotation_file_module(
     const std::basic_string<CharT> &name, rotate_info rotate_info,
     construct_mode mode, std::unique_ptr<formatter_type> formatter)
     : rotate_info_{rotate_info}, formatter_{std::move(formatter)}
@@ -158,7 +228,12 @@ rotation_file_module<MessageType, Formatter>::rotation_file_module(
 
     get_file_info(name, file_info_);
 
-    if (!std::filesystem::exists(file_info_.name))
+    if (rotate_info_.naming == naming_mode::sequence)
+    {
+        find_last_index();
+    }
+
+    if (!std::filesystem::exists(current_name()))
     {
         open_file();
     }
@@ -172,17 +247,18 @@ rotation_file_module<MessageType, Formatter>::rotation_file_module(
     }
 }
 
-template <typename MessageType, typename Formatter>
-rotation_file_module<MessageType, Formatter>::~rotation_file_module() = default;
+template <typename MessageType, typename Formatter, typename File>
+rotation_file_module<MessageType, Formatter, File>::~rotation_file_module() =
+    default;
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::close_file()
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::close_file()
 {
     file_.reset();
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::rotate_file()
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::rotate_file()
 {
     assert(std::filesystem::exists(file_info_.name));
 
@@ -214,14 +290,107 @@ void rotation_file_module<MessageType, Formatter>::rotate_file()
     }
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::flush()
+template <typename MessageType, typename Formatter, typename File>
+auto rotation_file_module<MessageType, Formatter, File>::current_name() const
+    -> path_type
+{
+    if (rotate_info_.naming == naming_mode::sequence)
+    {
+        return parse_filename(file_info_, index_);
+    }
+
+    return file_info_.name;
+}
+
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::set_compressor(
+    std::shared_ptr<compressor_type> compressor)
+{
+    if ((compressor != nullptr) &&
+        (rotate_info_.naming != naming_mode::sequence))
+    {
+        throw logency::runtime_error(
+            "compression needs naming_mode::sequence.");
+    }
+
+    compressor_ = std::move(compressor);
+}
+
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::find_last_index()
+{
+    // Look for the files named "<front><index><extension>", which might be
+    // compressed. It is only done on construction.
+    const auto prefix{file_info_.front.filename().native()};
+    const auto &suffix{file_info_.extension.native()};
+    const auto compressed{path_type{compressor_type::extension}.native()};
+
+    auto directory{file_info_.name.parent_path()};
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+
+    constexpr const std::size_t max_digits{9U}; // Fits in int.
+
+    index_ = 1;
+
+    std::error_code code;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{directory, code})
+    {
+        auto filename{entry.path().filename().native()};
+
+        const bool is_compressed{
+            !compressed.empty() && (filename.size() > compressed.size()) &&
+            (filename.compare(filename.size() - compressed.size(),
+                              compressed.size(), compressed) == 0)};
+        if (is_compressed)
+        {
+            filename.resize(filename.size() - compressed.size());
+        }
+
+        if ((filename.size() <= prefix.size() + suffix.size()) ||
+            (filename.size() > prefix.size() + suffix.size() + max_digits) ||
+            (filename.compare(0U, prefix.size(), prefix) != 0) ||
+            (filename.compare(filename.size() - suffix.size(), suffix.size(),
+                              suffix) != 0))
+        {
+            continue;
+        }
+
+        int index{0};
+        bool is_index{true};
+
+        for (auto i{prefix.size()}; i < filename.size() - suffix.size(); ++i)
+        {
+            const auto digit{filename[i]};
+
+            if ((digit < '0') || (digit > '9'))
+            {
+                is_index = false;
+                break;
+            }
+
+            index = index * 10 + static_cast<int>(digit - '0');
+        }
+
+        if (is_index)
+        {
+            // A compressed file is closed, so continue with the next one.
+            index_ = std::max(index_, is_compressed ? index + 1 : index);
+        }
+    }
+}
+
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::flush()
 {
     file_->flush();
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::get_file_info(
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::get_file_info(
     const path_type &name, file_info &info)
 {
     auto extracted{detail::file::extract_file_extension(name)};
@@ -230,8 +399,8 @@ void rotation_file_module<MessageType, Formatter>::get_file_info(
     info.extension = std::get<1>(extracted);
 }
 
-template <typename MessageType, typename Formatter>
-auto rotation_file_module<MessageType, Formatter>::get_file_size(
+template <typename MessageType, typename Formatter, typename File>
+auto rotation_file_module<MessageType, Formatter, File>::get_file_size(
     const path_type &name) -> std::optional<size_t>
 {
     std::error_code code;
@@ -246,35 +415,56 @@ auto rotation_file_module<MessageType, Formatter>::get_file_size(
     return static_cast<size_t>(size);
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::log_message(
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::log_message(
     string_view_type logger, const message_type &message)
 {
-    auto formatted_message{(*formatter_)(logger, message)};
+    log_to_file(
+        base_type::format_message(*formatter_, buffer_, logger, message));
+}
+
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::log_messages(
+    const message_pack_type *first, const message_pack_type *last)
+{
+    // A message which does not fit goes to the next file on its own.
+    base_type::log_batch(
+        *formatter_, buffer_, first, last,
+        [this](string_view_type value) { log_to_file(value); },
+        [this](std::size_t pending, std::size_t size)
+        { return should_rotate(static_cast<file_size_type>(pending + size)); });
+}
 
-    const auto size{static_cast<file_size_type>(formatted_message.size())};
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::log_to_file(
+    string_view_type value)
+{
+    const auto size{static_cast<file_size_type>(value.size())};
 
     if (should_rotate(size))
     {
         rotate();
     }
 
-    file_->write(formatted_message);
+    file_->write(value);
     current_size_ += size;
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::open_file()
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::open_file()
 {
     constexpr auto mode{file_open_mode::append};
 
-    file_ = std::make_unique<file_type>(file_info_.name, mode);
+    const auto name{current_name()};
+
+    file_ = std::make_unique<file_type>(name, mode);
 
-    current_size_ = get_file_size(file_info_.name).value_or(0);
+    current_size_ = get_file_size(name).value_or(0);
 }
 
-template <typename MessageType, typename Formatter>
-auto rotation_file_module<MessageType, Formatter>::parse_filename(
+template <typename MessageType, typename Formatter, typename File>
+auto rotation_file_module<MessageType, Formatter, File>::parse_filename(
     const file_info &file, int index) -> path_type
 {
     if (index > 0)
@@ -287,20 +477,54 @@ auto rotation_file_module<MessageType, Formatter>::parse_filename(
     return file.name;
 }
 
-template <typename MessageType, typename Formatter>
-void rotation_file_module<MessageType, Formatter>::rotate()
+template <typename MessageType, typename Formatter, typename File>
+void rotation_file_module<MessageType, Formatter, File>::rotate()
 {
     close_file();
+
+    if (rotate_info_.naming == naming_mode::cascade)
     {
         assert(std::filesystem::exists(file_info_.name));
 
         rotate_file();
     }
+    else
+    {
+        const auto closed{current_name()};
+
+        ++index_;
+
+        // Keep `rotate_info_.file_count` files including the new one.
+        if (const auto oldest{index_ - rotate_info_.file_count}; oldest > 0)
+        {
+            const auto oldest_name{parse_filename(file_info_, oldest)};
+
+            std::error_code code;
+            std::filesystem::remove(oldest_name, code);
+            if (!code && compressor_type::is_available)
+            {
+                std::filesystem::remove(
+                    path_type{oldest_name}.concat(compressor_type::extension),
+                    code);
+            }
+
+            if (code)
+            {
+                throw logency::system_error(code, "Failed to rotate file");
+            }
+        }
+
+        if (compressor_)
+        {
+            compressor_->compress(closed);
+        }
+    }
+
     open_file();
 }
 
-template <typename MessageType, typename Formatter>
-bool rotation_file_module<MessageType, Formatter>::should_rotate(
+template <typename MessageType, typename Formatter, typename File>
+bool rotation_file_module<MessageType, Formatter, File>::should_rotate(
     file_size_type offset)
 {
     return current_size_ + offset >= rotate_info_.file_size;
@@ -0,0 +1,577 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_TIME_ROTATION_FILE_MODULE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_TIME_ROTATION_FILE_MODULE_HPP_
+
+#include "logency/core/exception.hpp"
+#include "logency/detail/file/basic_file.hpp"
+#include "logency/detail/file/file_helper.hpp"
+#include "logency/message/message_formatter.hpp"
+#include "logency/message/time.hpp"
+#include "module_interface.hpp"
+#include "rotation_file_module.hpp"
+
+#include <cassert>
+#include <ctime>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace logency::sink_module
+{
+
+namespace time_rotation_file
+{
+
+struct rotate_info
+{
+    using file_size_type = std::uintmax_t;
+
+    /**
+     * Length of each period. Periods start from the local midnight, so it
+     * should divide a day (e.g. 1 hour, 1 day).
+     */
+    std::chrono::seconds interval{std::chrono::hours{24}};
+
+    /**
+     * Maximum number of files kept, including the current one.
+     */
+    int file_count{0};
+
+    /**
+     * Start another file in the same period when the file reaches this size.
+     * Zero means no limit.
+     */
+    file_size_type file_size{0U};
+};
+
+} // namespace time_rotation_file
+
+/**
+ * \brief This class represent the file sink which rotates its file at the
+ * wall clock boundaries.
+ *
+ * Each file is named by the start of its period in local time, e.g.
+ * `a-2024-01-31_13-00-00.txt` for `a.txt` rotated hourly. If
+ * rotate_info::file_size is reached within a period, the next file of the
+ * period is named with an index, e.g. `a-2024-01-31_13-00-00-1.txt`. Files are
+ * never renamed. When there are more than rotate_info::file_count files, the
+ * oldest one is deleted.
+ *
+ * The end of the current period is computed on rotation. Checking a message
+ * is only a comparison against it, without any conversion to local time. The
+ * clock is read once per call of log_message() or log_messages().
+ *
+ * \tparam MessageType MessageType type.
+ * \tparam Formatter Formatter type.
+ * \tparam File File type. See basic_file_module.
+ * \tparam Clock Clock type. Its \c time_point should be the one of
+ * \c std::chrono::system_clock.
+ */
+template <typename MessageType, typename Formatter,
+          typename File = logency::detail::file::basic_file<
+              typename MessageType::value_type,
+              typename MessageType::traits_type>,
+          typename Clock = std::chrono::system_clock>
+class time_rotation_file_module : public module_interface<MessageType>
+{
+    using base_type = module_interface<MessageType>;
+
+public:
+    using message_type = typename base_type::message_type;
+    using message_pack_type = typename base_type::message_pack_type;
+    using value_type = typename message_type::value_type;
+    using traits_type = typename message_type::traits_type;
+    using string_type = typename message_type::string_type;
+    using string_view_type = typename message_type::string_view_type;
+
+    using formatter_type = Formatter;
+
+    using file_type = File;
+    using clock_type = Clock;
+
+    using construct_mode = rotation_file::construct_mode;
+    using rotate_info = time_rotation_file::rotate_info;
+    using file_size_type = rotate_info::file_size_type;
+
+    using formatter_traits_type =
+        logency::message::formatter_traits<formatter_type, message_type>;
+    using buffer_type = typename formatter_traits_type::buffer_type;
+
+    static_assert(
+        std::is_same_v<typename clock_type::time_point,
+                       std::chrono::system_clock::time_point>,
+        "Clock should use the time point of std::chrono::system_clock.");
+
+    static_assert(
+        formatter_traits_type::is_buffered ||
+            std::is_invocable_r_v<string_type, formatter_type &,
+                                  string_view_type, const message_type &>,
+        "Formatter output cannot transfer input message to \"string_type\".");
+
+    template <typename CharT>
+    explicit time_rotation_file_module(
+        const CharT *name, rotate_info rotate_info, construct_mode mode,
+        std::unique_ptr<formatter_type> formatter);
+
+    template <typename CharT>
+    explicit time_rotation_file_module(
+        const std::basic_string<CharT> &name, rotate_info rotate_info,
+        construct_mode mode, std::unique_ptr<formatter_type> formatter);
+
+    ~time_rotation_file_module() override;
+
+    time_rotation_file_module(const time_rotation_file_module &other) = delete;
+    time_rotation_file_module(time_rotation_file_module &&other) noexcept =
+        delete;
+    auto operator=(const time_rotation_file_module &other)
+        -> time_rotation_file_module & = delete;
+    auto operator=(time_rotation_file_module &&other) noexcept
+        -> time_rotation_file_module & = delete;
+
+    /**
+     * \copydoc module_interface::flush
+     */
+    void flush() override;
+
+    /**
+     * \copydoc module_interface::log_message
+     */
+    void log_message(string_view_type logger,
+                     const message_type &message) override;
+
+    /**
+     * \copydoc module_interface::log_messages
+     */
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override;
+
+private:
+    using path_type = std::filesystem::path;
+    using time_point = typename clock_type::time_point;
+    using rep_type = typename time_point::rep;
+
+    /**
+     * Length of "YYYY-MM-DD_hh-mm-ss".
+     */
+    static constexpr const std::size_t stamp_size{19U};
+
+    struct segment
+    {
+        path_type name;
+        path_type::string_type stamp;
+        int index;
+    };
+
+    [[nodiscard]] static auto now() -> rep_type;
+    [[nodiscard]] static auto get_stamp(time_point time)
+        -> path_type::string_type;
+
+    [[nodiscard]] auto get_period_start(time_point time) const -> time_point;
+    [[nodiscard]] auto get_segment_name(int index) const -> path_type;
+
+    void find_segments();
+    void start_period(time_point time);
+    void remove_old_segments();
+
+    void log_to_file(rep_type time, string_view_type value);
+    void write_to_file(string_view_type value);
+    void rotate();
+    bool should_rotate(rep_type time, file_size_type pending,
+                       file_size_type size) const;
+    void open_file();
+
+    std::unique_ptr<file_type> file_;
+    path_type front_;
+    path_type extension_;
+    const rotate_info rotate_info_;
+    file_size_type current_size_{};
+
+    path_type::string_type stamp_;   //!< Start of the current period.
+    int index_{0};                   //!< Index in the current period.
+    rep_type next_boundary_{};       //!< End of the current period.
+    std::deque<path_type> segments_; //!< Files from the oldest one.
+
+    std::unique_ptr<formatter_type> formatter_;
+    buffer_type buffer_{}; //!< Reused by the buffered formatter.
+};
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+template <typename CharT>
+time_rotation_file_module<MessageType, Formatter, File, Clock>::
+    time_rotation_file_module(const CharT *name, rotate_info rotate_info,
+                              construct_mode mode,
+                              std::unique_ptr<formatter_type> formatter)
+    : time_rotation_file_module{std::basic_string<CharT>{name}, rotate_info,
+                                mode, std::move(formatter)}
+{
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+template <typename CharT>
+time_rotation_file_module<MessageType, Formatter, File, Clock>::
+    time_rotation_file_module(const std::basic_string<CharT> &name,
+                              rotate_info rotate_info, construct_mode mode,
+                              std::unique_ptr<formatter_type> formatter)
+    : rotate_info_{rotate_info}, formatter_{std::move(formatter)}
+{
+    if (rotate_info_.interval.count() <= 0)
+    {
+        throw logency::runtime_error("interval should be positive.");
+    }
+
+    if (rotate_info_.file_count <= 0)
+    {
+        throw logency::runtime_error("file count should be positive integer.");
+    }
+
+    auto extracted{detail::file::extract_file_extension(path_type{name})};
+    front_ = std::get<0>(extracted).concat("-");
+    extension_ = std::get<1>(extracted);
+
+    find_segments();
+    start_period(clock_type::now());
+
+    // Continue the last file of the current period.
+    while (std::filesystem::exists(get_segment_name(index_ + 1)))
+    {
+        ++index_;
+    }
+
+    if ((mode == construct_mode::create_new_file) &&
+        std::filesystem::exists(get_segment_name(index_)))
+    {
+        ++index_;
+    }
+
+    open_file();
+
+    if (should_rotate(now(), 0U, 0U))
+    {
+        rotate();
+    }
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+time_rotation_file_module<MessageType, Formatter, File,
+                          Clock>::~time_rotation_file_module() = default;
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File, Clock>::flush()
+{
+    file_->flush();
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::log_message(string_view_type logger,
+                                                   const message_type &message)
+{
+    log_to_file(now(), base_type::format_message(*formatter_, buffer_, logger,
+                                                  message));
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File, Clock>::
+    log_messages(const message_pack_type *first, const message_pack_type *last)
+{
+    const auto time{now()};
+
+    // A message which does not fit goes to the next file on its own.
+    base_type::log_batch(
+        *formatter_, buffer_, first, last,
+        [this, time](string_view_type value) { log_to_file(time, value); },
+        [this, time](std::size_t pending, std::size_t size)
+        {
+            return should_rotate(time, static_cast<file_size_type>(pending),
+                                 static_cast<file_size_type>(size));
+        });
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+auto time_rotation_file_module<MessageType, Formatter, File, Clock>::now()
+    -> rep_type
+{
+    return clock_type::now().time_since_epoch().count();
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+auto time_rotation_file_module<MessageType, Formatter, File, Clock>::get_stamp(
+    time_point time) -> path_type::string_type
+{
+    const auto tm_value{logency::message::get_tm(time)};
+
+    std::array<char, stamp_size + 1U> stamp{};
+    std::strftime(stamp.data(), stamp.size(), "%Y-%m-%d_%H-%M-%S", &tm_value);
+
+    return path_type{stamp.data()}.native();
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+auto time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::get_period_start(time_point time) const
+    -> time_point
+{
+    auto midnight_tm{logency::message::get_tm(time)};
+    midnight_tm.tm_hour = 0;
+    midnight_tm.tm_min = 0;
+    midnight_tm.tm_sec = 0;
+    midnight_tm.tm_isdst = -1;
+
+    const auto midnight{std::chrono::system_clock::from_time_t(
+        std::mktime(&midnight_tm))};
+
+    if (time < midnight)
+    {
+        return time; // Only when the local time is broken.
+    }
+
+    const auto periods{(time - midnight) / rotate_info_.interval};
+
+    return midnight +
+           std::chrono::duration_cast<typename time_point::duration>(
+               rotate_info_.interval * periods);
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+auto time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::get_segment_name(int index) const
+    -> path_type
+{
+    auto name{path_type{front_}.concat(stamp_)};
+
+    if (index > 0)
+    {
+        name.concat("-").concat(std::to_string(index));
+    }
+
+    return name.concat(extension_.native());
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::find_segments()
+{
+    // Look for the files named "<front><stamp>[-<index>]<extension>". It is
+    // only done on construction.
+    const auto prefix{front_.filename().native()};
+    const auto &suffix{extension_.native()};
+
+    auto directory{front_.parent_path()};
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+
+    std::vector<segment> segments;
+
+    std::error_code code;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{directory, code})
+    {
+        const auto filename{entry.path().filename().native()};
+
+        if ((filename.size() < prefix.size() + stamp_size + suffix.size()) ||
+            (filename.compare(0U, prefix.size(), prefix) != 0) ||
+            (filename.compare(filename.size() - suffix.size(), suffix.size(),
+                              suffix) != 0))
+        {
+            continue;
+        }
+
+        auto middle{filename.substr(prefix.size(), filename.size() -
+                                                       prefix.size() -
+                                                       suffix.size())};
+
+        // "YYYY-MM-DD_hh-mm-ss"
+        bool is_segment{true};
+        for (std::size_t i{0U}; i < stamp_size; ++i)
+        {
+            const auto letter{middle[i]};
+            const bool is_digit{(letter >= '0') && (letter <= '9')};
+
+            if (is_digit != ((i != 4U) && (i != 7U) && (i != 10U) &&
+                             (i != 13U) && (i != 16U)))
+            {
+                is_segment = false;
+                break;
+            }
+        }
+
+        int index{0};
+        if (is_segment && (middle.size() > stamp_size))
+        {
+            constexpr const std::size_t max_digits{9U}; // Fits in int.
+
+            is_segment = (middle[stamp_size] == '-') &&
+                         (middle.size() > stamp_size + 1U) &&
+                         (middle.size() <= stamp_size + 1U + max_digits);
+
+            for (auto i{stamp_size + 1U}; is_segment && (i < middle.size());
+                 ++i)
+            {
+                const auto digit{middle[i]};
+
+                is_segment = (digit >= '0') && (digit <= '9');
+                index = index * 10 + static_cast<int>(digit - '0');
+            }
+        }
+
+        if (is_segment)
+        {
+            middle.resize(stamp_size);
+            segments.push_back(
+                {front_.parent_path() / filename, std::move(middle), index});
+        }
+    }
+
+    std::sort(segments.begin(), segments.end(),
+              [](const segment &left, const segment &right)
+              {
+                  return std::tie(left.stamp, left.index) <
+                         std::tie(right.stamp, right.index);
+              });
+
+    for (auto &found : segments)
+    {
+        segments_.push_back(std::move(found.name));
+    }
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::start_period(time_point time)
+{
+    const auto start{get_period_start(time)};
+
+    stamp_ = get_stamp(start);
+    index_ = 0;
+    next_boundary_ = (start + rotate_info_.interval).time_since_epoch().count();
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::remove_old_segments()
+{
+    while (segments_.size() > static_cast<std::size_t>(rotate_info_.file_count))
+    {
+        std::error_code code;
+        std::filesystem::remove(segments_.front(), code);
+        if (code)
+        {
+            throw logency::system_error(code, "Failed to rotate file");
+        }
+
+        segments_.pop_front();
+    }
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::log_to_file(rep_type time,
+                                                   string_view_type value)
+{
+    if (should_rotate(time, 0U, static_cast<file_size_type>(value.size())))
+    {
+        rotate();
+    }
+
+    write_to_file(value);
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::write_to_file(string_view_type value)
+{
+    file_->write(value);
+    current_size_ += static_cast<file_size_type>(value.size());
+    base_type::count_written_bytes(value.size() * sizeof(*value.data()));
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File, Clock>::rotate()
+{
+    file_.reset();
+
+    if (now() >= next_boundary_)
+    {
+        start_period(clock_type::now());
+    }
+    else
+    {
+        ++index_;
+    }
+
+    open_file();
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+bool time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::should_rotate(rep_type time,
+                                                     file_size_type pending,
+                                                     file_size_type size)
+    const
+{
+    if (time >= next_boundary_)
+    {
+        return true;
+    }
+
+    // Bytes in the file, including the ones not written yet. An empty file is
+    // never rotated by size.
+    const auto filled{current_size_ + pending};
+
+    return (rotate_info_.file_size != 0U) && (filled != 0U) &&
+           (filled + size >= rotate_info_.file_size);
+}
+
+template <typename MessageType, typename Formatter, typename File,
+          typename Clock>
+void time_rotation_file_module<MessageType, Formatter, File,
+                               Clock>::open_file()
+{
+    constexpr auto mode{file_open_mode::append};
+
+    const auto name{get_segment_name(index_)};
+
+    file_ = std::make_unique<file_type>(name, mode);
+
+    std::error_code code;
+    const auto size{std::filesystem::file_size(name, code)};
+    current_size_ = code ? 0U : static_cast<file_size_type>(size);
+
+    if (std::find(segments_.begin(), segments_.end(), name) == segments_.end())
+    {
+        segments_.push_back(name);
+    }
+
+    remove_old_segments();
+}
+
+} // namespace logency::sink_module
+
+#endif // LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_TIME_ROTATION_FILE_MODULE_HPP_
@@ -0,0 +1,35 @@
+#ifndef LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_URING_FILE_MODULE_HPP_
+#define LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_URING_FILE_MODULE_HPP_
+
+#if defined(__linux__)
+
+    #include "basic_file_module.hpp"
+    #include "logency/detail/file/uring_file.hpp"
+
+namespace logency::sink_module
+{
+
+/**
+ * \brief This class represent the single file sink which writes through
+ * io_uring.
+ *
+ * The full buffers are submitted to io_uring, so the sink formats the next
+ * messages while the kernel writes the previous ones. It writes synchronously
+ * if io_uring is not available. See logency::detail::file::uring_file for
+ * details.
+ *
+ * \tparam MessageType MessageType type.
+ * \tparam Formatter Formatter type.
+ */
+template <typename MessageType, typename Formatter>
+using uring_file_module =
+    basic_file_module<MessageType, Formatter,
+                      logency::detail::file::uring_file<
+                          typename MessageType::value_type,
+                          typename MessageType::traits_type>>;
+
+} // namespace logency::sink_module
+
+#endif
+
+#endif // LOGENCY_INCLUDE_LOGENCY_SINK_MODULE_URING_FILE_MODULE_HPP_
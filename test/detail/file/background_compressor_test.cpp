@@ -0,0 +1,115 @@
+#include "logency/detail/file/background_compressor.hpp"
+
+#include "file_directory.hpp"
+#include "include_doctest.hpp"
+#include "utils/file.hpp"
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace logency::unit_test::detail::file
+{
+
+TEST_SUITE("logency::detail::file::background_compressor")
+{
+    using compressor_type = logency::detail::file::background_compressor;
+
+    SCENARIO("void background_compressor::compress(path_type)")
+    {
+        GIVEN("closed file and instantiated compressor")
+        {
+            std::string name{
+                unique_file_name("background_compressor-compress")};
+            utils::file::set_content(name, std::string(4096U, '0'));
+
+            const std::string target{name + compressor_type::extension};
+
+            compressor_type compressor{};
+
+            WHEN("compress the file and wait until it is done")
+            {
+                compressor.compress(name);
+                compressor.wait_until_idle();
+
+                THEN("file is replaced by the compressed one if it is "
+                     "available")
+                {
+                    CHECK_EQ(std::filesystem::exists(name),
+                             !compressor_type::is_available);
+
+                    if constexpr (compressor_type::is_available)
+                    {
+                        CHECK(std::filesystem::exists(target));
+                        CHECK_LT(std::filesystem::file_size(target), 4096U);
+                    }
+                }
+            }
+
+#if !defined(_WIN32)
+            WHEN("the file is deleted while it is compressed")
+            {
+                if constexpr (compressor_type::is_available)
+                {
+                    // Read through a FIFO, so it is deleted in the middle.
+                    std::filesystem::remove(name);
+                    REQUIRE_EQ(::mkfifo(name.c_str(), 0600), 0);
+
+                    std::thread compressing{
+                        [&name]()
+                        {
+                            try
+                            {
+                                compressor_type::compress_file(name);
+                            }
+                            catch (...)
+                            {
+                            }
+                        }};
+
+                    const auto descriptor{::open(name.c_str(), O_WRONLY)};
+                    REQUIRE(descriptor != -1);
+
+                    const std::string content(4096U, '0');
+                    CHECK_EQ(::write(descriptor, content.data(),
+                                     content.size()),
+                             static_cast<::ssize_t>(content.size()));
+
+                    std::filesystem::remove(name);
+                    ::close(descriptor);
+
+                    compressing.join();
+
+                    THEN("no compressed file is left")
+                    {
+                        CHECK(!std::filesystem::exists(target));
+                    }
+                }
+            }
+#endif
+
+            WHEN("compress the file which is not existed")
+            {
+                const std::string missing{name + ".missing"};
+
+                compressor.compress(missing);
+                compressor.wait_until_idle();
+
+                THEN("nothing is created")
+                {
+                    CHECK(!std::filesystem::exists(missing));
+                    CHECK(!std::filesystem::exists(
+                        missing + compressor_type::extension));
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::file
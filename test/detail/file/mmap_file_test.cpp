@@ -0,0 +1,194 @@
+#if !defined(_WIN32)
+
+    #include "logency/detail/file/mmap_file.hpp"
+
+    #include "file_directory.hpp"
+    #include "include_doctest.hpp"
+    #include "utils/check_exception.hpp"
+    #include "utils/file.hpp"
+
+    #include <sys/stat.h>
+
+    #include <filesystem>
+    #include <memory>
+    #include <string>
+    #include <tuple>
+
+namespace logency::unit_test::detail::file
+{
+
+TEST_SUITE("logency::detail::file::mmap_file")
+{
+    using file_type = logency::detail::file::mmap_file<char>;
+
+    SCENARIO("mmap_file::mmap_file(const std::string &, file_open_mode, "
+             "size_type)")
+    {
+        GIVEN("file is existed")
+        {
+            std::unique_ptr<file_type> file{nullptr};
+
+            std::string name{unique_file_name("mmap_file-exist")};
+            utils::file::set_content(name, std::string{"content"});
+
+            WHEN("instantiate with file_open_mode::append")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(name,
+                                                       file_open_mode::append);
+                });
+
+                THEN("exist file is attached the object without clearing its "
+                     "content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+
+            WHEN("instantiate with file_open_mode::truncate")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(
+                        name, file_open_mode::truncate);
+                });
+
+                THEN("exist file is attached the object with empty content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{});
+                }
+            }
+        }
+
+        GIVEN("incorrect file name")
+        {
+            const std::string name{};
+
+            WHEN("instantiate it")
+            {
+                auto act{[&]()
+                         {
+                             std::ignore = std::make_unique<file_type>(
+                                 name, file_open_mode::append);
+                         }};
+
+                THEN("throw logency::system_error")
+                {
+                    utils::check::throw_start_with_as<logency::system_error>(
+                        act, "Failed to open file");
+                }
+            }
+        }
+    }
+
+    SCENARIO("void mmap_file::write(string_view_type)")
+    {
+        GIVEN("instantiated file object with small chunk")
+        {
+            std::string name{test_dir().append("mmap_file-write.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, 8U)};
+
+            WHEN("write the content which is larger than the chunk")
+            {
+                CHECK_NOTHROW({
+                    file->write("first ");
+                    file->write("content which is too long");
+                });
+
+                THEN("file is grown by whole chunks")
+                {
+                    CHECK_EQ(std::filesystem::file_size(name), 32U);
+                }
+
+                THEN("file is truncated to the content when it is closed")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"first content which is too long"});
+                }
+            }
+        }
+
+    #if !defined(__APPLE__)
+        GIVEN("instantiated file object with large chunk")
+        {
+            constexpr const std::size_t chunk_size{64U * 1024U};
+            constexpr const ::blkcnt_t block_size{512};
+
+            std::string name{test_dir().append("mmap_file-write-allocate.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, chunk_size)};
+
+            WHEN("write the content")
+            {
+                CHECK_NOTHROW({ file->write("content"); });
+
+                THEN("the blocks of the whole chunk are allocated")
+                {
+                    struct ::stat status
+                    {
+                    };
+
+                    REQUIRE_EQ(::stat(name.c_str(), &status), 0);
+                    CHECK_GE(status.st_blocks * block_size,
+                             static_cast<::blkcnt_t>(chunk_size));
+                }
+            }
+        }
+    #endif
+
+        GIVEN("file is existed")
+        {
+            std::string name{unique_file_name("mmap_file-append")};
+            utils::file::set_content(name, std::string{"content"});
+
+            WHEN("write the content with file_open_mode::append")
+            {
+                auto file{std::make_unique<file_type>(
+                    name, file_open_mode::append, 8U)};
+                CHECK_NOTHROW({ file->write(" appended"); });
+
+                THEN("content is appended after the existed one")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content appended"});
+                }
+            }
+        }
+    }
+
+    SCENARIO("void mmap_file::flush()")
+    {
+        GIVEN("instantiated file object with content written inside")
+        {
+            std::string name{test_dir().append("mmap_file-flush.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, 16U)};
+            file->write("content");
+
+            WHEN("flush the file object")
+            {
+                CHECK_NOTHROW({ file->flush(); });
+
+                THEN("content is readable before the file is closed")
+                {
+                    CHECK_EQ(utils::file::get_content<char>(name).substr(0, 7),
+                             std::string{"content"});
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::file
+
+#endif
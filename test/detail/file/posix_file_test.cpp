@@ -0,0 +1,152 @@
+#if !defined(_WIN32)
+
+    #include "logency/detail/file/posix_file.hpp"
+
+    #include "file_directory.hpp"
+    #include "include_doctest.hpp"
+    #include "utils/check_exception.hpp"
+    #include "utils/file.hpp"
+
+    #include <filesystem>
+    #include <memory>
+    #include <string>
+    #include <tuple>
+
+namespace logency::unit_test::detail::file
+{
+
+TEST_SUITE("logency::detail::file::posix_file")
+{
+    using file_type = logency::detail::file::posix_file<char>;
+
+    SCENARIO("posix_file::posix_file(const std::string &, file_open_mode, "
+             "size_type)")
+    {
+        GIVEN("file is existed")
+        {
+            std::unique_ptr<file_type> file{nullptr};
+
+            std::string name{unique_file_name("posix_file-exist")};
+            utils::file::set_content(name, std::string{"content"});
+
+            WHEN("instantiate with file_open_mode::append")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(name,
+                                                       file_open_mode::append);
+                });
+
+                THEN("exist file is attached the object without clearing its "
+                     "content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+
+            WHEN("instantiate with file_open_mode::truncate")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(
+                        name, file_open_mode::truncate);
+                });
+
+                THEN("exist file is attached the object with empty content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{});
+                }
+            }
+        }
+
+        GIVEN("incorrect file name")
+        {
+            const std::string name{};
+
+            WHEN("instantiate it")
+            {
+                auto act{[&]()
+                         {
+                             std::ignore = std::make_unique<file_type>(
+                                 name, file_open_mode::append);
+                         }};
+
+                THEN("throw logency::system_error")
+                {
+                    utils::check::throw_start_with_as<logency::system_error>(
+                        act, "Failed to open file");
+                }
+            }
+        }
+    }
+
+    SCENARIO("void posix_file::write(string_view_type)")
+    {
+        GIVEN("instantiated file object with small buffer")
+        {
+            std::string name{test_dir().append("posix_file-write.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, 8U)};
+
+            WHEN("write the content which fits in the buffer")
+            {
+                CHECK_NOTHROW({ file->write("content"); });
+
+                THEN("content is kept until the file is closed")
+                {
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{});
+
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+
+            WHEN("write the content which does not fit in the buffer")
+            {
+                CHECK_NOTHROW({
+                    file->write("first ");
+                    file->write("content which is too long");
+                });
+
+                THEN("buffered and new content are written in order")
+                {
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"first content which is too long"});
+                }
+            }
+        }
+    }
+
+    SCENARIO("void posix_file::flush()")
+    {
+        GIVEN("instantiated file object with content written inside")
+        {
+            std::string name{test_dir().append("posix_file-flush.txt")};
+            auto file{
+                std::make_unique<file_type>(name, file_open_mode::truncate)};
+            file->write("content");
+
+            WHEN("flush the file object")
+            {
+                CHECK_NOTHROW({ file->flush(); });
+
+                THEN("content is written into the file")
+                {
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::file
+
+#endif
@@ -0,0 +1,186 @@
+#if defined(__linux__)
+
+    #include "logency/detail/file/uring_file.hpp"
+
+    #include "file_directory.hpp"
+    #include "include_doctest.hpp"
+    #include "utils/check_exception.hpp"
+    #include "utils/file.hpp"
+
+    #include <filesystem>
+    #include <memory>
+    #include <string>
+    #include <tuple>
+
+namespace logency::unit_test::detail::file
+{
+
+TEST_SUITE("logency::detail::file::uring_file")
+{
+    using file_type = logency::detail::file::uring_file<char>;
+
+    SCENARIO("uring_file::uring_file(const std::string &, file_open_mode, "
+             "size_type)")
+    {
+        GIVEN("file is existed")
+        {
+            std::unique_ptr<file_type> file{nullptr};
+
+            std::string name{unique_file_name("uring_file-exist")};
+            utils::file::set_content(name, std::string{"content"});
+
+            WHEN("instantiate with file_open_mode::append")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(name,
+                                                       file_open_mode::append);
+                });
+
+                THEN("exist file is attached the object without clearing its "
+                     "content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+
+            WHEN("instantiate with file_open_mode::truncate")
+            {
+                CHECK_NOTHROW({
+                    file = std::make_unique<file_type>(
+                        name, file_open_mode::truncate);
+                });
+
+                THEN("exist file is attached the object with empty content")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{});
+                }
+            }
+        }
+
+        GIVEN("incorrect file name")
+        {
+            const std::string name{};
+
+            WHEN("instantiate it")
+            {
+                auto act{[&]()
+                         {
+                             std::ignore = std::make_unique<file_type>(
+                                 name, file_open_mode::append);
+                         }};
+
+                THEN("throw logency::system_error")
+                {
+                    utils::check::throw_start_with_as<logency::system_error>(
+                        act, "Failed to open file");
+                }
+            }
+        }
+    }
+
+    SCENARIO("void uring_file::write(string_view_type)")
+    {
+        GIVEN("instantiated file object with small buffers")
+        {
+            std::string name{test_dir().append("uring_file-write.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, 8U, 2U)};
+
+            WHEN("write the content which is larger than the buffers")
+            {
+                CHECK_NOTHROW({
+                    file->write("first ");
+                    file->write("content which is much longer than the "
+                                "buffers");
+                });
+
+                THEN("content is written in order when the file is closed")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"first content which is much longer "
+                                         "than the buffers"});
+                }
+            }
+        }
+
+        GIVEN("instantiated file object with one buffer")
+        {
+            std::string name{test_dir().append("uring_file-write-sync.txt")};
+            auto file{std::make_unique<file_type>(
+                name, file_open_mode::truncate, 8U, 1U)};
+
+            WHEN("write the content which is larger than the buffer")
+            {
+                CHECK_NOTHROW({ file->write("content which is too long"); });
+
+                THEN("full buffers are written synchronously")
+                {
+                    CHECK_EQ(file->is_asynchronous(), false);
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content which is too lon"});
+
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content which is too long"});
+                }
+            }
+        }
+
+        GIVEN("file is existed")
+        {
+            std::string name{unique_file_name("uring_file-append")};
+            utils::file::set_content(name, std::string{"content"});
+
+            WHEN("write the content with file_open_mode::append")
+            {
+                auto file{std::make_unique<file_type>(
+                    name, file_open_mode::append, 4U, 2U)};
+                CHECK_NOTHROW({ file->write(" appended"); });
+
+                THEN("content is appended after the existed one")
+                {
+                    file.reset();
+
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content appended"});
+                }
+            }
+        }
+    }
+
+    SCENARIO("void uring_file::flush()")
+    {
+        GIVEN("instantiated file object with content written inside")
+        {
+            std::string name{test_dir().append("uring_file-flush.txt")};
+            auto file{
+                std::make_unique<file_type>(name, file_open_mode::truncate)};
+            file->write("content");
+
+            WHEN("flush the file object and close it")
+            {
+                CHECK_NOTHROW({ file->flush(); });
+                file.reset();
+
+                THEN("content is written into the file")
+                {
+                    CHECK_EQ(utils::file::get_content<char>(name),
+                             std::string{"content"});
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::file
+
+#endif
@@ -0,0 +1,76 @@
+#include "logency/detail/latency_histogram.hpp"
+
+#include "include_doctest.hpp"
+
+#include <chrono>
+
+namespace logency::unit_test::detail
+{
+
+TEST_SUITE("logency::detail::latency_histogram")
+{
+    using histogram_type = logency::detail::latency_histogram;
+    using std::chrono::nanoseconds;
+
+    SCENARIO("auto latency_histogram::summary() const noexcept "
+             "-> latency_stats")
+    {
+        GIVEN("empty histogram")
+        {
+            histogram_type histogram{};
+
+            THEN("everything is zero")
+            {
+                const auto summary{histogram.summary()};
+
+                CHECK_EQ(summary.count, 0U);
+                CHECK_EQ(summary.p50, nanoseconds{0});
+                CHECK_EQ(summary.max, nanoseconds{0});
+            }
+
+            WHEN("record 1 to 1000 nanoseconds")
+            {
+                for (int value{1}; value <= 1000; ++value)
+                {
+                    histogram.record(nanoseconds{value});
+                }
+
+                const auto summary{histogram.summary()};
+
+                THEN("the percentiles are within the bucket error")
+                {
+                    CHECK_EQ(summary.count, 1000U);
+                    CHECK_EQ(summary.max, nanoseconds{1000});
+
+                    CHECK_GE(summary.p50, nanoseconds{500});
+                    CHECK_LE(summary.p50, nanoseconds{500 + 500 / 32});
+
+                    CHECK_GE(summary.p99, nanoseconds{990});
+                    CHECK_LE(summary.p99, nanoseconds{1000});
+
+                    CHECK_GE(summary.p999, nanoseconds{999});
+                    CHECK_LE(summary.p999, nanoseconds{1000});
+                }
+            }
+
+            WHEN("record small and huge latencies")
+            {
+                histogram.record(nanoseconds{-1});
+                histogram.record(nanoseconds{7});
+                histogram.record(std::chrono::hours{1});
+
+                const auto summary{histogram.summary()};
+
+                THEN("negative one counts as zero, and the maximum is exact")
+                {
+                    CHECK_EQ(summary.count, 3U);
+                    CHECK_EQ(summary.p50, nanoseconds{7});
+                    CHECK_EQ(summary.max, std::chrono::hours{1});
+                    CHECK_EQ(summary.p999, std::chrono::hours{1});
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail
@@ -0,0 +1,204 @@
+#include "logency/detail/memory/block_pool.hpp"
+#include "logency/detail/memory/pool_allocator.hpp"
+
+#include "include_doctest.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace logency::unit_test::detail::memory
+{
+
+namespace
+{
+
+// Unique size so that no other test shares the pool.
+struct pooled_value
+{
+    std::uint64_t value[3]; // NOLINT(*-avoid-c-arrays)
+};
+
+using pool_type =
+    logency::detail::memory::block_pool<sizeof(pooled_value),
+                                        alignof(pooled_value)>;
+
+/**
+ * Thread local object which uses the pool after the cache of its thread is
+ * destroyed, like a pack freed during the thread exit.
+ */
+struct late_user
+{
+    late_user(const late_user &other) = delete;
+    late_user(late_user &&other) noexcept = delete;
+    auto operator=(const late_user &other) -> late_user & = delete;
+    auto operator=(late_user &&other) noexcept -> late_user & = delete;
+
+    late_user() = default;
+
+    ~late_user()
+    {
+        auto &pool{pool_type::instance()};
+
+        *allocated = pool.allocate();
+        pool.deallocate(freed);
+    }
+
+    void *freed{nullptr};
+    void **allocated{nullptr};
+};
+
+} // namespace
+
+TEST_SUITE("logency::detail::memory::block_pool")
+{
+    SCENARIO("auto block_pool::allocate() -> void *")
+    {
+        GIVEN("a block freed by the same thread")
+        {
+            auto &pool{pool_type::instance()};
+
+            auto *freed{pool.allocate()};
+            pool.deallocate(freed);
+
+            WHEN("allocate again")
+            {
+                auto *block{pool.allocate()};
+
+                THEN("the freed block is reused")
+                {
+                    CHECK_EQ(block, freed);
+                }
+
+                pool.deallocate(block);
+            }
+        }
+
+        GIVEN("blocks allocated by one thread and freed by another")
+        {
+            constexpr const std::size_t rounds{16U};
+            constexpr const std::size_t count{pool_type::chain_size * 4U};
+
+            auto &pool{pool_type::instance()};
+
+            WHEN("repeat it many times")
+            {
+                std::vector<void *> blocks;
+                blocks.reserve(count);
+
+                for (std::size_t iter{0U}; iter < count; ++iter)
+                {
+                    blocks.push_back(pool.allocate());
+                }
+
+                std::async(std::launch::async, [&] {
+                    for (auto *block : blocks)
+                    {
+                        pool.deallocate(block);
+                    }
+                }).get();
+
+                const auto slab_count{pool.slab_count()};
+
+                for (std::size_t round{0U}; round < rounds; ++round)
+                {
+                    blocks.clear();
+
+                    for (std::size_t iter{0U}; iter < count; ++iter)
+                    {
+                        blocks.push_back(pool.allocate());
+                    }
+
+                    std::async(std::launch::async, [&] {
+                        for (auto *block : blocks)
+                        {
+                            pool.deallocate(block);
+                        }
+                    }).get();
+                }
+
+                THEN("no slab is requested once the pool is warm")
+                {
+                    CHECK_EQ(pool.slab_count(), slab_count);
+                }
+            }
+        }
+
+        GIVEN("a thread which uses the pool after its cache is destroyed")
+        {
+            auto &pool{pool_type::instance()};
+
+            void *late{nullptr};
+
+            std::thread{[&]
+                        {
+                            // Constructed first, hence destroyed last.
+                            thread_local late_user user{};
+                            user.allocated = &late;
+                            user.freed = pool.allocate();
+                        }}
+                .join();
+
+            WHEN("allocate the blocks of the shared pool")
+            {
+                std::vector<void *> blocks;
+
+                for (std::size_t iter{0U}; iter < pool_type::chain_size * 4U;
+                     ++iter)
+                {
+                    blocks.push_back(pool.allocate());
+                }
+
+                THEN("the block allocated late is not handed out again")
+                {
+                    CHECK_NE(late, nullptr);
+                    CHECK_EQ(std::find(blocks.begin(), blocks.end(), late),
+                             blocks.end());
+                }
+
+                for (auto *block : blocks)
+                {
+                    pool.deallocate(block);
+                }
+
+                pool.deallocate(late);
+            }
+        }
+    }
+}
+
+TEST_SUITE("logency::detail::memory::pool_allocator")
+{
+    SCENARIO("std::allocate_shared() with pool_allocator")
+    {
+        GIVEN("pool allocator")
+        {
+            using allocator_type =
+                logency::detail::memory::pool_allocator<pooled_value>;
+
+            WHEN("allocate shared object")
+            {
+                auto pointer{std::allocate_shared<pooled_value>(
+                    allocator_type{}, pooled_value{{1U, 2U, 3U}})};
+
+                THEN("object is constructed")
+                {
+                    CHECK_EQ(pointer->value[2], 3U);
+                }
+            }
+
+            WHEN("compare it with rebound allocator")
+            {
+                const logency::detail::memory::pool_allocator<int> other{};
+
+                THEN("they are equal") { CHECK(allocator_type{} == other); }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::memory
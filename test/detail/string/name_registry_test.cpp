@@ -0,0 +1,90 @@
+#include "logency/detail/string/name_registry.hpp"
+
+#include "include_doctest.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace logency::unit_test::detail::string
+{
+
+TEST_SUITE("logency::detail::string::name_registry")
+{
+    using registry_type = logency::detail::string::name_registry<std::string>;
+
+    SCENARIO("auto name_registry<StringType>::intern(string_view_type) "
+             "-> id_type")
+    {
+        GIVEN("empty registry")
+        {
+            registry_type registry{};
+
+            WHEN("intern different names")
+            {
+                const auto first{registry.intern("first")};
+                const auto second{registry.intern("second")};
+
+                THEN("they get sequential IDs")
+                {
+                    CHECK_EQ(first, 0U);
+                    CHECK_EQ(second, 1U);
+                    CHECK_EQ(registry.size(), 2U);
+                }
+
+                AND_THEN("the IDs resolve to the names")
+                {
+                    CHECK_EQ(registry.resolve(first), "first");
+                    CHECK_EQ(registry.resolve(second), "second");
+                }
+            }
+
+            WHEN("intern the same name twice")
+            {
+                std::string name{"same"};
+
+                const auto first{registry.intern(name)};
+                const auto view{registry.resolve(first)};
+
+                name = "changed";
+                const auto second{registry.intern("same")};
+
+                THEN("it is stored once, and does not refer to the argument")
+                {
+                    CHECK_EQ(first, second);
+                    CHECK_EQ(registry.size(), 1U);
+                    CHECK_EQ(view, "same");
+                }
+            }
+
+            WHEN("intern many names")
+            {
+                const auto view{registry.resolve(registry.intern("kept"))};
+
+                for (int count{0}; count < 1000; ++count)
+                {
+                    static_cast<void>(
+                        registry.intern("name-" + std::to_string(count)));
+                }
+
+                THEN("the view of the former name is still valid")
+                {
+                    CHECK_EQ(view, "kept");
+                    CHECK_EQ(view.data(), registry.resolve(0U).data());
+                }
+            }
+
+            WHEN("resolve the ID which is not interned")
+            {
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        static_cast<void>(registry.resolve(0U)),
+                        "No such name in the registry.",
+                        logency::runtime_error);
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::string
@@ -2,6 +2,7 @@
 
 #include "include_doctest.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -276,6 +277,121 @@ TEST_SUITE("logency::detail::thread::blocking_pair_queue")
         }
     }
 
+    SCENARIO("blocking_pair_queue::blocking_pair_queue(size_type, size_type, "
+             "overflow_policy, droppable_type)")
+    {
+        constexpr const std::size_t max_size{2U};
+        const container_type<second_type> items{{0, 1, 2, 3, 4}};
+
+        auto enqueue_all{[&items](queue_type &queue)
+                         {
+                             for (const auto item : items)
+                             {
+                                 std::ignore = queue.enqueue(
+                                     first_type{item}, second_type{item});
+                             }
+                         }};
+
+        GIVEN("bounded queue which drops newest item pair")
+        {
+            queue_type queue{0U, max_size,
+                             logency::overflow_policy::drop_newest};
+
+            WHEN("enqueue more item pairs than its maximum size")
+            {
+                enqueue_all(queue);
+
+                THEN("first item pairs are kept")
+                {
+                    container_type<first_type> first_tray;
+                    container_type<second_type> second_tray;
+                    std::ignore = queue.try_swap_bulk(first_tray, second_tray);
+
+                    CHECK_EQ(first_tray, container_type<first_type>{0, 1});
+                    CHECK_EQ(second_tray, container_type<second_type>{0, 1});
+                    CHECK_EQ(queue.dropped(), items.size() - max_size);
+                }
+            }
+        }
+
+        GIVEN("bounded queue which drops oldest item pair")
+        {
+            queue_type queue{0U, max_size,
+                             logency::overflow_policy::drop_oldest};
+
+            WHEN("enqueue more item pairs than its maximum size")
+            {
+                enqueue_all(queue);
+
+                THEN("last item pairs are kept")
+                {
+                    CHECK(queue.is_full());
+
+                    container_type<first_type> first_tray;
+                    container_type<second_type> second_tray;
+                    std::ignore = queue.try_swap_bulk(first_tray, second_tray);
+
+                    CHECK_EQ(first_tray, container_type<first_type>{3, 4});
+                    CHECK_EQ(second_tray, container_type<second_type>{3, 4});
+                    CHECK_EQ(queue.dropped(), items.size() - max_size);
+                }
+            }
+        }
+
+        GIVEN("bounded queue which drops odd item pairs by level")
+        {
+            queue_type queue{0U, max_size,
+                             logency::overflow_policy::drop_by_level,
+                             [](const first_type & /*first*/,
+                                const second_type &second)
+                             { return (second % 2) != 0; }};
+
+            WHEN("enqueue more item pairs while consumer drains it")
+            {
+                auto consumer{std::async(
+                    std::launch::async,
+                    [&]
+                    {
+                        container_type<first_type> first_tray;
+                        container_type<second_type> second_tray;
+                        container_type<second_type> result;
+
+                        while (result.size() + queue.dropped() < items.size())
+                        {
+                            if (queue.try_swap_bulk(first_tray, second_tray))
+                            {
+                                result.insert(result.end(),
+                                              second_tray.begin(),
+                                              second_tray.end());
+                                first_tray.clear();
+                                second_tray.clear();
+                            }
+                        }
+
+                        return result;
+                    })};
+
+                enqueue_all(queue);
+
+                THEN("only droppable item pairs are dropped")
+                {
+                    const auto result{consumer.get()};
+                    bool is_kept{true};
+
+                    for (const auto item : {0, 2, 4})
+                    {
+                        is_kept = is_kept &&
+                                  (std::find(result.begin(), result.end(),
+                                             item) != result.end());
+                    }
+
+                    CHECK(is_kept);
+                    CHECK_EQ(result.size() + queue.dropped(), items.size());
+                }
+            }
+        }
+    }
+
     SCENARIO("blocking_queue::~blocking_queue()")
     {
         GIVEN("instantiated object")
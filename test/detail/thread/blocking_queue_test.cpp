@@ -6,6 +6,7 @@
 #include <chrono>
 #include <cstddef>
 #include <future>
+#include <memory>
 #include <tuple>
 #include <vcruntime.h>
 #include <vector>
@@ -264,6 +265,139 @@ TEST_SUITE("logency::detail::thread::blocking_queue")
         }
     }
 
+    SCENARIO("blocking_queue::blocking_queue(size_type, size_type, "
+             "overflow_policy, droppable_type, full_handler_type)")
+    {
+        constexpr const std::size_t max_size{2U};
+        const container_type<value_type> items{{0, 1, 2, 3, 4}};
+
+        auto enqueue_all{[&items](queue_type &queue)
+                         {
+                             for (const auto item : items)
+                             {
+                                 std::ignore = queue.enqueue(item);
+                             }
+                         }};
+
+        GIVEN("bounded queue which drops newest item")
+        {
+            queue_type queue{0U, max_size,
+                             logency::overflow_policy::drop_newest};
+
+            WHEN("enqueue more items than its maximum size")
+            {
+                enqueue_all(queue);
+
+                THEN("first items are kept")
+                {
+                    container_type<value_type> tray;
+                    std::ignore = queue.try_swap_bulk(tray);
+
+                    CHECK(!queue.is_full());
+                    CHECK_EQ(tray, container_type<value_type>{0, 1});
+                    CHECK_EQ(queue.dropped(), items.size() - max_size);
+                }
+            }
+        }
+
+        GIVEN("bounded queue which drops oldest item")
+        {
+            queue_type queue{0U, max_size,
+                             logency::overflow_policy::drop_oldest};
+
+            WHEN("enqueue more items than its maximum size")
+            {
+                enqueue_all(queue);
+
+                THEN("last items are kept")
+                {
+                    CHECK(queue.is_full());
+                    CHECK_EQ(queue.size(), max_size);
+
+                    container_type<value_type> tray;
+                    std::ignore = queue.try_swap_bulk(tray);
+
+                    CHECK_EQ(tray, container_type<value_type>{3, 4});
+                    CHECK_EQ(queue.dropped(), items.size() - max_size);
+                }
+            }
+        }
+
+        GIVEN("bounded queue which drops odd items by level")
+        {
+            int handled{0};
+            container_type<value_type> consumed;
+            std::unique_ptr<queue_type> queue{};
+
+            // Only every second call frees space, so one call is not enough.
+            queue = std::make_unique<queue_type>(
+                0U, max_size, logency::overflow_policy::drop_by_level,
+                [](const value_type &value) { return (value % 2) != 0; },
+                [&]
+                {
+                    if ((++handled % 2) == 0)
+                    {
+                        std::ignore = queue->try_swap_bulk(consumed);
+                    }
+                });
+
+            WHEN("enqueue more items than its maximum size")
+            {
+                for (const auto item : {0, 2, 1, 4, 3})
+                {
+                    std::ignore = queue->enqueue(item);
+                }
+
+                THEN("droppable items are dropped, others wait for space")
+                {
+                    container_type<value_type> tray;
+                    std::ignore = queue->try_swap_bulk(tray);
+
+                    CHECK_EQ(consumed, container_type<value_type>{0, 2});
+                    CHECK_EQ(tray, container_type<value_type>{4, 3});
+                    CHECK_EQ(queue->dropped(), 1U);
+                    CHECK_EQ(handled, 2);
+                }
+            }
+        }
+
+        GIVEN("bounded queue which blocks")
+        {
+            queue_type queue{0U, max_size, logency::overflow_policy::block};
+
+            WHEN("enqueue more items while consumer drains it")
+            {
+                auto consumer{std::async(
+                    std::launch::async,
+                    [&]
+                    {
+                        container_type<value_type> result;
+                        container_type<value_type> tray;
+
+                        while (result.size() < items.size())
+                        {
+                            if (queue.try_swap_bulk(tray))
+                            {
+                                result.insert(result.end(), tray.begin(),
+                                              tray.end());
+                                tray.clear();
+                            }
+                        }
+
+                        return result;
+                    })};
+
+                enqueue_all(queue);
+
+                THEN("every item is consumed in the same order")
+                {
+                    CHECK_EQ(consumer.get(), items);
+                    CHECK_EQ(queue.dropped(), 0U);
+                }
+            }
+        }
+    }
+
     SCENARIO("blocking_queue::~blocking_queue()")
     {
         GIVEN("instantiated object")
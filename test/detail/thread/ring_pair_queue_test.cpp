@@ -0,0 +1,334 @@
+#include "logency/detail/thread/ring_pair_queue.hpp"
+
+#include "logency/core/exception.hpp"
+
+#include "include_doctest.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace logency::unit_test::detail::thread
+{
+
+namespace
+{
+
+template <typename T, typename U>
+auto produce_and_consume(std::size_t capacity, int producer,
+                         int messages_per_producer) -> std::vector<U>
+{
+    using queue_type = logency::detail::thread::ring_pair_queue<T, U>;
+
+    queue_type queue{capacity};
+    std::atomic<int> finished_producer{0};
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(static_cast<std::size_t>(producer));
+
+    for (int who{0}; who < producer; ++who)
+    {
+        futures.push_back(std::async(std::launch::async, [&, who] {
+            for (int message{0}; message < messages_per_producer; ++message)
+            {
+                std::ignore = queue.enqueue(
+                    T{who}, U{(who * messages_per_producer) + message});
+            }
+
+            finished_producer.fetch_add(1, std::memory_order_release);
+        }));
+    }
+
+    std::vector<T> first_tray;
+    std::vector<U> second_tray;
+
+    for (;;)
+    {
+        const bool is_finished{
+            finished_producer.load(std::memory_order_acquire) == producer};
+
+        if (!queue.try_swap_bulk(first_tray, second_tray) && is_finished)
+        {
+            break;
+        }
+    }
+
+    for (auto &future : futures)
+    {
+        future.get();
+    }
+
+    return second_tray;
+}
+
+} // namespace
+
+TEST_SUITE("logency::detail::thread::ring_pair_queue")
+{
+    using first_type = int;
+    using second_type = int;
+    using queue_type =
+        logency::detail::thread::ring_pair_queue<first_type, second_type>;
+
+    template <typename T>
+    using container_type = typename queue_type::container_type<T>;
+
+    SCENARIO("ring_pair_queue::ring_pair_queue(size_type)")
+    {
+        GIVEN("not instantiated object")
+        {
+            std::unique_ptr<queue_type> queue{nullptr};
+
+            WHEN("instantiate it with default capacity")
+            {
+                CHECK_NOTHROW({ queue = std::make_unique<queue_type>(); });
+
+                THEN("capacity is the default capacity")
+                {
+                    CHECK_EQ(queue->capacity(), queue_type::default_capacity);
+                }
+            }
+
+            WHEN("instantiate it with zero capacity")
+            {
+                CHECK_NOTHROW({ queue = std::make_unique<queue_type>(0U); });
+
+                THEN("capacity is the default capacity")
+                {
+                    CHECK_EQ(queue->capacity(), queue_type::default_capacity);
+                }
+            }
+
+            WHEN("instantiate it with capacity which is not power of two")
+            {
+                CHECK_NOTHROW({ queue = std::make_unique<queue_type>(5U); });
+
+                THEN("capacity is rounded up to the power of two")
+                {
+                    CHECK_EQ(queue->capacity(), 8U);
+                }
+            }
+        }
+    }
+
+    SCENARIO("bool ring_pair_queue::enqueue(first_type &&, second_type &&)")
+    {
+        GIVEN("an empty queue")
+        {
+            queue_type queue{4U};
+
+            WHEN("enqueue multiple items")
+            {
+                const container_type<first_type> first_items{{0, 1, 2}};
+                const container_type<second_type> second_items{{3, 4, 5}};
+                std::vector<bool> return_codes{};
+
+                CHECK_NOTHROW({
+                    for (std::size_t index{0U}; index < first_items.size();
+                         ++index)
+                    {
+                        return_codes.push_back(
+                            queue.enqueue(first_type{first_items[index]},
+                                          second_type{second_items[index]}));
+                    }
+                });
+
+                THEN("first one return true, others return false")
+                {
+                    CHECK_EQ(return_codes,
+                             std::vector<bool>{true, false, false});
+                    CHECK_EQ(queue.size(), first_items.size());
+
+                    AND_THEN("expect item is enqueued inside in the same order")
+                    {
+                        container_type<first_type> first_tray;
+                        container_type<second_type> second_tray;
+                        std::ignore =
+                            queue.try_swap_bulk(first_tray, second_tray);
+
+                        CHECK_EQ(first_tray, first_items);
+                        CHECK_EQ(second_tray, second_items);
+                    }
+                }
+            }
+        }
+
+        GIVEN("a queue which has been drained")
+        {
+            queue_type queue{4U};
+            std::ignore = queue.enqueue(0, 0);
+
+            container_type<first_type> first_tray;
+            container_type<second_type> second_tray;
+            std::ignore = queue.try_swap_bulk(first_tray, second_tray);
+
+            WHEN("enqueue one item")
+            {
+                bool return_code{};
+
+                CHECK_NOTHROW({ return_code = queue.enqueue(1, 1); });
+
+                THEN("return true") { CHECK(return_code); }
+            }
+        }
+    }
+
+    SCENARIO("bool ring_pair_queue::try_swap_bulk("
+             "container_type<first_type> &, container_type<second_type> &)")
+    {
+        GIVEN("an empty queue")
+        {
+            queue_type queue{4U};
+
+            WHEN("try to swap container")
+            {
+                container_type<first_type> first_tray;
+                container_type<second_type> second_tray;
+                bool return_code{true};
+
+                CHECK_NOTHROW({
+                    return_code = queue.try_swap_bulk(first_tray, second_tray);
+                });
+
+                THEN("return false")
+                {
+                    CHECK(!return_code);
+                    CHECK(first_tray.empty());
+                    CHECK(second_tray.empty());
+                }
+            }
+        }
+
+        GIVEN("a queue which wraps around several times")
+        {
+            constexpr const int rounds{5};
+            queue_type queue{4U};
+
+            container_type<second_type> expected;
+            container_type<first_type> first_tray;
+            container_type<second_type> second_tray;
+
+            WHEN("fill and drain it repeatedly")
+            {
+                for (int round{0}; round < rounds; ++round)
+                {
+                    for (int item{0}; item < 4; ++item)
+                    {
+                        expected.push_back((round * 4) + item);
+                        std::ignore =
+                            queue.enqueue(first_type{}, (round * 4) + item);
+                    }
+
+                    std::ignore = queue.try_swap_bulk(first_tray, second_tray);
+                }
+
+                THEN("every item is drained in the same order")
+                {
+                    CHECK_EQ(second_tray, expected);
+                    CHECK(queue.is_empty());
+                }
+            }
+        }
+    }
+
+    SCENARIO("bool ring_pair_queue::enqueue(first_type &&, second_type &&) "
+             "with overflow policy")
+    {
+        GIVEN("full queue which drops newest item pair")
+        {
+            queue_type queue{4U, logency::overflow_policy::drop_newest};
+
+            for (int item{0}; item < 4; ++item)
+            {
+                std::ignore =
+                    queue.enqueue(first_type{item}, second_type{item});
+            }
+
+            WHEN("enqueue one more item pair")
+            {
+                bool return_code{true};
+
+                CHECK_NOTHROW({ return_code = queue.enqueue(0, 4); });
+
+                THEN("it is dropped without notification")
+                {
+                    CHECK(!return_code);
+                    CHECK_EQ(queue.dropped(), 1U);
+
+                    container_type<first_type> first_tray;
+                    container_type<second_type> second_tray;
+                    std::ignore = queue.try_swap_bulk(first_tray, second_tray);
+
+                    CHECK_EQ(second_tray.size(), 4U);
+                }
+            }
+        }
+
+        GIVEN("not instantiated object")
+        {
+            std::unique_ptr<queue_type> queue{nullptr};
+
+            WHEN("instantiate it to drop oldest item pair")
+            {
+                auto act{[&]
+                         {
+                             queue = std::make_unique<queue_type>(
+                                 4U, logency::overflow_policy::drop_oldest);
+                         }};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        act(),
+                        "Overflow policy is not supported by this queue.",
+                        logency::runtime_error);
+                }
+            }
+        }
+    }
+
+    SCENARIO("multiple producer single consumer")
+    {
+        constexpr const int producer{4};
+        constexpr const int messages_per_producer{10000};
+
+        GIVEN("a ring smaller than the produced items")
+        {
+            constexpr const std::size_t capacity{64U};
+
+            WHEN("produce items concurrently")
+            {
+                const auto consumed{
+                    produce_and_consume<first_type, second_type>(
+                        capacity, producer, messages_per_producer)};
+
+                THEN("consume exactly how many it was produced")
+                {
+                    REQUIRE_EQ(consumed.size(), static_cast<std::size_t>(
+                                                    producer *
+                                                    messages_per_producer));
+
+                    AND_THEN("items of the same producer keep their order")
+                    {
+                        std::vector<int> last(producer, -1);
+                        bool is_ordered{true};
+
+                        for (const auto item : consumed)
+                        {
+                            const auto who{item / messages_per_producer};
+                            is_ordered = is_ordered && (item > last[who]);
+                            last[who] = item;
+                        }
+
+                        CHECK(is_ordered);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::thread
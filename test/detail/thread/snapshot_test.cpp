@@ -0,0 +1,135 @@
+#include "logency/detail/thread/snapshot.hpp"
+
+#include "include_doctest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace logency::unit_test::detail::thread
+{
+
+TEST_SUITE("logency::detail::thread::snapshot")
+{
+    using snapshot_type = logency::detail::thread::snapshot<std::vector<int>>;
+
+    SCENARIO("void snapshot<T>::update(std::unique_ptr<const T>)")
+    {
+        GIVEN("snapshot of {1, 2}")
+        {
+            snapshot_type snapshot{
+                std::make_unique<const std::vector<int>>(
+                    std::vector<int>{1, 2})};
+
+            THEN("reader sees the value")
+            {
+                const auto value{snapshot.read()};
+
+                CHECK_EQ(value->size(), 2U);
+                CHECK_EQ((*value)[1], 2);
+            }
+
+            WHEN("update it to {3}")
+            {
+                snapshot.update(std::make_unique<const std::vector<int>>(
+                    std::vector<int>{3}));
+
+                THEN("new reader sees the new value")
+                {
+                    const auto value{snapshot.read()};
+
+                    CHECK_EQ(value->size(), 1U);
+                    CHECK_EQ(value->front(), 3);
+                }
+            }
+
+            WHEN("update it while a reader refers to the old value")
+            {
+                std::atomic<bool> is_updated{false};
+                std::thread writer{};
+                {
+                    const auto value{snapshot.read()};
+
+                    writer = std::thread{
+                        [&]
+                        {
+                            snapshot.update(
+                                std::make_unique<const std::vector<int>>(
+                                    std::vector<int>{3}));
+                            is_updated = true;
+                        }};
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+                    THEN("the writer waits, and the old value is still valid")
+                    {
+                        CHECK_EQ(is_updated.load(), false);
+                        CHECK_EQ(value->size(), 2U);
+                        CHECK_EQ(snapshot.read()->size(), 1U);
+                    }
+                }
+
+                writer.join();
+
+                AND_THEN("the writer finishes after the reader leaves")
+                {
+                    CHECK(is_updated.load());
+                }
+            }
+        }
+
+        GIVEN("readers and a writer running at the same time")
+        {
+            snapshot_type snapshot{std::make_unique<const std::vector<int>>(
+                std::vector<int>(8U, 0))};
+
+            std::atomic<bool> is_stopped{false};
+            std::atomic<int> broken_count{0};
+
+            std::vector<std::thread> readers{};
+            for (int count{0}; count < 4; ++count)
+            {
+                readers.emplace_back(
+                    [&]
+                    {
+                        while (!is_stopped.load())
+                        {
+                            const auto value{snapshot.read()};
+                            for (const auto item : *value)
+                            {
+                                if (item != value->front())
+                                {
+                                    broken_count.fetch_add(1);
+                                }
+                            }
+                        }
+                    });
+            }
+
+            WHEN("the writer keeps replacing the value")
+            {
+                for (int round{1}; round <= 200; ++round)
+                {
+                    snapshot.update(std::make_unique<const std::vector<int>>(
+                        std::vector<int>(8U, round)));
+                }
+
+                is_stopped = true;
+                for (auto &reader : readers)
+                {
+                    reader.join();
+                }
+
+                THEN("every reader sees a whole value")
+                {
+                    CHECK_EQ(broken_count.load(), 0);
+                    CHECK_EQ(snapshot.read()->front(), 200);
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::thread
@@ -46,6 +46,43 @@ void fake_thread_unit::operate_by_thread()
     finished_->fetch_add(1, std::memory_order::memory_order_relaxed);
 }
 
+class spawning_thread_unit
+    : public logency::detail::thread::thread_unit_interface
+{
+public:
+    spawning_thread_unit(logency::detail::thread::thread_pool *pool,
+                         std::atomic<int> *ref, int depth) noexcept;
+
+protected:
+    void operate_by_thread() override;
+
+private:
+    logency::detail::thread::thread_pool *pool_;
+    std::atomic<int> *finished_;
+    int depth_;
+};
+
+spawning_thread_unit::spawning_thread_unit(
+    logency::detail::thread::thread_pool *pool, std::atomic<int> *ref,
+    int depth) noexcept
+    : pool_(pool), finished_(ref), depth_(depth)
+{
+}
+
+void spawning_thread_unit::operate_by_thread()
+{
+    // Enqueue from a worker, which goes to its own deque.
+    if (depth_ > 0)
+    {
+        pool_->enqueue(std::make_unique<spawning_thread_unit>(
+            pool_, finished_, depth_ - 1));
+        pool_->enqueue(std::make_unique<spawning_thread_unit>(
+            pool_, finished_, depth_ - 1));
+    }
+
+    finished_->fetch_add(1, std::memory_order::memory_order_relaxed);
+}
+
 } // namespace
 
 TEST_SUITE("logency::detail::thread::thread_pool")
@@ -143,6 +180,32 @@ TEST_SUITE("logency::detail::thread::thread_pool")
                 }
             }
         }
+
+        GIVEN("a pool with several threads and tasks enqueued by tasks")
+        {
+            constexpr const size_type thread_number{4U};
+            auto pool{std::make_unique<thread_pool_type>(thread_number)};
+
+            constexpr const int depth{12};
+            constexpr const int expect{(1 << (depth + 1)) - 1};
+            std::atomic<int> counter_{0};
+
+            pool->enqueue(std::make_unique<spawning_thread_unit>(
+                pool.get(), &counter_, depth));
+
+            WHEN("wait until thread queue is empty")
+            {
+                CHECK_NOTHROW({ pool->wait_until_queue_empty(); });
+
+                THEN("expect the tasks enqueued by the workers are finished "
+                     "as well")
+                {
+                    CHECK_EQ(
+                        counter_.load(std::memory_order::memory_order_relaxed),
+                        expect);
+                }
+            }
+        }
     }
 }
 
@@ -0,0 +1,119 @@
+#include "logency/detail/thread/thread_unit_token.hpp"
+#include "logency/detail/thread/thread_pool.hpp"
+
+#include "include_doctest.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace logency::unit_test::detail::thread
+{
+
+namespace
+{
+
+class fake_owner : public std::enable_shared_from_this<fake_owner>
+{
+public:
+    using token_type = logency::detail::thread::thread_unit_token<fake_owner>;
+
+    [[nodiscard]] auto token() noexcept -> token_type & { return token_; }
+    [[nodiscard]] int run_count() const noexcept
+    {
+        return run_count_.load(std::memory_order::memory_order_relaxed);
+    }
+
+private:
+    void run() { run_count_.fetch_add(1); }
+
+    std::atomic<int> run_count_{0};
+    token_type token_{*this, &fake_owner::run};
+};
+
+class blocking_thread_unit
+    : public logency::detail::thread::thread_unit_interface
+{
+public:
+    explicit blocking_thread_unit(const std::atomic<bool> *ref) noexcept
+        : released_(ref)
+    {
+    }
+
+protected:
+    void operate_by_thread() override
+    {
+        while (!released_->load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const std::atomic<bool> *released_;
+};
+
+} // namespace
+
+TEST_SUITE("logency::detail::thread::thread_unit_token")
+{
+    using thread_pool_type = logency::detail::thread::thread_pool;
+
+    SCENARIO("bool thread_unit_token<Owner>::schedule(thread_pool &)")
+    {
+        GIVEN("a pool whose only thread is busy")
+        {
+            thread_pool_type pool{1U};
+
+            std::atomic<bool> released{false};
+            pool.enqueue(std::make_unique<blocking_thread_unit>(&released));
+
+            auto owner{std::make_shared<fake_owner>()};
+
+            WHEN("schedule the token several times before it runs")
+            {
+                const bool first{owner->token().schedule(pool)};
+                const bool second{owner->token().schedule(pool)};
+
+                released = true;
+                pool.wait_until_queue_empty();
+
+                THEN("only the first one is enqueued and run")
+                {
+                    CHECK(first);
+                    CHECK_EQ(second, false);
+                    CHECK_EQ(owner->run_count(), 1);
+                }
+
+                AND_THEN("it can be scheduled again after it runs")
+                {
+                    CHECK(owner->token().schedule(pool));
+
+                    pool.wait_until_queue_empty();
+
+                    CHECK_EQ(owner->run_count(), 2);
+                }
+            }
+
+            WHEN("the owner is released while the token is queued")
+            {
+                std::weak_ptr<fake_owner> observer{owner};
+
+                owner->token().schedule(pool);
+                owner.reset();
+
+                THEN("the owner is kept alive until the token runs")
+                {
+                    CHECK(!observer.expired());
+
+                    released = true;
+                    pool.wait_until_queue_empty();
+
+                    CHECK(observer.expired());
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::detail::thread
@@ -11,7 +11,10 @@
 
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 namespace logency::unit_test
 {
@@ -95,7 +98,6 @@ auto queue_only_dispatcher(std::size_t &size)
 TEST_SUITE("logency::dispatcher")
 {
     using message_type = utils::message<char>;
-    using string_type = message_type::string_type;
     using string_view_type = message_type::string_view_type;
 
     using dispatcher_type = logency::dispatcher<message_type>;
@@ -225,8 +227,7 @@ TEST_SUITE("logency::dispatcher")
                     dispatcher->enqueue(
                         std::shared_ptr<logger_type>{logger},
                         make_message_pack<utils::message<char>>(
-                            std::make_shared<string_type>(logger->name()),
-                            message_type{}));
+                            logger->id(), "logger", message_type{}));
                 });
 
                 THEN("message is successfully queued in")
@@ -270,6 +271,211 @@ TEST_SUITE("logency::dispatcher")
         }
     }
 
+    SCENARIO("dispatcher::dispatcher(std::weak_ptr<thread_pool_type>, "
+             "dispatcher_option)")
+    {
+        GIVEN("lock free queue option")
+        {
+            logency::dispatcher_option option;
+            option.queue = logency::dispatcher_queue::lock_free;
+            option.capacity = 5U;
+
+            WHEN("instantiate it")
+            {
+                std::shared_ptr<dispatcher_type> dispatcher{nullptr};
+
+                CHECK_NOTHROW({
+                    dispatcher = std::make_shared<dispatcher_type>(
+                        global_resource::thread_pool::normal(), option);
+                });
+
+                THEN("capacity is rounded up to the power of two")
+                {
+                    CHECK_EQ(dispatcher->queue_capacity(), 8U);
+                }
+            }
+
+            WHEN("queue messages more than its capacity")
+            {
+                constexpr const int messages{32};
+
+                auto dispatcher{std::make_shared<dispatcher_type>(
+                    global_resource::thread_pool::normal(), option)};
+                auto sink{std::make_shared<sink_type>(
+                    "sink", std::make_unique<sink_module>(),
+                    global_resource::thread_pool::normal())};
+                auto logger{new_logger(dispatcher, sink)};
+
+                CHECK_NOTHROW({
+                    for (int iter{0}; iter < messages; ++iter)
+                    {
+                        dispatcher->enqueue(
+                            std::shared_ptr<logger_type>{logger},
+                            make_message_pack<utils::message<char>>(
+                                logger->id(), "logger", message_type{}));
+                    }
+                });
+
+                THEN("every message is successfully dispatched")
+                {
+                    global_resource::thread_pool::normal()
+                        ->wait_until_queue_empty();
+
+                    CHECK_EQ(
+                        dynamic_cast<const sink_module &>(sink->sink_module())
+                            .log_counter(),
+                        messages);
+                }
+            }
+        }
+    }
+
+    SCENARIO("dispatcher::dispatcher(std::weak_ptr<thread_pool_type>, "
+             "dispatcher_option) with per thread queue")
+    {
+        GIVEN("per thread queue option")
+        {
+            logency::dispatcher_option option;
+            option.queue = logency::dispatcher_queue::per_thread;
+            option.capacity = 4U;
+
+            WHEN("queue messages from multiple threads")
+            {
+                constexpr const int producers{4};
+                constexpr const int messages{32};
+
+                auto dispatcher{std::make_shared<dispatcher_type>(
+                    global_resource::thread_pool::normal(), option)};
+                auto sink{std::make_shared<sink_type>(
+                    "sink", std::make_unique<sink_module>(),
+                    global_resource::thread_pool::normal())};
+                auto logger{new_logger(dispatcher, sink)};
+
+                std::vector<std::thread> threads;
+
+                for (int who{0}; who < producers; ++who)
+                {
+                    threads.emplace_back([&] {
+                        for (int iter{0}; iter < messages; ++iter)
+                        {
+                            dispatcher->enqueue(
+                                std::shared_ptr<logger_type>{logger},
+                                make_message_pack<utils::message<char>>(
+                                    logger->id(), "logger", message_type{}));
+                        }
+                    });
+                }
+
+                for (auto &thread : threads)
+                {
+                    thread.join();
+                }
+
+                THEN("every message is successfully dispatched")
+                {
+                    global_resource::thread_pool::normal()
+                        ->wait_until_queue_empty();
+
+                    CHECK_EQ(
+                        dynamic_cast<const sink_module &>(sink->sink_module())
+                            .log_counter(),
+                        producers * messages);
+                    CHECK(dispatcher->is_queue_empty());
+                }
+            }
+        }
+    }
+
+    SCENARIO("auto dispatcher::dropped_count() const noexcept -> size_type")
+    {
+        using pool_type = logency::detail::thread::thread_pool;
+
+        constexpr const std::size_t capacity{2U};
+        constexpr const std::size_t messages{5U};
+
+        auto enqueue_all{[](dispatcher_type &dispatcher)
+                         {
+                             for (std::size_t iter{0U}; iter < messages;
+                                  ++iter)
+                             {
+                                 try
+                                 {
+                                     dispatcher.enqueue(nullptr, nullptr);
+                                 }
+                                 catch (const logency::runtime_error &e)
+                                 {
+                                     // Ignore it. There is no thread pool.
+                                 }
+                             }
+                         }};
+
+        GIVEN("bounded blocking queue which drops newest message")
+        {
+            logency::dispatcher_option option;
+            option.capacity = capacity;
+            option.overflow = logency::overflow_policy::drop_newest;
+
+            auto dispatcher{std::make_shared<dispatcher_type>(
+                std::shared_ptr<pool_type>{}, option)};
+
+            WHEN("enqueue more messages than its capacity")
+            {
+                enqueue_all(*dispatcher);
+
+                THEN("queue keeps the first messages only")
+                {
+                    CHECK_EQ(dispatcher->queue_size(), capacity);
+                    CHECK_EQ(dispatcher->dropped_count(), messages - capacity);
+                }
+            }
+        }
+
+        GIVEN("bounded blocking queue which drops oldest message")
+        {
+            logency::dispatcher_option option;
+            option.capacity = capacity;
+            option.overflow = logency::overflow_policy::drop_oldest;
+
+            auto dispatcher{std::make_shared<dispatcher_type>(
+                std::shared_ptr<pool_type>{}, option)};
+
+            WHEN("enqueue more messages than its capacity")
+            {
+                enqueue_all(*dispatcher);
+
+                THEN("queue keeps the last messages only")
+                {
+                    CHECK_EQ(dispatcher->queue_size(), capacity);
+                    CHECK_EQ(dispatcher->dropped_count(), messages - capacity);
+                }
+            }
+        }
+
+        GIVEN("lock-free queue which drops oldest message")
+        {
+            logency::dispatcher_option option;
+            option.queue = logency::dispatcher_queue::lock_free;
+            option.overflow = logency::overflow_policy::drop_oldest;
+
+            WHEN("instantiate it")
+            {
+                auto act{[&]
+                         {
+                             std::ignore = std::make_shared<dispatcher_type>(
+                                 std::shared_ptr<pool_type>{}, option);
+                         }};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        act(),
+                        "Overflow policy is not supported by this queue.",
+                        logency::runtime_error);
+                }
+            }
+        }
+    }
+
     SCENARIO("auto dispatcher::queue_capacity() -> size_type")
     {
         GIVEN("instantiated object")
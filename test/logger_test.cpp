@@ -1,5 +1,7 @@
 #include "logency/core/exception.hpp"
+#include "logency/dispatcher.hpp"
 #include "logency/logger.hpp"
+#include "logency/message/log_level.hpp"
 
 #include "global_resource/dispatcher.hpp"
 #include "global_resource/thread_pool.hpp"
@@ -8,15 +10,43 @@
 #include "utils/string.hpp"
 #include "utils/test_message.hpp"
 
+#include <atomic>
 #include <cstddef>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <string_view>
 
 namespace logency::unit_test
 {
 
+namespace
+{
+
+/**
+ * Message with level which counts how many times it has been constructed.
+ */
+struct counted_message
+{
+    using value_type = char;
+    using string_type = std::string;
+    using string_view_type = std::string_view;
+
+    explicit counted_message(log_level level, string_view_type content)
+        : content{content}, level{level}
+    {
+        constructed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    string_type content;
+    log_level level;
+
+    static inline std::atomic<int> constructed{0};
+};
+
+} // namespace
+
 TEST_SUITE("logency::logger")
 {
     using message_type = utils::message<char>;
@@ -310,6 +340,84 @@ TEST_SUITE("logency::logger")
         }
     }
 
+    SCENARIO("bool logger::should_log(log_level) const noexcept")
+    {
+        GIVEN("instantiated object")
+        {
+            auto logger{std::make_shared<logger_type>(
+                "logger", global_resource::dispatcher::normal())};
+
+            WHEN("no level is set")
+            {
+                THEN("every level is logged")
+                {
+                    CHECK_EQ(logger->level(), log_level::trace);
+                    CHECK(logger->should_log(log_level::trace));
+                    CHECK(logger->should_log(log_level::critical));
+                }
+            }
+
+            WHEN("set level")
+            {
+                CHECK_NOTHROW({ logger->set_level(log_level::warning); });
+
+                THEN("level below it is not logged")
+                {
+                    CHECK_EQ(logger->level(), log_level::warning);
+                    CHECK(!logger->should_log(log_level::info));
+                    CHECK(logger->should_log(log_level::warning));
+                    CHECK(logger->should_log(log_level::error));
+                }
+            }
+        }
+    }
+
+    SCENARIO("void logger::set_level(log_level)")
+    {
+        using pool_type = logency::detail::thread::thread_pool;
+        using counted_logger_type = logency::logger<counted_message>;
+        using counted_dispatcher_type = logency::dispatcher<counted_message>;
+
+        GIVEN("logger whose dispatcher has no thread pool")
+        {
+            auto dispatcher{std::make_shared<counted_dispatcher_type>(
+                std::shared_ptr<pool_type>{})};
+            auto logger{
+                std::make_shared<counted_logger_type>("logger", dispatcher)};
+
+            logger->set_level(log_level::warning);
+            counted_message::constructed.store(0, std::memory_order_relaxed);
+
+            WHEN("log message below the level")
+            {
+                CHECK_NOTHROW({
+                    logger->log(log_level::debug, "filtered");
+                    logger->log<log_level::info>("filtered");
+                });
+
+                THEN("message is never constructed")
+                {
+                    CHECK_EQ(counted_message::constructed.load(), 0);
+                    CHECK(dispatcher->is_queue_empty());
+                }
+            }
+
+            WHEN("log message at the level")
+            {
+                auto act{[&]() { logger->log<log_level::warning>("logged"); }};
+
+                THEN("message is constructed and enqueued")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        act(), "Thread pool does not exist any longer.",
+                        logency::runtime_error);
+                    CHECK_EQ(counted_message::constructed.load(), 1);
+                    CHECK_EQ(dispatcher->queue_size(), 1U);
+                }
+            }
+        }
+    }
+
     SCENARIO("void logger::set_filter(filter_type)")
     {
         GIVEN("instantiated object")
@@ -363,6 +471,56 @@ TEST_SUITE("logency::logger")
         }
     }
 
+    SCENARIO("void logger::set_synchronous(bool)")
+    {
+        GIVEN("instantiated object with a sink")
+        {
+            using sink_type = logency::sink<message_type>;
+            using sink_module = utils::mock_sink_module<message_type>;
+
+            auto logger{std::make_shared<logger_type>(
+                "logger", global_resource::dispatcher::normal())};
+
+            auto sink{std::make_shared<sink_type>(
+                "sink", std::make_unique<sink_module>(),
+                global_resource::thread_pool::normal())};
+
+            logger->add_sink(sink);
+
+            const auto &module{
+                dynamic_cast<const sink_module &>(sink->sink_module())};
+
+            WHEN("set it synchronous")
+            {
+                CHECK_EQ(logger->is_synchronous(), false);
+
+                logger->set_synchronous(true);
+
+                THEN("message is written and flushed before log returns")
+                {
+                    CHECK(logger->is_synchronous());
+
+                    CHECK_NOTHROW({ logger->log("message"); });
+
+                    CHECK_EQ(module.log_counter(), 1);
+                    CHECK_EQ(module.flush_counter(), 1);
+                    CHECK_EQ(module.batch_counter(), 0);
+                }
+
+                THEN("filter of the sink is still applied")
+                {
+                    sink->set_filter(
+                        [](string_view_type, const message_type &message)
+                        { return message.content == "qualify"; });
+
+                    CHECK_NOTHROW({ logger->log("disqualify"); });
+
+                    CHECK_EQ(module.log_counter(), 0);
+                }
+            }
+        }
+    }
+
     SCENARIO("void logger::set_error_handler(error_handler_type)")
     {
         GIVEN("instantiated object")
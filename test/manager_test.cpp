@@ -5,11 +5,54 @@
 #include "utils/mock_sink_module.hpp"
 #include "utils/test_message.hpp"
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
 
 namespace logency::unit_test
 {
 
+namespace
+{
+
+/**
+ * Slow module which records the threads writing to it.
+ */
+template <typename MessageType>
+class thread_recording_module : public utils::mock_sink_module<MessageType>
+{
+public:
+    using message_type = MessageType;
+    using string_view_type = typename message_type::string_view_type;
+
+    void log_message(string_view_type logger,
+                     const message_type &message) override
+    {
+        {
+            std::scoped_lock lock{mutex_};
+            threads_.insert(std::this_thread::get_id());
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds{200});
+        utils::mock_sink_module<MessageType>::log_message(logger, message);
+    }
+
+    [[nodiscard]] auto threads() const -> std::set<std::thread::id>
+    {
+        std::scoped_lock lock{mutex_};
+        return threads_;
+    }
+
+private:
+    mutable std::mutex mutex_{};
+    std::set<std::thread::id> threads_{};
+};
+
+} // namespace
+
 TEST_SUITE("logency::manager")
 {
     using message_type = utils::message<char>;
@@ -67,6 +110,107 @@ TEST_SUITE("logency::manager")
         }
     }
 
+    SCENARIO("manager::manager(size_t, dispatcher_option)")
+    {
+        GIVEN("dispatcher option with several shards")
+        {
+            dispatcher_option option{};
+            option.shard_count = 4U;
+
+            std::unique_ptr<manager_type> manager{nullptr};
+
+            WHEN("instantiate it and log with several loggers")
+            {
+                CHECK_NOTHROW(
+                    { manager = std::make_unique<manager_type>(4, option); });
+
+                auto module{std::make_unique<sink_module_type>()};
+                const auto *observer{module.get()};
+                auto sink{manager->new_sink("sink", std::move(module))};
+
+                constexpr const int logger_count{8};
+                constexpr const int message_count{32};
+
+                for (int index{0}; index < logger_count; ++index)
+                {
+                    auto logger{
+                        manager->new_logger(std::to_string(index).c_str())};
+                    logger->add_sink(sink);
+
+                    for (int count{0}; count < message_count; ++count)
+                    {
+                        logger->log(string_type{"message"});
+                    }
+                }
+
+                manager->wait_until_idle();
+
+                THEN("every message is sunk")
+                {
+                    CHECK_EQ(observer->log_counter(),
+                             logger_count * message_count);
+                }
+            }
+        }
+
+        GIVEN("dispatcher option with two shards")
+        {
+            dispatcher_option option{};
+            option.shard_count = 2U;
+
+            auto manager{std::make_unique<manager_type>(1, option)};
+
+            WHEN("instantiate loggers and sinks alternately")
+            {
+                constexpr const int message_count{16};
+
+                for (const auto *name : {"a", "b"})
+                {
+                    auto logger{manager->new_logger(name)};
+                    auto sink{manager->new_sink(
+                        string_type{name} + "_file",
+                        std::make_unique<sink_module_type>())};
+                    logger->add_sink(sink);
+
+                    for (int count{0}; count < message_count; ++count)
+                    {
+                        logger->log(string_type{"message"});
+                    }
+                }
+
+                manager->wait_until_idle();
+
+                THEN("the loggers are on different shards")
+                {
+                    const auto stats{manager->stats()};
+
+                    REQUIRE_EQ(stats.dispatchers.size(), 2U);
+                    CHECK_EQ(stats.dispatchers[0].message_count,
+                             message_count);
+                    CHECK_EQ(stats.dispatchers[1].message_count,
+                             message_count);
+                }
+            }
+        }
+
+        GIVEN("dispatcher option without shard")
+        {
+            dispatcher_option option{};
+            option.shard_count = 0U;
+
+            WHEN("instantiate it")
+            {
+                auto act{[&]() { manager_type manager{1, option}; }};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(act(), "'shard_count' is invalid.",
+                                         logency::runtime_error);
+                }
+            }
+        }
+    }
+
     SCENARIO("manager::~manager")
     {
         GIVEN("instantiated object")
@@ -229,6 +373,22 @@ TEST_SUITE("logency::manager")
                 }
             }
 
+            WHEN("delete exist logger and create it again")
+            {
+                const auto id{logger->id()};
+
+                manager.delete_logger("exist logger");
+                auto renewed{manager.new_logger("exist logger")};
+                auto other{manager.new_logger("other logger")};
+
+                THEN("the name keeps its ID, and the others get new one")
+                {
+                    CHECK_EQ(renewed->id(), id);
+                    CHECK_NE(other->id(), id);
+                    CHECK_EQ(manager.find_logger("exist logger"), renewed);
+                }
+            }
+
             WHEN("delete not exist logger")
             {
                 auto act{[&]() { manager.delete_logger("not exist logger"); }};
@@ -510,6 +670,139 @@ TEST_SUITE("logency::manager")
         }
     }
 
+    SCENARIO("auto manager::new_sink(string_view_type, const sink_option &, "
+             "std::unique_ptr<sink_module_type>) "
+             "-> std::shared_ptr<sink_type>; with dedicated thread")
+    {
+        GIVEN("instantiated manager with a logger")
+        {
+            auto manager{std::make_unique<manager_type>()};
+            auto logger{manager->new_logger("logger")};
+
+            sink_option option{};
+            option.dedicated_thread = true;
+
+            WHEN("instantiate new sink on a dedicated thread")
+            {
+                auto module{std::make_unique<sink_module_type>()};
+                const auto *observer{module.get()};
+
+                auto sink{manager->new_sink("dedicated sink", option,
+                                            std::move(module))};
+                logger->add_sink(sink);
+
+                constexpr const int expect{64};
+                for (int count{0}; count < expect; ++count)
+                {
+                    logger->log(string_type{"message"});
+                }
+
+                manager->wait_until_idle();
+
+                THEN("messages are sunk by the dedicated thread")
+                {
+                    CHECK_EQ(observer->log_counter(), expect);
+                }
+
+                AND_THEN("sink can be deleted")
+                {
+                    logger->delete_sink(sink);
+                    sink.reset();
+
+                    CHECK_NOTHROW({ manager->delete_sink("dedicated sink"); });
+                    CHECK(!manager->find_sink("dedicated sink"));
+                }
+
+                AND_THEN("sink keeps working after it is deleted while a "
+                         "logger still writes to it")
+                {
+                    CHECK_NOTHROW({ manager->delete_sink("dedicated sink"); });
+
+                    CHECK_NOTHROW({
+                        for (int count{0}; count < expect; ++count)
+                        {
+                            logger->log(string_type{"message"});
+                        }
+                    });
+
+                    manager->wait_until_idle();
+
+                    CHECK_EQ(observer->log_counter(), expect * 2);
+                }
+
+                AND_THEN("sink can be released while its thread is running")
+                {
+                    for (int count{0}; count < expect; ++count)
+                    {
+                        logger->log(string_type{"message"});
+                    }
+
+                    // The queued run might hold the last reference.
+                    CHECK_NOTHROW({
+                        logger->delete_sink(sink);
+                        sink.reset();
+                        manager->delete_sink("dedicated sink");
+                        manager->wait_until_idle();
+                    });
+                }
+            }
+
+            WHEN("instantiate new bounded sink which blocks on a dedicated "
+                 "thread")
+            {
+                option.capacity = 1U;
+                option.overflow = logency::overflow_policy::block;
+
+                auto module{
+                    std::make_unique<thread_recording_module<message_type>>()};
+                const auto *observer{module.get()};
+
+                auto sink{manager->new_sink("dedicated sink", option,
+                                            std::move(module))};
+                logger->add_sink(sink);
+
+                constexpr const int expect{256};
+                for (int count{0}; count < expect; ++count)
+                {
+                    logger->log(string_type{"message"});
+                }
+
+                manager->wait_until_idle();
+
+                THEN("messages are only written by the dedicated thread")
+                {
+                    CHECK_EQ(observer->log_counter(), expect);
+
+                    const auto threads{observer->threads()};
+                    CHECK_EQ(threads.size(), 1U);
+                    CHECK_EQ(threads.count(std::this_thread::get_id()), 0U);
+                }
+            }
+
+            WHEN("instantiate new sink with invalid CPU affinity")
+            {
+                option.thread.cpu_affinity = {-1};
+
+                auto act{[&]()
+                         {
+                             std::ignore = manager->new_sink(
+                                 "dedicated sink", option,
+                                 std::make_unique<sink_module_type>());
+                         }};
+
+                THEN("throw logency::system_error")
+                {
+                    CHECK_THROWS_AS(act(), logency::system_error);
+
+                    AND_THEN("sink is not registered in manager")
+                    {
+                        CHECK(!manager->find_sink("dedicated sink"));
+                    }
+                }
+            }
+        }
+    }
+
     SCENARIO("auto manager::find_sink(string_view_type) "
              "-> std::shared_ptr<logger_type>")
     {
@@ -576,6 +869,107 @@ TEST_SUITE("logency::manager")
         }
     }
 
+    SCENARIO("auto manager::stats() -> manager_stats<string_type>")
+    {
+        GIVEN("manager with a logger connected to a sink")
+        {
+            manager_type manager;
+
+            auto logger{manager.new_logger("logger")};
+            auto sink{manager.new_sink<sink_module_type>("sink")};
+            logger->add_sink(sink);
+
+            logger->set_filter(
+                [](string_view_type /*logger*/, const message_type &message)
+                { return message.content != "filtered"; });
+
+            WHEN("log the messages and wait until they are written")
+            {
+                for (int count{0}; count < 5; ++count)
+                {
+                    logger->log("logged");
+                }
+                logger->log("filtered");
+
+                manager.wait_until_idle();
+
+                const auto stats{manager.stats()};
+
+                THEN("the logger counts the logged and the filtered ones")
+                {
+                    REQUIRE_EQ(stats.loggers.size(), 1U);
+                    CHECK_EQ(stats.loggers.front().first, "logger");
+                    CHECK_EQ(stats.loggers.front().second.logged, 5U);
+                    CHECK_EQ(stats.loggers.front().second.filtered, 1U);
+                }
+
+                AND_THEN("the sink counts the written ones")
+                {
+                    REQUIRE_EQ(stats.sinks.size(), 1U);
+                    CHECK_EQ(stats.sinks.front().first, "sink");
+
+                    const auto &sink_stats{stats.sinks.front().second};
+                    CHECK_EQ(sink_stats.enqueued, 5U);
+                    CHECK_EQ(sink_stats.written, 5U);
+                    CHECK_EQ(sink_stats.dropped, 0U);
+                    CHECK_EQ(sink_stats.error_count, 0U);
+                    CHECK_GE(sink_stats.queue_high_water, 1U);
+                }
+
+                AND_THEN("the dispatcher and the thread pool count their "
+                         "work")
+                {
+                    REQUIRE_EQ(stats.dispatchers.size(), 1U);
+                    CHECK_EQ(stats.dispatchers.front().message_count, 5U);
+                    CHECK_GE(stats.dispatchers.front().batch_count, 1U);
+                    CHECK_GE(stats.dispatchers.front().max_batch_size, 1U);
+
+                    CHECK_GE(stats.thread_pool.executed, 2U);
+                    CHECK_EQ(stats.thread_pool.queued, 0U);
+                }
+            }
+        }
+    }
+
+#if defined(LOGENCY_LATENCY)
+    SCENARIO("auto manager::latency() "
+             "-> std::vector<std::pair<string_type, sink_latency_stats>>")
+    {
+        GIVEN("manager with a logger connected to a sink")
+        {
+            manager_type manager;
+
+            auto logger{manager.new_logger("logger")};
+            logger->add_sink(manager.new_sink<sink_module_type>("sink"));
+
+            WHEN("log the messages and wait until they are written")
+            {
+                for (int count{0}; count < 5; ++count)
+                {
+                    logger->log("logged");
+                }
+
+                manager.wait_until_idle();
+
+                const auto latency{manager.latency()};
+
+                THEN("every stage is recorded for each message")
+                {
+                    REQUIRE_EQ(latency.size(), 1U);
+                    CHECK_EQ(latency.front().first, "sink");
+
+                    const auto &stages{latency.front().second};
+                    CHECK_EQ(stages.dispatcher_queue.count, 5U);
+                    CHECK_EQ(stages.sink_queue.count, 5U);
+                    CHECK_EQ(stages.write.count, 5U);
+                    CHECK_EQ(stages.end_to_end.count, 5U);
+                    CHECK_GE(stages.end_to_end.max, stages.write.max);
+                }
+            }
+        }
+    }
+#endif
+
     SCENARIO("void manager::set_error_handler(error_handler_type)")
     {
         GIVEN("instantiated manager")
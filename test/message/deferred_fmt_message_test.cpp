@@ -0,0 +1,245 @@
+#include "logency/message/deferred_fmt_message.hpp"
+
+#include "logency/message/log_level.hpp"
+#include "logency/message/time.hpp"
+
+#include "include_doctest.hpp"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace logency::unit_test::message
+{
+
+TEST_SUITE("logency::message::deferred_fmt_message")
+{
+    using message_type = logency::message::deferred_fmt_message;
+    using stringifier_type = logency::message::deferred_fmt_stringifier;
+    using string_type = message_type::string_type;
+    using string_view_type = message_type::string_view_type;
+
+    // Three strings do not fit in the inline buffer.
+    static_assert(sizeof(std::tuple<string_type, string_type, string_type>) >
+                  message_type::inline_size);
+    static_assert(sizeof(std::tuple<int, double>) <=
+                  message_type::inline_size);
+
+    SCENARIO("template <typename... Args> "
+             "deferred_fmt_message::deferred_fmt_message(log_level, "
+             "fmt::format_string<Args...>, Args &&...)")
+    {
+        GIVEN("arguments which fit in the inline buffer")
+        {
+            const message_type message{log_level::info, "{} and {:.1f}", 42,
+                                       0.5};
+
+            THEN("content is formatted from them")
+            {
+                CHECK_EQ(message.content(), "42 and 0.5");
+            }
+        }
+
+        GIVEN("arguments which are stored on the heap")
+        {
+            const message_type message{log_level::info, "{}-{}-{}",
+                                       string_type(32U, 'a'),
+                                       string_type(32U, 'b'),
+                                       string_type(32U, 'c')};
+
+            THEN("content is formatted from them")
+            {
+                CHECK_EQ(message.content(), string_type(32U, 'a') + "-" +
+                                                string_type(32U, 'b') + "-" +
+                                                string_type(32U, 'c'));
+            }
+        }
+
+        GIVEN("string arguments released before the content is formatted")
+        {
+            auto text{std::make_unique<char[]>(8U)};
+            std::char_traits<char>::copy(text.get(), "pointer", 8U);
+            auto owned{std::make_unique<string_type>(64U, 's')};
+
+            const message_type message{log_level::info, "{} {}",
+                                       static_cast<const char *>(text.get()),
+                                       *owned};
+
+            std::char_traits<char>::copy(text.get(), "changed", 8U);
+            text.reset();
+            owned.reset();
+
+            THEN("content keeps the copies of the strings")
+            {
+                CHECK_EQ(message.content(),
+                         "pointer " + string_type(64U, 's'));
+            }
+        }
+
+        GIVEN("content only")
+        {
+            const message_type message{log_level::info,
+                                       string_view_type{"{not a format}"}};
+
+            THEN("content is kept as it is")
+            {
+                CHECK_EQ(message.content(), "{not a format}");
+            }
+        }
+    }
+
+    SCENARIO("deferred_fmt_message::deferred_fmt_message("
+             "const deferred_fmt_message &)")
+    {
+        GIVEN("messages with inline and heap arguments")
+        {
+            const message_type small{log_level::warning, "{}", 7};
+            const message_type large{log_level::error, "{}{}{}",
+                                     string_type(32U, 'x'),
+                                     string_type(32U, 'y'), string_type{"z"}};
+
+            WHEN("copy them")
+            {
+                const message_type small_copy{small};
+                const message_type large_copy{large};
+
+                THEN("copies and sources format the same content")
+                {
+                    CHECK_EQ(small_copy.content(), "7");
+                    CHECK_EQ(small.content(), "7");
+                    CHECK_EQ(large_copy.content(), large.content());
+                    CHECK_EQ(large_copy.level, log_level::error);
+                    CHECK_EQ(large_copy.time, large.time);
+                }
+            }
+
+            WHEN("copy assign them to each other")
+            {
+                message_type target{small};
+                target = large;
+
+                message_type other{large};
+                other = small;
+
+                THEN("targets format the content of their sources")
+                {
+                    CHECK_EQ(target.content(), large.content());
+                    CHECK_EQ(target.level, log_level::error);
+                    CHECK_EQ(other.content(), "7");
+                    CHECK_EQ(other.level, log_level::warning);
+                }
+            }
+
+            WHEN("copy assign one to itself")
+            {
+                message_type target{large};
+                const auto &self{target};
+                target = self;
+
+                THEN("content is kept")
+                {
+                    CHECK_EQ(target.content(), large.content());
+                }
+            }
+        }
+    }
+
+    SCENARIO("deferred_fmt_message::deferred_fmt_message("
+             "deferred_fmt_message &&)")
+    {
+        GIVEN("messages with inline and heap arguments")
+        {
+            const string_type long_text(80U, 'l');
+
+            message_type small{log_level::info, "{} {}", 1, string_type{"s"}};
+            message_type large{log_level::info, "{}{}", long_text, long_text};
+
+            WHEN("move construct from them")
+            {
+                const message_type small_moved{std::move(small)};
+                const message_type large_moved{std::move(large)};
+
+                THEN("new messages format the content")
+                {
+                    CHECK_EQ(small_moved.content(), "1 s");
+                    CHECK_EQ(large_moved.content(), long_text + long_text);
+                }
+
+                AND_THEN("moved-from messages are empty and reusable")
+                {
+                    // NOLINTNEXTLINE(bugprone-use-after-move)
+                    CHECK_EQ(small.content(), "");
+                    // NOLINTNEXTLINE(bugprone-use-after-move)
+                    CHECK_EQ(large.content(), "");
+
+                    small = message_type{log_level::info, "{}", 2};
+                    large = small_moved;
+
+                    CHECK_EQ(small.content(), "2");
+                    CHECK_EQ(large.content(), "1 s");
+                }
+            }
+
+            WHEN("move assign them to each other")
+            {
+                message_type target{log_level::debug, "{}", 3};
+                target = std::move(large);
+
+                message_type other{log_level::debug, string_type{long_text}};
+                other = std::move(small);
+
+                THEN("targets format the content of their sources")
+                {
+                    CHECK_EQ(target.content(), long_text + long_text);
+                    CHECK_EQ(target.level, log_level::info);
+                    CHECK_EQ(other.content(), "1 s");
+                }
+
+                AND_THEN("moved-from messages are empty and reusable")
+                {
+                    // NOLINTNEXTLINE(bugprone-use-after-move)
+                    CHECK_EQ(large.content(), "");
+                    // NOLINTNEXTLINE(bugprone-use-after-move)
+                    CHECK_EQ(small.content(), "");
+
+                    large = std::move(target);
+
+                    CHECK_EQ(large.content(), long_text + long_text);
+                }
+            }
+        }
+    }
+
+    SCENARIO("void deferred_fmt_stringifier::format_to(buffer_type &, "
+             "string_view_type, const message_type &)")
+    {
+        GIVEN("a message with arguments")
+        {
+            const message_type message{log_level::warning, "value: {}", 5};
+
+            WHEN("format it into a buffer with content")
+            {
+                stringifier_type::buffer_type buffer;
+                fmt::format_to(std::back_inserter(buffer), "> ");
+
+                stringifier_type::format_to(buffer, "logger", message);
+
+                THEN("the line is appended to the buffer")
+                {
+                    const string_type time{
+                        logency::message::timestamp_cache<char>::local().format(
+                            message.time)};
+
+                    CHECK_EQ(fmt::to_string(buffer),
+                             "> [" + time + "] [ warning] [logger] value: 5\n");
+                    CHECK_EQ(stringifier_type::format("logger", message),
+                             "[" + time + "] [ warning] [logger] value: 5\n");
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::message
@@ -0,0 +1,109 @@
+#include "logency/message/time.hpp"
+
+#include "include_doctest.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+namespace logency::unit_test::message
+{
+
+namespace
+{
+
+auto expected_timestamp(const std::chrono::system_clock::time_point &time_point)
+    -> std::string
+{
+    const auto tm_value{logency::message::get_tm(time_point)};
+
+    std::stringstream stream{};
+
+    stream << std::put_time(&tm_value, "%F %T") << "." << std::setfill('0')
+           << std::setw(3) << logency::message::get_ms(time_point);
+
+    return stream.str();
+}
+
+} // namespace
+
+TEST_SUITE("logency::message::timestamp_cache")
+{
+    using cache_type = logency::message::timestamp_cache<char>;
+    using clock_type = cache_type::clock_type;
+
+    SCENARIO("auto timestamp_cache::format(const clock_type::time_point &) "
+             "-> string_view_type")
+    {
+        GIVEN("a cache which formatted a time point")
+        {
+            cache_type cache{};
+
+            const auto first{clock_type::time_point{std::chrono::seconds{
+                                 1700000000}} +
+                             std::chrono::milliseconds{5}};
+            std::ignore = cache.format(first);
+
+            WHEN("format a time point in the same second")
+            {
+                const auto second{first + std::chrono::milliseconds{990}};
+                const std::string result{cache.format(second)};
+
+                THEN("only the milliseconds are changed")
+                {
+                    CHECK_EQ(result, expected_timestamp(second));
+                }
+            }
+
+            WHEN("format a time point in the next second")
+            {
+                const auto second{first + std::chrono::milliseconds{1000}};
+                const std::string result{cache.format(second)};
+
+                THEN("the date and time part is rebuilt")
+                {
+                    CHECK_EQ(result, expected_timestamp(second));
+                }
+            }
+
+            WHEN("format a time point a day earlier")
+            {
+                const auto second{first - std::chrono::hours{24}};
+                const std::string result{cache.format(second)};
+
+                THEN("the date and time part is rebuilt")
+                {
+                    CHECK_EQ(result, expected_timestamp(second));
+                }
+            }
+        }
+    }
+
+    SCENARIO("timestamp_cache<CharT, time_zone::utc>")
+    {
+        GIVEN("a cache in UTC")
+        {
+            logency::message::timestamp_cache<
+                char, logency::message::time_zone::utc>
+                cache{};
+
+            WHEN("format a time point")
+            {
+                const auto time_point{clock_type::time_point{
+                                          std::chrono::seconds{1700000000}} +
+                                      std::chrono::milliseconds{5}};
+                const std::string result{cache.format(time_point)};
+
+                THEN("it is written in UTC regardless of the local time zone")
+                {
+                    CHECK_EQ(result, "2023-11-14 22:13:20.005");
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::message
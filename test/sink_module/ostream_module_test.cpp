@@ -47,6 +47,10 @@ TEST_SUITE("logency::sink_module::ostream_module")
         logency::sink_module::ostream_module<utils::message<value_type>,
                                              utils::formatter<value_type>>;
 
+    template <typename value_type>
+    using buffer_module_type = logency::sink_module::ostream_module<
+        utils::message<value_type>, utils::buffer_formatter<value_type>>;
+
     SCENARIO_TEMPLATE(
         "ostream_module<MessageType, Formatter>::"
         "ostream_module(ostream_type *stream, formatter_type &&formatter)",
@@ -156,6 +160,74 @@ TEST_SUITE("logency::sink_module::ostream_module")
                 }
             }
         }
+
+        GIVEN("instantiated sink module with buffered formatter")
+        {
+            std::basic_stringstream<T> stream;
+            auto sink_module{std::make_unique<buffer_module_type<T>>(
+                &stream, std::make_unique<utils::buffer_formatter<T>>())};
+
+            WHEN("write the content into the sink module twice")
+            {
+                CHECK_NOTHROW({
+                    sink_module->log_message(
+                        utils::not_used<T>(),
+                        utils::message<T>{content::pangram<T>()});
+                    sink_module->log_message(
+                        utils::not_used<T>(),
+                        utils::message<T>{content::pangram<T>()});
+                });
+
+                THEN("each content is written once")
+                {
+                    CHECK_EQ(stream.str(),
+                             content::pangram<T>() + content::pangram<T>());
+                }
+            }
+        }
+    }
+
+    SCENARIO_TEMPLATE("void ostream_module<MessageType, Formatter>::"
+                      "log_messages(const message_pack_type *first, "
+                      "const message_pack_type *last)",
+                      T, char, wchar_t)
+    {
+        GIVEN("instantiated sink module and a batch of message packs")
+        {
+            std::basic_stringstream<T> stream;
+            auto sink_module{std::make_unique<module_type<T>>(
+                &stream, std::make_unique<utils::formatter<T>>())};
+
+            std::vector<logency::message_pack<utils::message<T>>> packs;
+
+            for (int index{0}; index < 3; ++index)
+            {
+                packs.push_back(logency::make_message_pack<utils::message<T>>(
+                    0U, std::basic_string_view<T>{},
+                    utils::message<T>{content::pangram<T>()}));
+            }
+
+            WHEN("write the batch into the sink module")
+            {
+                CHECK_NOTHROW({
+                    sink_module->log_messages(packs.data(),
+                                              packs.data() + packs.size());
+                });
+
+                THEN("contents are written in the same order")
+                {
+                    CHECK_EQ(stream.str(), content::pangram<T>() +
+                                               content::pangram<T>() +
+                                               content::pangram<T>());
+                }
+
+                AND_THEN("the written bytes are counted")
+                {
+                    CHECK_EQ(sink_module->written_bytes(),
+                             stream.str().size() * sizeof(T));
+                }
+            }
+        }
     }
 }
 
@@ -1072,6 +1072,237 @@ TEST_SUITE("logency::sink_module::rotation_file_module")
             }
         }
     }
+
+    SCENARIO_TEMPLATE("rotation_file_module<MessageType, Formatter> with "
+                      "naming_mode::sequence",
+                      T, char, wchar_t)
+    {
+        constexpr const rotate_info sequence_info{
+            constant::rotate_info.file_size, constant::rotate_info.file_count,
+            logency::sink_module::rotation_file::naming_mode::sequence};
+
+        constexpr const auto message_size{sequence_info.file_size / 2 + 1};
+
+        GIVEN("no existed file")
+        {
+            std::string name{
+                unique_file_name("rotation_file_module-sequence-new")};
+
+            auto sink_module{std::make_unique<module_type<T>>(
+                name, sequence_info, construct_mode::append_previous,
+                std::make_unique<utils::formatter<T>>())};
+
+            WHEN("log messages which rotate the file every time")
+            {
+                const auto message{content::content<T>(message_size)};
+
+                for (int count{0}; count <= sequence_info.file_count; ++count)
+                {
+                    CHECK_NOTHROW({
+                        sink_module->log_message(
+                            utils::not_used<T>(),
+                            utils::message<T>{std::basic_string<T>{message}});
+                    });
+                }
+
+                THEN("each file is named by the next index")
+                {
+                    sink_module.reset();
+
+                    CHECK(!filesystem::exists(name));
+
+                    for (int index{2}; index <= sequence_info.file_count + 1;
+                         ++index)
+                    {
+                        const auto file_name{file::archive_name(name, index)};
+                        CHECK(filesystem::exists(file_name));
+                        CHECK_EQ(utils::file::get_content<T, char>(file_name),
+                                 message);
+                    }
+
+                    AND_THEN("the oldest file is deleted")
+                    {
+                        CHECK(!filesystem::exists(file::archive_name(name, 1)));
+                    }
+                }
+            }
+        }
+
+        GIVEN("existed file with index")
+        {
+            std::string name{
+                unique_file_name("rotation_file_module-sequence-exist")};
+
+            const auto current_log{content::content<T>()};
+            utils::file::set_content(file::archive_name(name, 5), current_log);
+
+            WHEN("instantiate sink module with construct_mode::append_previous")
+            {
+                auto sink_module{std::make_unique<module_type<T>>(
+                    name, sequence_info, construct_mode::append_previous,
+                    std::make_unique<utils::formatter<T>>())};
+
+                const auto message{content::content<T>()};
+                sink_module->log_message(
+                    utils::not_used<T>(),
+                    utils::message<T>{std::basic_string<T>{message}});
+
+                THEN("content is appended to the file with the last index")
+                {
+                    sink_module.reset();
+
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 file::archive_name(name, 5)),
+                             std::basic_string<T>{current_log}.append(message));
+                    CHECK(!filesystem::exists(file::archive_name(name, 6)));
+                }
+            }
+
+            WHEN("instantiate sink module with construct_mode::create_new_file")
+            {
+                auto sink_module{std::make_unique<module_type<T>>(
+                    name, sequence_info, construct_mode::create_new_file,
+                    std::make_unique<utils::formatter<T>>())};
+
+                const auto message{content::content<T>()};
+                sink_module->log_message(
+                    utils::not_used<T>(),
+                    utils::message<T>{std::basic_string<T>{message}});
+
+                THEN("content is recorded into the file with the next index")
+                {
+                    sink_module.reset();
+
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 file::archive_name(name, 5)),
+                             current_log);
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 file::archive_name(name, 6)),
+                             message);
+                }
+            }
+        }
+
+        GIVEN("background compressor")
+        {
+            using compressor_type = typename module_type<T>::compressor_type;
+
+            std::string name{
+                unique_file_name("rotation_file_module-sequence-compress")};
+
+            auto compressor{std::make_shared<compressor_type>()};
+
+            WHEN("set it to the sink module with naming_mode::cascade")
+            {
+                module_type<T> sink_module{
+                    name, constant::rotate_info,
+                    construct_mode::create_new_file,
+                    std::make_unique<utils::formatter<T>>()};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(sink_module.set_compressor(compressor),
+                                         "compression needs "
+                                         "naming_mode::sequence.",
+                                         logency::runtime_error);
+                }
+            }
+
+            WHEN("log messages which rotate the file every time")
+            {
+                auto sink_module{std::make_unique<module_type<T>>(
+                    name, sequence_info, construct_mode::create_new_file,
+                    std::make_unique<utils::formatter<T>>())};
+                sink_module->set_compressor(compressor);
+
+                const auto message{content::content<T>(message_size)};
+
+                for (int count{0}; count <= sequence_info.file_count; ++count)
+                {
+                    sink_module->log_message(
+                        utils::not_used<T>(),
+                        utils::message<T>{std::basic_string<T>{message}});
+                }
+
+                sink_module.reset();
+                compressor->wait_until_idle();
+
+                const std::string extension{compressor_type::extension};
+
+                THEN("each closed file is compressed if it is available")
+                {
+                    for (int index{2}; index <= sequence_info.file_count;
+                         ++index)
+                    {
+                        const auto file_name{file::archive_name(name, index)};
+
+                        CHECK_EQ(filesystem::exists(file_name),
+                                 !compressor_type::is_available);
+
+                        if constexpr (compressor_type::is_available)
+                        {
+                            CHECK(filesystem::exists(file_name + extension));
+                        }
+                    }
+
+                    AND_THEN("the current file is not compressed")
+                    {
+                        const auto file_name{file::archive_name(
+                            name, sequence_info.file_count + 1)};
+
+                        CHECK_EQ(utils::file::get_content<T, char>(file_name),
+                                 message);
+                    }
+                }
+            }
+
+            WHEN("log messages which rotate faster than the files are "
+                 "compressed")
+            {
+                constexpr const int rotation_count{64};
+
+                auto sink_module{std::make_unique<module_type<T>>(
+                    name, sequence_info, construct_mode::create_new_file,
+                    std::make_unique<utils::formatter<T>>())};
+                sink_module->set_compressor(compressor);
+
+                const auto message{content::content<T>(message_size)};
+
+                for (int count{0}; count < rotation_count; ++count)
+                {
+                    sink_module->log_message(
+                        utils::not_used<T>(),
+                        utils::message<T>{std::basic_string<T>{message}});
+                }
+
+                sink_module.reset();
+                compressor->wait_until_idle();
+
+                const std::string extension{compressor_type::extension};
+
+                THEN("no more than rotate_info::file_count files are left")
+                {
+                    int left{0};
+
+                    for (int index{1}; index <= rotation_count; ++index)
+                    {
+                        const auto file_name{file::archive_name(name, index)};
+
+                        left += filesystem::exists(file_name) ? 1 : 0;
+
+                        if constexpr (compressor_type::is_available)
+                        {
+                            left +=
+                                filesystem::exists(file_name + extension) ? 1
+                                                                          : 0;
+                        }
+                    }
+
+                    CHECK_LE(left, sequence_info.file_count);
+                }
+            }
+        }
+    }
 }
 
 } // namespace logency::unit_test::sink_module
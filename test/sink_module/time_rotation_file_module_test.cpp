@@ -0,0 +1,278 @@
+#include "logency/sink_module/time_rotation_file_module.hpp"
+
+#include "logency/detail/message_pack.hpp"
+
+#include "file_directory.hpp"
+#include "include_doctest.hpp"
+#include "utils/check_exception.hpp"
+#include "utils/file.hpp"
+#include "utils/test_message.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace logency::unit_test::sink_module
+{
+
+namespace
+{
+
+/**
+ * Clock which stays at the time set by the test.
+ */
+struct fake_clock
+{
+    using duration = std::chrono::system_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::system_clock::time_point;
+
+    static constexpr const bool is_steady{false};
+
+    static auto now() noexcept -> time_point { return current; }
+
+    static inline time_point current{};
+};
+
+auto local_time(int hour, int minute) -> fake_clock::time_point
+{
+    constexpr const int year_base{1900};
+
+    std::tm tm_value{};
+    tm_value.tm_year = 2024 - year_base;
+    tm_value.tm_mon = 0;
+    tm_value.tm_mday = 31;
+    tm_value.tm_hour = hour;
+    tm_value.tm_min = minute;
+    tm_value.tm_isdst = -1;
+
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm_value));
+}
+
+auto segment_name(std::string_view filename, std::string_view stamp,
+                  int index = 0) -> std::string
+{
+    using path_type = std::filesystem::path;
+
+    const path_type path_name{filename};
+
+    auto name{path_type{path_name}
+                  .replace_filename(path_name.stem())
+                  .concat(std::string_view{"-"})
+                  .concat(stamp)};
+
+    if (index > 0)
+    {
+        name.concat(std::string_view{"-"}).concat(std::to_string(index));
+    }
+
+    return name.concat(path_name.extension().native()).string();
+}
+
+template <typename value_type>
+auto content(std::size_t size = 1) -> std::basic_string<value_type>
+{
+    return std::basic_string<value_type>(size, value_type{'0'});
+}
+
+} // namespace
+
+TEST_SUITE("logency::sink_module::time_rotation_file_module")
+{
+    namespace filesystem = std::filesystem;
+
+    template <typename value_type>
+    using module_type = logency::sink_module::time_rotation_file_module<
+        utils::message<value_type>, utils::formatter<value_type>,
+        logency::detail::file::basic_file<value_type>, fake_clock>;
+
+    using rotate_info = logency::sink_module::time_rotation_file::rotate_info;
+    using construct_mode = logency::sink_module::rotation_file::construct_mode;
+
+    SCENARIO_TEMPLATE("template <typename CharT> "
+                      "time_rotation_file_module<MessageType, Formatter>::"
+                      "time_rotation_file_module("
+                      "const std::basic_string<CharT> &name, "
+                      "rotate_info rotate_info, construct_mode mode, "
+                      "std::unique_ptr<formatter_type> formatter)",
+                      T, char, wchar_t)
+    {
+        GIVEN("not existed file")
+        {
+            fake_clock::current = local_time(13, 30);
+
+            std::string name{unique_file_name("time_rotation_file_module")};
+
+            WHEN("instantiate sink module")
+            {
+                std::unique_ptr<module_type<T>> sink_module;
+
+                CHECK_NOTHROW({
+                    sink_module = std::make_unique<module_type<T>>(
+                        name, rotate_info{std::chrono::hours{1}, 2, 0U},
+                        construct_mode::append_previous,
+                        std::make_unique<utils::formatter<T>>());
+                });
+
+                THEN("file is named by the start of the period")
+                {
+                    CHECK(filesystem::exists(
+                        segment_name(name, "2024-01-31_13-00-00")));
+                    CHECK(!filesystem::exists(name));
+                }
+            }
+        }
+
+        GIVEN("incorrect rotate_info::file_count")
+        {
+            std::string name{unique_file_name("time_rotation_file_module")};
+
+            WHEN("instantiate sink module")
+            {
+                auto act{[&]()
+                         {
+                             std::ignore = std::make_unique<module_type<T>>(
+                                 name,
+                                 rotate_info{std::chrono::hours{1}, 0, 0U},
+                                 construct_mode::append_previous,
+                                 std::make_unique<utils::formatter<T>>());
+                         }};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        act(), "file count should be positive integer.",
+                        logency::runtime_error);
+                }
+            }
+        }
+    }
+
+    SCENARIO_TEMPLATE("void time_rotation_file_module<MessageType, Formatter>::"
+                      "log_message(std::string_view logger, "
+                      "const message_type &message)",
+                      T, char, wchar_t)
+    {
+        GIVEN("sink module rotated hourly and keeps 2 files")
+        {
+            fake_clock::current = local_time(13, 30);
+
+            std::string name{
+                unique_file_name("time_rotation_file_module-log_message")};
+
+            auto sink_module{std::make_unique<module_type<T>>(
+                name, rotate_info{std::chrono::hours{1}, 2, 4U},
+                construct_mode::append_previous,
+                std::make_unique<utils::formatter<T>>())};
+
+            auto log{[&](std::size_t size)
+                     {
+                         sink_module->log_message(
+                             utils::not_used<T>(),
+                             utils::message<T>{content<T>(size)});
+                     }};
+
+            WHEN("log messages across the boundaries")
+            {
+                log(1U);
+
+                fake_clock::current = local_time(14, 0);
+                log(2U);
+
+                fake_clock::current = local_time(15, 10);
+                log(3U);
+
+                THEN("each period has its own file")
+                {
+                    sink_module.reset();
+
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 segment_name(name, "2024-01-31_14-00-00")),
+                             content<T>(2U));
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 segment_name(name, "2024-01-31_15-00-00")),
+                             content<T>(3U));
+
+                    AND_THEN("the oldest file is deleted")
+                    {
+                        CHECK(!filesystem::exists(
+                            segment_name(name, "2024-01-31_13-00-00")));
+                    }
+                }
+            }
+
+            WHEN("log messages which exceed the size in a period")
+            {
+                log(3U);
+                log(3U);
+
+                THEN("next file of the period is created with index")
+                {
+                    sink_module.reset();
+
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 segment_name(name, "2024-01-31_13-00-00")),
+                             content<T>(3U));
+                    CHECK_EQ(utils::file::get_content<T, char>(
+                                 segment_name(name, "2024-01-31_13-00-00", 1)),
+                             content<T>(3U));
+                }
+            }
+        }
+    }
+
+    SCENARIO_TEMPLATE("void time_rotation_file_module<MessageType, Formatter>::"
+                      "log_messages(const message_pack_type *first, "
+                      "const message_pack_type *last)",
+                      T, char, wchar_t)
+    {
+        GIVEN("new sink module limited by size and a batch of message packs")
+        {
+            fake_clock::current = local_time(13, 30);
+
+            std::string name{
+                unique_file_name("time_rotation_file_module-log_messages")};
+
+            auto sink_module{std::make_unique<module_type<T>>(
+                name, rotate_info{std::chrono::hours{1}, 4, 4U},
+                construct_mode::create_new_file,
+                std::make_unique<utils::formatter<T>>())};
+
+            std::vector<logency::message_pack<utils::message<T>>> packs;
+
+            for (int index{0}; index < 3; ++index)
+            {
+                packs.push_back(logency::make_message_pack<utils::message<T>>(
+                    0U, std::basic_string_view<T>{},
+                    utils::message<T>{content<T>(3U)}));
+            }
+
+            WHEN("write the batch into the sink module")
+            {
+                sink_module->log_messages(packs.data(),
+                                          packs.data() + packs.size());
+
+                THEN("the size limit applies within the batch")
+                {
+                    sink_module.reset();
+
+                    for (int index{0}; index < 3; ++index)
+                    {
+                        CHECK_EQ(utils::file::get_content<T, char>(
+                                     segment_name(name, "2024-01-31_13-00-00",
+                                                  index)),
+                                 content<T>(3U));
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace logency::unit_test::sink_module
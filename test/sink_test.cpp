@@ -10,7 +10,12 @@
 #include "utils/string.hpp"
 #include "utils/test_message.hpp"
 
+#include <cstdint>
+
+#include <exception>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 namespace logency::unit_test
 {
@@ -18,6 +23,28 @@ namespace logency::unit_test
 namespace
 {
 
+/**
+ * Module which fails to write the message "bad".
+ */
+template <typename MessageType>
+class failing_module : public utils::mock_sink_module<MessageType>
+{
+public:
+    using message_type = MessageType;
+    using string_view_type = typename message_type::string_view_type;
+
+    void log_message(string_view_type logger,
+                     const message_type &message) override
+    {
+        if (message.content == "bad")
+        {
+            throw logency::runtime_error("Failed to write.");
+        }
+
+        utils::mock_sink_module<MessageType>::log_message(logger, message);
+    }
+};
+
 auto ordinary_sink() -> std::shared_ptr<logency::sink<utils::message<char>>>;
 
 auto queue_only_sink(std::size_t &size)
@@ -173,6 +200,106 @@ TEST_SUITE("logency::sink")
         }
     }
 
+    SCENARIO("sink::sink(string_view_type, std::unique_ptr<sink_module_type>,"
+             "const sink_option &, std::weak_ptr<thread_pool_type>)")
+    {
+        using pool_type = logency::detail::thread::thread_pool;
+
+        constexpr const std::size_t capacity{2U};
+        constexpr const int messages{5};
+
+        std::vector<message_pack_type> tray;
+
+        for (int iter{0}; iter < messages; ++iter)
+        {
+            tray.push_back(make_message_pack<message_type>(
+                0U, "not used", message_type{"not used"}));
+        }
+
+        auto log_all{[&tray](sink_type &sink)
+                     {
+                         try
+                         {
+                             sink.log(tray.begin(), tray.end());
+                         }
+                         catch (const logency::runtime_error &e)
+                         {
+                             // Ignore it. There is no thread pool.
+                         }
+                     }};
+
+        GIVEN("bounded sink which drops newest message without thread pool")
+        {
+            logency::sink_option option;
+            option.capacity = capacity;
+            option.overflow = logency::overflow_policy::drop_newest;
+
+            auto sink{std::make_shared<sink_type>(
+                "not used", std::make_unique<sink_module>(), option,
+                std::shared_ptr<pool_type>{})};
+
+            WHEN("log more messages than its capacity")
+            {
+                log_all(*sink);
+
+                THEN("queue keeps the first messages only")
+                {
+                    CHECK_EQ(sink->queue_size(), capacity);
+                    CHECK_EQ(sink->dropped_count(), messages - capacity);
+                }
+            }
+        }
+
+        GIVEN("bounded sink which blocks without thread pool")
+        {
+            logency::sink_option option;
+            option.capacity = capacity;
+
+            auto sink{std::make_shared<sink_type>(
+                "not used", std::make_unique<sink_module>(), option,
+                std::shared_ptr<pool_type>{})};
+
+            WHEN("log more messages than its capacity")
+            {
+                log_all(*sink);
+
+                THEN("full queue is sunk by the producer instead of waiting")
+                {
+                    CHECK_EQ(
+                        dynamic_cast<const sink_module &>(sink->sink_module())
+                            .log_counter(),
+                        4);
+                    CHECK_EQ(sink->queue_size(), 1U);
+                    CHECK_EQ(sink->dropped_count(), 0U);
+                }
+            }
+        }
+
+        GIVEN("message type without level")
+        {
+            logency::sink_option option;
+            option.capacity = capacity;
+            option.overflow = logency::overflow_policy::drop_by_level;
+
+            WHEN("instantiate it to drop by level")
+            {
+                auto act{[&]
+                         {
+                             std::ignore = std::make_shared<sink_type>(
+                                 "not used", std::make_unique<sink_module>(),
+                                 option, std::shared_ptr<pool_type>{});
+                         }};
+
+                THEN("throw logency::runtime_error")
+                {
+                    CHECK_THROWS_WITH_AS(
+                        act(), "Message type has no level to drop by.",
+                        logency::runtime_error);
+                }
+            }
+        }
+    }
+
     SCENARIO("sink::~sink()")
     {
         GIVEN("instantiated object")
@@ -274,8 +401,7 @@ TEST_SUITE("logency::sink")
                 THEN("filter a qualified message will pass")
                 {
                     auto pack{make_message_pack<message_type>(
-                        std::make_shared<string_type>("not used"),
-                        message_type{"qualify"})};
+                        0U, "not used", message_type{"qualify"})};
 
                     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
                     sink->log(&pack, &pack + 1);
@@ -292,8 +418,7 @@ TEST_SUITE("logency::sink")
                 THEN("filter a disqualified message will filtered out")
                 {
                     auto pack{make_message_pack<message_type>(
-                        std::make_shared<string_type>("not used"),
-                        message_type{"disqualify"})};
+                        0U, "not used", message_type{"disqualify"})};
 
                     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
                     sink->log(&pack, &pack + 1);
@@ -327,8 +452,7 @@ TEST_SUITE("logency::sink")
                 THEN("flush a qualified message will trigger flush")
                 {
                     auto pack{make_message_pack<message_type>(
-                        std::make_shared<string_type>("not used"),
-                        message_type{"qualify"})};
+                        0U, "not used", message_type{"qualify"})};
 
                     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
                     sink->log(&pack, &pack + 1);
@@ -342,11 +466,33 @@ TEST_SUITE("logency::sink")
                         1);
                 }
 
+                THEN("messages are passed in batches split by the flush")
+                {
+                    std::vector<message_pack_type> packs;
+
+                    for (const auto *content : {"first", "qualify", "last"})
+                    {
+                        packs.push_back(make_message_pack<message_type>(
+                            0U, "not used", message_type{content}));
+                    }
+
+                    sink->log(packs.begin(), packs.end());
+
+                    global_resource::thread_pool::normal()
+                        ->wait_until_queue_empty();
+
+                    const auto &module{
+                        dynamic_cast<const sink_module &>(sink->sink_module())};
+
+                    CHECK_EQ(module.log_counter(), 3);
+                    CHECK_EQ(module.flush_counter(), 1);
+                    CHECK_EQ(module.batch_counter(), 2);
+                }
+
                 THEN("flush a disqualified message will not trigger flush")
                 {
                     auto pack{make_message_pack<message_type>(
-                        std::make_shared<string_type>("not used"),
-                        message_type{"disqualify"})};
+                        0U, "not used", message_type{"disqualify"})};
 
                     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
                     sink->log(&pack, &pack + 1);
@@ -373,8 +519,7 @@ TEST_SUITE("logency::sink")
             WHEN("log message")
             {
                 auto pack{make_message_pack<message_type>(
-                    std::make_shared<string_type>("not used"),
-                    message_type{"not used"})};
+                    0U, "not used", message_type{"not used"})};
 
                 CHECK_NOTHROW({
                     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -404,8 +549,7 @@ TEST_SUITE("logency::sink")
             WHEN("log message")
             {
                 auto pack{make_message_pack<message_type>(
-                    std::make_shared<string_type>("not used"),
-                    message_type{"not used"})};
+                    0U, "not used", message_type{"not used"})};
 
                 auto act{[&]()
                          {
@@ -421,6 +565,49 @@ TEST_SUITE("logency::sink")
                 }
             }
         }
+
+        GIVEN("instantiated object whose module fails on a message")
+        {
+            using pool_type = logency::detail::thread::thread_pool;
+
+            int errors{0};
+            auto pool{std::make_shared<pool_type>(1U)};
+            pool->set_error_handler([&errors](const std::exception &)
+                                    { ++errors; });
+
+            auto sink{std::make_shared<sink_type>(
+                "not used", std::make_unique<failing_module<message_type>>(),
+                pool)};
+
+            WHEN("log a batch with the failing message in the middle")
+            {
+                constexpr const int count{10};
+                constexpr const int failing{3};
+
+                std::vector<message_pack_type> packs;
+                for (int index{0}; index < count; ++index)
+                {
+                    packs.push_back(make_message_pack<message_type>(
+                        0U, "not used",
+                        message_type{index == failing ? "bad" : "good"}));
+                }
+
+                sink->log(packs.begin(), packs.end());
+                pool->wait_until_queue_empty();
+
+                THEN("only the failing message is discarded")
+                {
+                    CHECK_EQ(errors, 1);
+                    CHECK_EQ(
+                        dynamic_cast<const sink_module &>(sink->sink_module())
+                            .log_counter(),
+                        count - 1);
+                    CHECK_EQ(sink->stats().written,
+                             static_cast<std::uint64_t>(count - 1));
+                    CHECK_EQ(sink->stats().error_count, 1U);
+                }
+            }
+        }
     }
 
     SCENARIO(
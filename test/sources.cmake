@@ -13,10 +13,17 @@ set(${PROJECT_NAME}_UNIT_TEST_BASIC_HEADER
 
 set(${PROJECT_NAME}_UNIT_TEST_BASIC_SOURCE
     ${${PROJECT_NAME}_TEST_DIR}/core/exception_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/latency_histogram_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/memory/block_pool_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/string/name_registry_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/string/string_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/thread/blocking_pair_queue_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/thread/blocking_queue_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/thread/ring_pair_queue_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/thread/snapshot_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/thread/staging_pair_queue_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/thread/thread_pool_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/thread/thread_unit_token_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/dispatcher_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/global_resource/dispatcher.cpp
     ${${PROJECT_NAME}_TEST_DIR}/global_resource/logger.cpp
@@ -24,10 +31,15 @@ set(${PROJECT_NAME}_UNIT_TEST_BASIC_SOURCE
     ${${PROJECT_NAME}_TEST_DIR}/logger_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/manager_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/main_basic.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/message/time_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/sink_module/ostream_module_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/sink_test.cpp
 )
 
+set(${PROJECT_NAME}_UNIT_TEST_FMT_SOURCE
+    ${${PROJECT_NAME}_TEST_DIR}/message/deferred_fmt_message_test.cpp
+)
+
 set(${PROJECT_NAME}_UNIT_TEST_FILE_HEADER
     ${${PROJECT_NAME}_TEST_DIR}/file_directory.hpp
     ${${PROJECT_NAME}_TEST_DIR}/include_doctest.hpp
@@ -39,11 +51,16 @@ set(${PROJECT_NAME}_UNIT_TEST_FILE_HEADER
 )
 
 set(${PROJECT_NAME}_UNIT_TEST_FILE_SOURCE
+    ${${PROJECT_NAME}_TEST_DIR}/detail/file/background_compressor_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/file/basic_file_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/detail/file/file_helper_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/file/mmap_file_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/file/posix_file_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/detail/file/uring_file_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/file_directory.cpp
     ${${PROJECT_NAME}_TEST_DIR}/main_file.cpp
     ${${PROJECT_NAME}_TEST_DIR}/sink_module/basic_file_module_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/sink_module/rotation_file_module_test.cpp
+    ${${PROJECT_NAME}_TEST_DIR}/sink_module/time_rotation_file_module_test.cpp
     ${${PROJECT_NAME}_TEST_DIR}/utils/file_fixture.cpp
 )
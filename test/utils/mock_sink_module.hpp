@@ -13,6 +13,7 @@ class mock_sink_module
 {
 public:
     using message_type = MessageType;
+    using message_pack_type = logency::message_pack<message_type>;
     using string_view_type = typename message_type::string_view_type;
 
     explicit mock_sink_module() noexcept = default;
@@ -35,13 +36,22 @@ public:
     {
         ++log_counter_;
     }
+    void log_messages(const message_pack_type *first,
+                      const message_pack_type *last) override
+    {
+        ++batch_counter_;
+        logency::sink_module::module_interface<MessageType>::log_messages(
+            first, last);
+    }
 
     [[nodiscard]] int flush_counter() const noexcept { return flush_counter_; }
     [[nodiscard]] int log_counter() const noexcept { return log_counter_; }
+    [[nodiscard]] int batch_counter() const noexcept { return batch_counter_; }
 
 private:
     int flush_counter_{0};
     int log_counter_{0};
+    int batch_counter_{0};
 };
 
 } // namespace logency::unit_test::utils
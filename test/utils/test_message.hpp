@@ -52,6 +52,27 @@ public:
     }
 };
 
+/**
+ * Formatter which only appends into the buffer.
+ */
+template <typename CharT>
+class buffer_formatter
+{
+public:
+    using value_type = CharT;
+    using string_type = std::basic_string<value_type>;
+    using string_view_type = std::basic_string_view<value_type>;
+    using buffer_type = string_type;
+
+    using message_type = message<value_type>;
+
+    void format_to(buffer_type &buffer, string_view_type /* logger */,
+                   const message_type &message) const
+    {
+        buffer.append(message.content);
+    }
+};
+
 template <typename value_type>
 auto not_used() -> std::basic_string<value_type>
 {